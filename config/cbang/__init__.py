@@ -81,6 +81,12 @@ def configure_deps(conf, local = True, with_openssl = True,
     # EPoll support
     if conf.CBCheckFunc('epoll_create1'): env.CBConfigDef('HAVE_EPOLL')
 
+    # io_uring support, used via raw syscalls
+    if conf.CBCheckCHeader('linux/io_uring.h'): env.CBConfigDef('HAVE_IO_URING')
+
+    # inotify file change notification
+    if conf.CBCheckCHeader('sys/inotify.h'): env.CBConfigDef('HAVE_INOTIFY')
+
     if with_openssl: conf.CBConfig('openssl', False, version = '1.1.0')
     conf.CBConfig('v8', False)
 
@@ -40,10 +40,13 @@ import time
 import textwrap
 import stat
 import shutil
+import struct
+import gzip
+import mimetypes
 
 from SCons.Script import *
 
-resource_version = 2
+resource_version = 3
 
 
 class ResourceContext:
@@ -87,6 +90,37 @@ def write_string(ctx, output, s, newline = 0):
   output.write(s)
 
 
+def compute_etag(data):
+  # 64-bit FNV-1a, matches cb::ResourceBundle::computeETag()
+  h = 0xcbf29ce484222325
+  for c in bytearray(data):
+    h = ((h ^ c) * 0x100000001b3) & 0xffffffffffffffff
+  return '"%016x"' % h
+
+
+# Python's built-in table, unlike mimetypes.guess_type(), does not depend on
+# the host's mime.types files.  Those are only consulted as a fallback.
+builtin_types = mimetypes.MimeTypes()
+
+
+def guess_type(path):
+  type = builtin_types.guess_type(path)[0] or mimetypes.guess_type(path)[0]
+  if type is not None and type.startswith('text/'): type += '; charset=UTF-8'
+  return type
+
+
+def compress(data):
+  # Only keep variants which save at least 10%
+  gz = gzip.compress(data, 9, mtime = 0)
+  if len(gz) < len(data) * 0.9: return gz
+
+
+def write_array(ctx, out, prototype, data):
+  write_string(ctx, out, prototype + ' = {')
+  for c in bytearray(data): write_string(ctx, out, '%d,' % c)
+  write_string(ctx, out, '0};\n')
+
+
 def is_excluded(exclude, path):
   return exclude != None and exclude.search(path) != None
 
@@ -105,7 +139,7 @@ def write_resource(ctx, output, data_dir, path, children = None,
     typeStr = 'Directory'
     child_resources = []
 
-    for filename in os.listdir(path):
+    for filename in sorted(os.listdir(path)):
       write_resource(ctx, output, data_dir, os.path.join(path, filename),
                      child_resources, exclude)
 
@@ -121,29 +155,21 @@ def write_resource(ctx, output, data_dir, path, children = None,
     print('Writing resource: %s to %s' % (path, out_path))
 
     typeStr = 'File'
-    with open(path, 'rb') as f:
-      prototype = 'extern const unsigned char data%d[]' % id
-
-      write_string(ctx, output, '%s;\n' % prototype)
-
-      with open(out_path, 'w') as out:
-        start_file(ctx, out)
-
-        write_string(ctx, out, prototype + ' = {')
+    with open(path, 'rb') as f: data = f.read()
 
-        while True:
-          count = 0
-          for c in f.read(102400):
-            if not isinstance(c, int): c = ord(c)
-            write_string(ctx, out, '%d,' % c)
-            count += 1
+    length = len(data)
+    gz = compress(data) if ctx.gzip else None
+    prototype = 'extern const unsigned char data%d[]' % id
+    gzPrototype = 'extern const unsigned char gzdata%d[]' % id
 
-          if count == 0: break
-          length += count
+    write_string(ctx, output, '%s;\n' % prototype)
+    if gz is not None: write_string(ctx, output, '%s;\n' % gzPrototype)
 
-        write_string(ctx, out, '0};\n')
-
-        end_file(ctx, out)
+    with open(out_path, 'w') as out:
+      start_file(ctx, out)
+      write_array(ctx, out, prototype, data)
+      if gz is not None: write_array(ctx, out, gzPrototype, gz)
+      end_file(ctx, out)
 
   if children != None: children.append(id)
 
@@ -151,7 +177,14 @@ def write_resource(ctx, output, data_dir, path, children = None,
                (typeStr, id, name))
 
   if is_dir: output.write('children%d' % id)
-  else: output.write('(const char *)data%d, %d' % (id, length))
+  else:
+    type = guess_type(path)
+    output.write('(const char *)data%d, %d, %s, %s' % (
+      id, length, '"%s"' % type if type else '0',
+      '"%s"' % compute_etag(data).replace('"', '\\"')))
+
+    if gz is not None:
+      output.write(', (const char *)gzdata%d, %d' % (id, len(gz)))
 
   output.write(');\n')
 
@@ -171,6 +204,7 @@ def resources_build(target, source, env):
   ctx.env = env
   ctx.ns = env.get('RESOURCES_NS')
   ctx.exclude = get_exclude(env)
+  ctx.gzip = env.get('RESOURCES_GZIP')
   ctx.next_id = 0
   ctx.col = 0
 
@@ -195,6 +229,53 @@ def resources_build(target, source, env):
     end_file(ctx, f)
 
 
+def write_field(f, data):
+  if not isinstance(data, bytes): data = data.encode('utf-8')
+  f.write(struct.pack('<I', len(data)))
+  f.write(data)
+  f.write(b'\0')
+
+
+def collect_files(exclude, path, prefix, files):
+  if is_excluded(exclude, path): return
+
+  if os.path.isdir(path):
+    for name in sorted(os.listdir(path)):
+      child = prefix + '/' + name if prefix else name
+      collect_files(exclude, os.path.join(path, name), child, files)
+
+  else: files.append((prefix, path))
+
+
+def resource_bundle_build(target, source, env):
+  exclude = get_exclude(env)
+  files = []
+
+  for src in source:
+    src = str(src)
+    if os.path.isdir(src): collect_files(exclude, src, '', files)
+    else: collect_files(exclude, src, os.path.basename(src), files)
+
+  files.sort()
+  target = str(target[0])
+  print('Writing resource bundle: %s' % target)
+
+  # See cbang/util/ResourceBundle.h for the format
+  with open(target, 'wb') as f:
+    f.write(b'CBRB')
+    f.write(struct.pack('<II', 1, len(files)))
+
+    for name, path in files:
+      with open(path, 'rb') as src: data = src.read()
+      gz = compress(data) if env.get('RESOURCES_GZIP') else None
+
+      write_field(f, name)
+      write_field(f, guess_type(path) or '')
+      write_field(f, compute_etag(data))
+      write_field(f, data)
+      write_field(f, gz or b'')
+
+
 def get_targets(exclude, path, data_dir, count = [0]):
   if is_excluded(exclude, path): return []
 
@@ -230,11 +311,17 @@ def modify_targets(target, source, env):
 def generate(env):
   env.SetDefault(RESOURCES_NS = '')
   env.SetDefault(RESOURCES_EXCLUDES = [r'\.svn', r'~$'])
+  env.SetDefault(RESOURCES_GZIP = True)
 
   bld = env.Builder(action = resources_build,
                     source_factory = SCons.Node.FS.Entry,
                     emitter = modify_targets)
   env.Append(BUILDERS = {'Resources' : bld})
 
+  bld = env.Builder(action = resource_bundle_build,
+                    source_factory = SCons.Node.FS.Entry,
+                    source_scanner = SCons.Scanner.Dir.DirScanner())
+  env.Append(BUILDERS = {'ResourceBundle' : bld})
+
 
 def exists(): return True
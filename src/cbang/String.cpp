@@ -46,6 +46,8 @@
 #include <cctype>
 #include <cstdarg>
 #include <cmath>
+#include <cfloat>
+#include <cstring>
 
 using namespace std;
 using namespace cb;
@@ -85,23 +87,312 @@ namespace {
   }
 
 
-  string toString(double x, int precision = 6) {
+  const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233"
+    "34353637383940414243444546474849505152535455565758596061626364656667"
+    "6869707172737475767778798081828384858687888990919293949596979899";
+
+
+  char *formatU64(char *buf, uint64_t x) {
+    char tmp[20];
+    char *p = tmp + 20;
+
+    // Two digits at a time
+    while (100 <= x) {
+      const char *pair = digitPairs + (x % 100) * 2;
+      x /= 100;
+      *--p = pair[1];
+      *--p = pair[0];
+    }
+
+    if (x < 10) *--p = '0' + x;
+    else {
+      *--p = digitPairs[x * 2 + 1];
+      *--p = digitPairs[x * 2];
+    }
+
+    unsigned length = tmp + 20 - p;
+    memcpy(buf, p, length);
+    return buf + length;
+  }
+
+
+  char *formatS64(char *buf, int64_t x) {
+    if (0 <= x) return formatU64(buf, x);
+    *buf++ = '-';
+    return formatU64(buf, 0 - (uint64_t)x);
+  }
+
+
+  char *formatShortest(char *buf, double x) {
+    // The shortest %g precision which parses back to the same value
+    for (int precision = 15; precision < 17; precision++) {
+      int length = snprintf(buf, String::TO_CHARS_SIZE, "%.*g", precision, x);
+      if (strtod(buf, 0) == x) return buf + length;
+    }
+
+    return buf + snprintf(buf, String::TO_CHARS_SIZE, "%.17g", x);
+  }
+
+
+  char *formatDouble(char *buf, double x, int precision) {
+    if (precision < 0) return formatShortest(buf, x);
+
+    // Integral values print without a fraction, avoid printf
+    const double maxExact = 9007199254740992.0; // 2^53
+    if (-maxExact < x && x < maxExact && x == trunc(x))
+      return formatS64(buf, (int64_t)x);
+
     bool big = x < -1e20 || 1e20 < x;
-    string s = String::printf(big ? "%.*e" : "%.*f", precision, x);
+    int length = snprintf(buf, String::TO_CHARS_SIZE + precision,
+                          big ? "%.*e" : "%.*f", precision, x);
+    if (length < 0) THROW("Failed to format double");
 
-    int chop = 0;
+    // Remove trailing zeros from the fraction, if any, but not the exponent
+    char *exp = big ? strchr(buf, 'e') : 0;
+    char *end = exp ? exp : buf + length;
     char point = use_facet<numpunct<char> >(cout.getloc()).decimal_point();
 
-    for (auto it = s.rbegin(); it != s.rend(); it++)
-      if (*it == '0' || *it == point) {
-        chop++;
-        if (*it == point) break;
+    while (precision && buf < end)
+      if (end[-1] == '0') end--;
+      else {
+        if (end[-1] == point) end--;
+        break;
+      }
+
+    if (exp) {
+      unsigned expLen = buf + length - exp;
+      memmove(end, exp, expLen);
+      end += expLen;
+    }
+
+    if (end - buf == 2 && buf[0] == '-' && buf[1] == '0') {
+      buf[0] = '0';
+      end = buf + 1;
+    }
+
+    return end;
+  }
+
+
+  string toString(double x, int precision = 6) {
+    char buf[String::TO_CHARS_SIZE + 32];
+
+    if (precision <= 32)
+      return string(buf, String::toChars(buf, x, precision));
+
+    vector<char> big(String::TO_CHARS_SIZE + precision);
+    return string(big.data(), String::toChars(big.data(), x, precision));
+  }
+
+
+  template <typename T>
+  string toString(T x) {
+    char buf[String::TO_CHARS_SIZE];
+    return string(buf, String::toChars(buf, x));
+  }
+
+
+  inline bool isSpace(char c) {return c == ' ' || ('\t' <= c && c <= '\r');}
+
+
+  inline unsigned digitValue(char c) {
+    if ('0' <= c && c <= '9') return c - '0';
+    if ('a' <= c && c <= 'z') return c - 'a' + 10;
+    if ('A' <= c && c <= 'Z') return c - 'A' + 10;
+    return 36;
+  }
+
+
+  /// Parse eight decimal digits at once, @return false if any is not a digit
+  inline bool parseEightDigits(const char *s, uint64_t &value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+    memcpy(&v, s, 8);
+
+    if (((v & 0xf0f0f0f0f0f0f0f0) |
+         (((v + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) !=
+        0x3333333333333333) return false;
+
+    v = (v & 0x0f0f0f0f0f0f0f0f) * 2561 >> 8;
+    v = (v & 0x00ff00ff00ff00ff) * 6553601 >> 16;
+    value = (uint32_t)((v & 0x0000ffff0000ffff) * 42949672960001 >> 32);
+
+#else
+    uint64_t v = 0;
+
+    for (unsigned i = 0; i < 8; i++) {
+      unsigned d = (unsigned)(s[i] - '0');
+      if (9 < d) return false;
+      v = v * 10 + d;
+    }
+
+    value = v;
+#endif
+
+    return true;
+  }
+
+
+  /***
+   * Parse an integer like strtoull() with base 0, i.e. leading whitespace,
+   * a sign and a 0x or 0 prefix for hex or octal.  If no digits are found
+   * @param stop is set to @param s.  @return false on overflow.
+   */
+  bool parseInteger(const char *s, const char *end, bool &negative,
+                    uint64_t &value, const char *&stop) {
+    const char *ptr = s;
+    while (ptr < end && isSpace(*ptr)) ptr++;
+
+    negative = ptr < end && *ptr == '-';
+    if (ptr < end && (*ptr == '-' || *ptr == '+')) ptr++;
+
+    unsigned base = 10;
+    if (ptr < end && *ptr == '0') {
+      if (ptr + 2 < end && (ptr[1] == 'x' || ptr[1] == 'X') &&
+          digitValue(ptr[2]) < 16) {
+        base = 16;
+        ptr += 2;
+
+      } else base = 8;
+    }
+
+    const char *digits = ptr;
+    const uint64_t max = numeric_limits<uint64_t>::max();
+    uint64_t v = 0;
+
+    if (base == 10)
+      while (8 <= end - ptr) {
+        uint64_t chunk;
+        if (!parseEightDigits(ptr, chunk)) break;
+        if ((max - chunk) / 100000000 < v) return false;
+        v = v * 100000000 + chunk;
+        ptr += 8;
+      }
+
+    const uint64_t limit = max / base;
+    const unsigned lastDigit = max % base;
+
+    for (; ptr < end; ptr++) {
+      unsigned d = digitValue(*ptr);
+      if (base <= d) break;
+      if (limit < v || (v == limit && lastDigit < d)) return false;
+      v = v * base + d;
+    }
+
+    value = v;
+    stop = ptr == digits ? s : ptr;
+
+    return true;
+  }
+
+
+  template <typename T>
+  bool parseSigned(const char *s, const char *end, T &value, bool full) {
+    bool negative;
+    uint64_t v;
+    const char *stop;
+
+    // Note, the minimum value is rejected for symmetry with the maximum
+    if (!parseInteger(s, end, negative, v, stop) ||
+        (uint64_t)numeric_limits<T>::max() < v || (full && stop != end))
+      return false;
+
+    value = negative ? -(T)v : (T)v;
+    return true;
+  }
+
+
+  template <typename T>
+  bool parseUnsigned(const char *s, const char *end, T &value, bool full) {
+    if (s == end || *s == '-') return false;
+
+    bool negative;
+    uint64_t v;
+    const char *stop;
+
+    if (!parseInteger(s, end, negative, v, stop) || negative ||
+        (uint64_t)numeric_limits<T>::max() < v || (full && stop != end))
+      return false;
+
+    value = (T)v;
+    return true;
+  }
+
+
+  /***
+   * Clinger's fast path.  Decimals with a mantissa and power of ten which
+   * are both exactly representable are correctly rounded by a single
+   * multiply or divide.  Everything else, including hex, inf and nan, falls
+   * back to strtod().
+   */
+  template <typename T>
+  bool parseFloatFast(const char *s, const char *end, T &value,
+                      const char *&stop) {
+#if FLT_EVAL_METHOD == 0
+    const int maxExp = numeric_limits<T>::digits == 24 ? 10 : 22;
+    const uint64_t maxMantissa = (uint64_t)1 << numeric_limits<T>::digits;
+    static const T powers[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    const char *ptr = s;
+    while (ptr < end && isSpace(*ptr)) ptr++;
+
+    bool negative = ptr < end && *ptr == '-';
+    if (ptr < end && (*ptr == '-' || *ptr == '+')) ptr++;
+
+    uint64_t mantissa = 0;
+    int exp = 0;
+    unsigned digits = 0;
+
+    for (; ptr < end && '0' <= *ptr && *ptr <= '9'; ptr++, digits++) {
+      if (digits == 19) return false;
+      mantissa = mantissa * 10 + (*ptr - '0');
+    }
+
+    if (ptr < end && *ptr == '.')
+      for (ptr++; ptr < end && '0' <= *ptr && *ptr <= '9'; ptr++, digits++) {
+        if (digits == 19) return false;
+        mantissa = mantissa * 10 + (*ptr - '0');
+        exp--;
+      }
+
+    if (!digits) return false;
+
+    if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+      const char *e = ptr + 1;
+      bool expNeg = e < end && *e == '-';
+      if (e < end && (*e == '-' || *e == '+')) e++;
+
+      if (e == end || *e < '0' || '9' < *e) return false;
+
+      int x = 0;
+      for (; e < end && '0' <= *e && *e <= '9'; e++)
+        if (x < 1000) x = x * 10 + (*e - '0');
+
+      exp += expNeg ? -x : x;
+      ptr = e;
+    }
 
-      } else break;
+    // Let strtod() handle anything unusual following the number
+    if (ptr < end && (isalnum((unsigned char)*ptr) || *ptr == '.'))
+      return false;
+    if (maxMantissa < mantissa || exp < -maxExp || maxExp < exp) return false;
+
+    T v = (T)mantissa;
+    if (exp < 0) v /= powers[-exp];
+    else v *= powers[exp];
 
-    if (chop) s = s.substr(0, s.length() - chop);
+    value = negative ? -v : v;
+    stop = ptr;
 
-    return s == "-0" ? "0" : s;
+    return true;
+
+#else
+    return false;
+#endif
   }
 }
 
@@ -109,17 +400,35 @@ namespace {
 String::String(const char *s, size_type n) : string(toString(s, n)) {}
 String::String(double x, int precision)    : string(toString(x, precision)) {}
 
-String::String(int8_t    x) : string(printf("%i", (int)x))                  {}
-String::String(uint8_t   x) : string(printf("%u", (unsigned)x))             {}
-String::String(int16_t   x) : string(printf("%i", (int)x))                  {}
-String::String(uint16_t  x) : string(printf("%u", (unsigned)x))             {}
-String::String(int32_t   x) : string(printf("%i", x))                       {}
-String::String(uint32_t  x) : string(printf("%u", x))                       {}
-String::String(int64_t   x) : string(printf("%lli", (long long int)x))      {}
-String::String(uint64_t  x) : string(printf("%llu", (long long unsigned)x)) {}
-String::String(double    x) : string(toString(x))                           {}
-String::String(float     x) : string(toString((double)x))                   {}
-String::String(bool      x) : string(x ? "true" : "false")                  {}
+
+#define CBANG_STRING_PT(NAME, TYPE, DESC)               \
+  String::String(TYPE x) : string(toString(x)) {}
+#include "StringParseTypes.def"
+
+
+char *String::toChars(char *buf, int8_t   x) {return formatS64(buf, x);}
+char *String::toChars(char *buf, uint8_t  x) {return formatU64(buf, x);}
+char *String::toChars(char *buf, int16_t  x) {return formatS64(buf, x);}
+char *String::toChars(char *buf, uint16_t x) {return formatU64(buf, x);}
+char *String::toChars(char *buf, int32_t  x) {return formatS64(buf, x);}
+char *String::toChars(char *buf, uint32_t x) {return formatU64(buf, x);}
+char *String::toChars(char *buf, int64_t  x) {return formatS64(buf, x);}
+char *String::toChars(char *buf, uint64_t x) {return formatU64(buf, x);}
+char *String::toChars(char *buf, double   x) {return formatDouble(buf, x, 6);}
+char *String::toChars(char *buf, float    x) {return formatDouble(buf, x, 6);}
+
+
+char *String::toChars(char *buf, bool x) {
+  const char *s = x ? "true" : "false";
+  unsigned length = strlen(s);
+  memcpy(buf, s, length);
+  return buf + length;
+}
+
+
+char *String::toChars(char *buf, double x, int precision) {
+  return formatDouble(buf, x, precision);
+}
 
 
 string String::printf(const char *format, ...) {
@@ -209,128 +518,128 @@ unsigned String::tokenizeLine(istream &stream, vector<string> &tokens,
 
 namespace cb {
   template <>
-  bool String::parse<int64_t>(const string &s, int64_t &value, bool full) {
-    errno = 0;
-    char *end = 0;
-    long long v = strtoll(s.c_str(), &end, 0);
-    if (errno || v < -numeric_limits<int64_t>::max() ||
-        numeric_limits<int64_t>::max() < v || (full && end && *end))
-      return false;
-
-    value = (int64_t)v;
-    return true;
+  bool String::parse<int64_t>(const char *s, const char *end, int64_t &value,
+                              bool full) {
+    return parseSigned(s, end, value, full);
   }
 
 
   template <>
-  bool String::parse<uint64_t>(const string &s, uint64_t &value, bool full) {
-    if (!s.length() || s[0] == '-') return false;
-    errno = 0;
-    char *end = 0;
-    unsigned long long v = strtoull(s.c_str(), &end, 0);
-    if (errno || numeric_limits<uint64_t>::max() < v || (full && end && *end))
-      return false;
-    value = (uint64_t)v;
-    return true;
+  bool String::parse<uint64_t>(const char *s, const char *end,
+                               uint64_t &value, bool full) {
+    return parseUnsigned(s, end, value, full);
   }
 
 
   template <>
-  bool String::parse<int32_t>(const string &s, int32_t &value, bool full) {
-    errno = 0;
-    char *end = 0;
-    long v = strtol(s.c_str(), &end, 0);
-    if (errno || v < -numeric_limits<int32_t>::max() ||
-        numeric_limits<int32_t>::max() < v || (full && end && *end))
-      return false;
-
-    value = (int32_t)v;
-    return true;
+  bool String::parse<int32_t>(const char *s, const char *end, int32_t &value,
+                              bool full) {
+    return parseSigned(s, end, value, full);
   }
 
 
   template <>
-  bool String::parse<uint32_t>(const string &s, uint32_t &value, bool full) {
-    if (!s.length() || s[0] == '-') return false;
-    errno = 0;
-    char *end = 0;
-    unsigned long v = strtoul(s.c_str(), &end, 0);
-    if (errno || numeric_limits<uint32_t>::max() < v || (full && end && *end))
-      return false;
-    value = (uint32_t)v;
-    return true;
+  bool String::parse<uint32_t>(const char *s, const char *end,
+                               uint32_t &value, bool full) {
+    return parseUnsigned(s, end, value, full);
   }
 
 
   template <>
-  bool String::parse<int16_t>(const string &s, int16_t &value, bool full) {
+  bool String::parse<int16_t>(const char *s, const char *end, int16_t &value,
+                              bool full) {
     int32_t v;
-    if (!parse<int32_t>(s, v, full) || v < -32767 || 32767 < v) return false;
+    if (!parse<int32_t>(s, end, v, full) || v < -32767 || 32767 < v)
+      return false;
     value = (int16_t)v;
     return true;
   }
 
 
   template <>
-  bool String::parse<uint16_t>(const string &s, uint16_t &value, bool full) {
+  bool String::parse<uint16_t>(const char *s, const char *end,
+                               uint16_t &value, bool full) {
     uint32_t v;
-    if (!parse<uint32_t>(s, v, full) || 65535 < v) return false;
+    if (!parse<uint32_t>(s, end, v, full) || 65535 < v) return false;
     value = (uint16_t)v;
     return true;
   }
 
 
   template <>
-  bool String::parse<int8_t>(const string &s, int8_t &value, bool full) {
+  bool String::parse<int8_t>(const char *s, const char *end, int8_t &value,
+                             bool full) {
     int32_t v;
-    if (!parse<int32_t>(s, v, full) || v < -127 || 127 < v) return false;
+    if (!parse<int32_t>(s, end, v, full) || v < -127 || 127 < v) return false;
     value = (int8_t)v;
     return true;
   }
 
 
   template <>
-  bool String::parse<uint8_t>(const string &s, uint8_t &value, bool full) {
+  bool String::parse<uint8_t>(const char *s, const char *end, uint8_t &value,
+                              bool full) {
     uint32_t v;
-    if (!parse<uint32_t>(s, v, full) || 255 < v) return false;
+    if (!parse<uint32_t>(s, end, v, full) || 255 < v) return false;
     value = (uint8_t)v;
     return true;
   }
 
 
   template <>
-  bool String::parse<double>(const string &s, double &value, bool full) {
+  bool String::parse<double>(const char *s, const char *end, double &value,
+                             bool full) {
+    const char *stop;
+    if (parseFloatFast(s, end, value, stop)) return !full || stop == end;
+
+    string str(s, end);
     errno = 0;
-    char *end = 0;
-    double v = strtod(s.c_str(), &end);
-    if (errno || (full && end && *end)) return false;
+    char *e = 0;
+    double v = strtod(str.c_str(), &e);
+    if (errno || (full && e && *e)) return false;
     value = v;
     return true;
   }
 
 
   template <>
-  bool String::parse<float>(const string &s, float &value, bool full) {
+  bool String::parse<float>(const char *s, const char *end, float &value,
+                            bool full) {
+    const char *stop;
+    if (parseFloatFast(s, end, value, stop)) return !full || stop == end;
+
+    string str(s, end);
     errno = 0;
-    char *end = 0;
-    float v = strtof(s.c_str(), &end);
-    if (errno || (full && end && *end)) return false;
+    char *e = 0;
+    float v = strtof(str.c_str(), &e);
+    if (errno || (full && e && *e)) return false;
     value = v;
     return true;
   }
 
 
   template <>
-  bool String::parse<bool>(const string &s, bool &value, bool full) {
-    string v = toLower(trim(s));
+  bool String::parse<bool>(const char *s, const char *end, bool &value,
+                           bool full) {
+    while (s < end && DEFAULT_DELIMS.find(*s) != string::npos) s++;
+    while (s < end && DEFAULT_DELIMS.find(end[-1]) != string::npos) end--;
+
+    auto is = [s, end] (const char *word) {
+      unsigned length = strlen(word);
+      if ((unsigned)(end - s) != length) return false;
 
-    if (v == "true" || v == "t" || v == "1" || v == "yes" || v == "y") {
+      for (unsigned i = 0; i < length; i++)
+        if (tolower((unsigned char)s[i]) != word[i]) return false;
+
+      return true;
+    };
+
+    if (is("true") || is("t") || is("1") || is("yes") || is("y")) {
       value = true;
       return true;
     }
 
-
-    if (v == "false" || v == "f" || v == "0" || v == "no" || v == "n") {
+    if (is("false") || is("f") || is("0") || is("no") || is("n")) {
       value = false;
       return true;
     }
@@ -339,6 +648,14 @@ namespace cb {
   }
 
 
+#define CBANG_STRING_PT(NAME, TYPE, DESC)                               \
+  template <>                                                           \
+  bool String::parse<TYPE>(const string &s, TYPE &value, bool full) {   \
+    return parse<TYPE>(s.data(), s.data() + s.length(), value, full);   \
+  }
+#include "StringParseTypes.def"
+
+
 #define CBANG_STRING_PT(NAME, TYPE, DESC)                               \
   template <>                                                           \
   TYPE String::parse<TYPE>(const string &s, bool full) {                \
@@ -407,7 +724,7 @@ string String::toUpper(const string &s) {
   string v(len, ' ');
 
   for (string::size_type i = 0; i < len; i++)
-    v[i] = toupper(s[i]);
+    v[i] = toupper((unsigned char)s[i]);
 
   return v;
 }
@@ -418,7 +735,7 @@ string String::toLower(const string &s) {
   string v(len, ' ');
 
   for (string::size_type i = 0; i < len; i++)
-    v[i] = tolower(s[i]);
+    v[i] = tolower((unsigned char)s[i]);
 
   return v;
 }
@@ -430,9 +747,10 @@ string String::capitalize(const string &s) {
 
   bool whitespace = true;
   for (string::size_type i = 0; i < len; i++) {
-    if (whitespace && isalpha(s[i])) v[i] = toupper(s[i]);
-    else v[i] = s[i];
-    whitespace = isspace(s[i]);
+    unsigned char c = s[i];
+    if (whitespace && isalpha(c)) v[i] = toupper(c);
+    else v[i] = c;
+    whitespace = isspace(c);
   }
 
   return v;
@@ -448,7 +766,7 @@ ostream &String::fill(ostream &stream, const string &str,
 
   while (*s) {
     // Skip white space
-    while (*s && *s != '\t' && isspace(*s)) {
+    while (*s && *s != '\t' && isspace((unsigned char)*s)) {
       if (*s == '\n') {
         stream << '\n';
         pos = 0;
@@ -468,7 +786,7 @@ ostream &String::fill(ostream &stream, const string &str,
     // Get word length
     unsigned len = 1;
     unsigned printLen = 1;
-    while (s[len] && (s[len] == '\t' || !isspace(s[len]))) {
+    while (s[len] && (s[len] == '\t' || !isspace((unsigned char)s[len]))) {
       if (s[len] == '\t') printLen++;
       printLen++;
       len++;
@@ -73,11 +73,24 @@ namespace cb {
     String(size_type n, char c) : std::string(n, c) {}
 
     // Conversion constructors
+    /// A negative @param precision selects the shortest round-trip format
     explicit String(double x, int precision);
 
 #define CBANG_STRING_PT(NAME, TYPE, DESC) explicit String(TYPE x);
 #include "StringParseTypes.def"
 
+    // Non-allocating conversions
+    /// Buffer size sufficient for toChars() with the default precision
+    static const unsigned TO_CHARS_SIZE = 32;
+
+    /// Write the same text as String(x) to @param buf, @return the end
+#define CBANG_STRING_PT(NAME, TYPE, DESC)               \
+    static char *toChars(char *buf, TYPE x);
+#include "StringParseTypes.def"
+
+    /// @param buf must hold at least TO_CHARS_SIZE + @param precision chars
+    static char *toChars(char *buf, double x, int precision);
+
     // Formatting
     [[gnu::format(printf, 1, 2)]]
     static std::string printf(const char *format, ...);
@@ -100,6 +113,8 @@ namespace cb {
     // Parsing
     template <typename T> static bool parse(const std::string &s, T &value,
                                             bool full);
+    template <typename T> static bool parse(const char *s, const char *end,
+                                            T &value, bool full);
 
 #define CBANG_STRING_PT(NAME, TYPE, DESC)                               \
     static TYPE parse##NAME(const std::string &s, TYPE &value, bool full);
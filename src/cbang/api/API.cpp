@@ -55,6 +55,8 @@
 #include <cbang/api/handler/WebsocketHandler.h>
 #include <cbang/api/handler/HTTPHandler.h>
 #include <cbang/api/handler/FunctionHandler.h>
+#include <cbang/api/handler/CacheHandler.h>
+#include <cbang/api/handler/InvalidateHandler.h>
 #include <cbang/api/arg/ArgDict.h>
 
 #include <cbang/http/Request.h>
@@ -102,6 +104,18 @@ void cb::API::API::load(const JSON::ValuePtr &config) {
   // missing refs, including {~refs}, stay literal for request-time resolution.
   Resolver(*this).resolve(*config, true);
 
+  if (config->has("cache-size"))
+    responseCache.setMaxSize(config->getU64("cache-size"));
+
+  // Fair share weights of exec process groups
+  if (config->hasDict("exec-weights")) {
+    if (procPool.isNull())
+      THROW("API cannot have 'exec-weights' without Event::SubprocessPool");
+
+    for (auto e: config->getDict("exec-weights").entries())
+      procPool->setGroupWeight(e.key(), e.value()->getNumber());
+  }
+
   // Check JmpAPI version
   const Version minVer("1.2.0");
   Version version(config->getString("jmpapi", "0.0.0"));
@@ -483,7 +497,27 @@ cb::API::HandlerPtr cb::API::API::createMethodsHandler(
 
   addToSpec(methods, cfg);
 
-  return cfg->addValidation(createStatementHandler(cfg));
+  auto handler = createStatementHandler(cfg);
+  handler = wrapCache(methods + " " + cfg->getPattern(), handler, cfg);
+
+  return cfg->addValidation(handler);
+}
+
+
+cb::API::HandlerPtr cb::API::API::wrapCache(
+  const string &id, const HandlerPtr &handler, const CfgPtr &cfg) {
+  auto config = cfg->getConfig();
+  if (!config->isDict()) return handler;
+
+  HandlerPtr wrapped = handler;
+
+  if (config->has("invalidate"))
+    wrapped = new InvalidateHandler(*this, config->get("invalidate"), wrapped);
+
+  if (config->has("cache"))
+    wrapped = new CacheHandler(*this, id, config->get("cache"), wrapped);
+
+  return wrapped;
 }
 
 
@@ -35,6 +35,7 @@
 #include "Config.h"
 #include "HandlerGroup.h"
 #include "HandlerFactory.h"
+#include "ResponseCache.h"
 
 #include <cbang/api/handler/FunctionHandler.h>
 
@@ -79,6 +80,7 @@ namespace cb {
       SmartPointer<Event::SubprocessPool> procPool;
       SmartPointer<EventLevelDB>          timeseriesDB;
       JSON::ValuePtr                      optionValues;
+      ResponseCache                       responseCache;
 
       std::map<std::string, HandlerPtr>     callbacks;
       std::map<std::string, JSON::ValuePtr> args;
@@ -112,6 +114,7 @@ namespace cb {
       MariaDB::Connector    &getDBConnector()     {return *connector;}
       Event::SubprocessPool &getProcPool()        {return *procPool;}
       EventLevelDB          &getTimeseriesDB()    {return *timeseriesDB;}
+      ResponseCache         &getResponseCache()   {return responseCache;}
 
       void load(const JSON::ValuePtr &config);
 
@@ -157,6 +160,8 @@ namespace cb {
       virtual HandlerPtr wrapEndpoint(
         const HandlerPtr &handler, const CfgPtr &cfg);
       virtual HandlerPtr createStatementHandler(const CfgPtr &cfg);
+      virtual HandlerPtr wrapCache(const std::string &id,
+        const HandlerPtr &handler, const CfgPtr &cfg);
       virtual HandlerPtr createMethodsHandler(
         const std::string &methods, const CfgPtr &cfg);
       virtual HandlerPtr createAPIHandler(const CfgPtr &cfg);
@@ -69,7 +69,7 @@ void Login::loginComplete() {
   if (def.sql.empty()) cb(HTTP_OK, 0);
   else {
     vector<JSON::ValuePtr> params;
-    string s = resolver->resolveSQL(def.getSQL(), params);
+    string s = resolver->resolveSQL(def.getSQLTemplate(), params);
     exec(s, params);
   }
 }
@@ -34,6 +34,11 @@
 #include "QueryDef.h"
 #include "Blob.h"
 
+#include <cbang/json/InternFactory.h>
+#include <cbang/http/Request.h>
+#include <cbang/http/Conn.h>
+#include <cbang/event/BufferStream.h>
+#include <cbang/event/Event.h>
 #include <cbang/log/Logger.h>
 
 #include <mysql/mysqld_error.h>
@@ -43,17 +48,61 @@ using namespace cb;
 using namespace cb::API;
 
 
+namespace {
+  // Streaming flow control, in bytes
+  const unsigned chunkSize     = 64 * 1024;
+  const unsigned highWatermark = 1024 * 1024;
+  const unsigned lowWatermark  = 256 * 1024;
+
+
+  void writeCSV(ostream &stream, const string &s) {
+    if (s.find_first_of(",\"\r\n") == string::npos) {stream << s; return;}
+
+    stream << '"';
+    for (char c: s) {
+      if (c == '"') stream << '"';
+      stream << c;
+    }
+    stream << '"';
+  }
+}
+
+
 Query::Query(const QueryDef &def, callback_t cb) :
-  def(def), cb(cb), db(def.getDBConnection()) {
+  def(def), cb(cb), sink(0, &JSON::InternFactory::instance()) {
   if (!cb) THROW("Callback not set");
 }
 
 
+Query::~Query() {releaseDB(false);}
+
+
 void Query::exec(const string &sql, const vector<JSON::ValuePtr> &params) {
+  if (isStreaming(def.ret) && req.isNull())
+    THROW("Query return type '" << def.ret << "' requires an HTTP request");
+
   // Stay alive until DB callbacks are complete
   auto self = SmartPtr(this);
-  auto cb = [self] (state_t state) {self->callback(state);};
-  db->query(cb, sql, params);
+
+  def.getDBConnection(
+    [self, sql, params] (const SmartPointer<MariaDB::EventDB> &db) {
+      if (db.isNull())
+        return self->errorReply(HTTP_SERVICE_UNAVAILABLE,
+                                "Database connection failed");
+
+      self->db = db;
+
+      try {
+        // Streamed rows are fetched as they are sent rather than buffered
+        db->query([self] (state_t state) {self->dbCallback(state);}, sql,
+                  params, self->req.isSet());
+
+      } catch (const Exception &e) {
+        LOG_DEBUG(3, e);
+        self->releaseDB(false);
+        self->errorReply(HTTP_INTERNAL_SERVER_ERROR, e.getMessage());
+      }
+    });
 }
 
 
@@ -69,11 +118,36 @@ Query::return_t Query::getReturnType(const string &name) {
   if (name == "bool")   return &Query::returnBool;
   if (name == "u64")    return &Query::returnU64;
   if (name == "s64")    return &Query::returnS64;
+  if (name == "stream") return &Query::returnStream;
+  if (name == "ndjson") return &Query::returnNDJSON;
+  if (name == "csv")    return &Query::returnCSV;
 
   THROW("Unsupported query return type '" << name << "'");
 }
 
 
+bool Query::isStreaming(const string &name) {
+  return name == "stream" || name == "ndjson" || name == "csv";
+}
+
+
+void Query::dbCallback(state_t state) {
+  if (state == MariaDB::EventDB::EVENTDB_ERROR) dbFailed = true;
+
+  callback(state);
+
+  // Return the connection as soon as the query completes
+  if (state == MariaDB::EventDB::EVENTDB_DONE) releaseDB(!dbFailed);
+}
+
+
+void Query::releaseDB(bool reuse) {
+  if (db.isNull()) return;
+  def.releaseDBConnection(db, reuse);
+  db.release();
+}
+
+
 void Query::callback(state_t state) {
   auto retCB = getReturnType(def.ret);
   (*this.*retCB)(state);
@@ -98,6 +172,133 @@ void Query::errorReply(HTTP::Status code, const string &msg) {
 }
 
 
+ostream &Query::getStream() {
+  if (streamOut.isNull()) streamOut = new Event::BufferStream<>(streamBuf);
+  return *streamOut;
+}
+
+
+JSON::Writer &Query::getWriter() {
+  if (writer.isNull()) writer = new JSON::Writer(getStream(), 0, true);
+  return *writer;
+}
+
+
+void Query::flushStream(bool final) {
+  if (streamAborted) return;
+  if (streamOut.isSet()) streamOut->flush();
+
+  unsigned length = streamBuf.getLength();
+  if (!final && length < chunkSize) return;
+
+  if (!streamStarted) {
+    if (contentType.empty())
+      contentType = def.ret == "csv" ? "text/csv" :
+        (def.ret == "ndjson" ? "application/x-ndjson" : "application/json");
+
+    req->setContentType(contentType);
+    req->startChunked();
+    streamStarted = true;
+  }
+
+  if (length) {
+    inFlight += length;
+    auto self = SmartPtr(this);
+    req->sendChunk(streamBuf, [self, length] (bool success) {
+      self->streamSent(length, success);
+    });
+    if (streamAborted) return;
+  }
+
+  if (final) req->endChunked();
+
+  // Stop fetching rows until the client catches up
+  else if (highWatermark <= inFlight && !streamPaused && db.isSet()) {
+    LOG_DEBUG(4, "Pausing SQL stream with " << inFlight << " bytes pending");
+    streamPaused = true;
+    db->pauseFetch();
+
+    // A client that stops reading must not hold the DB connection forever
+    if (stallTimeout && req->hasConnection()) {
+      if (stallEvent.isNull())
+        stallEvent = req->getConnection()->getBase().newEvent(
+          [this] {streamStalled();}, 0);
+      stallEvent->add(stallTimeout);
+    }
+  }
+}
+
+
+void Query::streamSent(unsigned length, bool success) {
+  inFlight -= length;
+
+  if (!success) abortStream();
+
+  else if (streamPaused && inFlight <= lowWatermark) {
+    LOG_DEBUG(4, "Resuming SQL stream");
+    streamPaused = false;
+    if (stallEvent.isSet()) stallEvent->del();
+    if (db.isSet()) db->resumeFetch();
+  }
+}
+
+
+void Query::abortStream() {
+  if (streamAborted) return;
+  streamAborted = true;
+
+  LOG_DEBUG(3, "Aborted SQL stream after " << rowCount << " rows");
+
+  if (writer.isSet()) writer->reset();
+  streamBuf.clear();
+  if (stallEvent.isSet()) stallEvent->del();
+
+  // Fetch and discard the remaining rows so the DB connection can be reused
+  if (streamPaused && db.isSet()) db->resumeFetch();
+  streamPaused = false;
+}
+
+
+void Query::streamStalled() {
+  LOG_WARNING("SQL stream stalled for " << stallTimeout << "s after "
+              << rowCount << " rows, closing");
+
+  abortStream();
+  if (req->hasConnection()) req->getConnection()->close();
+}
+
+
+bool Query::checkStream(state_t state) {
+  if (streamAborted) return false;
+
+  switch (state) {
+  case MariaDB::EventDB::EVENTDB_ERROR:
+  case MariaDB::EventDB::EVENTDB_RETRY:
+    if (streamStarted) {
+      // The status line is gone, closing without the final chunk tells the
+      // client the response is incomplete
+      LOG_ERROR("SQL stream failed after " << rowCount << " rows: DB:"
+                << db->getErrorNumber() << ": " << db->getError());
+      abortStream();
+      if (req->hasConnection()) req->getConnection()->close();
+      return false;
+    }
+
+    // Nothing sent yet, discard the buffered rows
+    if (writer.isSet()) writer->reset();
+    writer.release();
+    streamOut.release();
+    streamBuf.clear();
+    rowCount = 0;
+
+    returnOk(state);
+    return false;
+
+  default: return true;
+  }
+}
+
+
 void Query::returnPass(MariaDB::EventDB::state_t state) {
   // Run the query and discard any results
   if (state != MariaDB::EventDB::EVENTDB_ROW) returnOk(state);
@@ -317,3 +518,91 @@ void Query::returnOk(MariaDB::EventDB::state_t state) {
     THROW("Unexpected DB response: " << state);
   }
 }
+
+
+void Query::returnStream(MariaDB::EventDB::state_t state) {
+  if (!checkStream(state)) return;
+
+  switch (state) {
+  case MariaDB::EventDB::EVENTDB_ROW: {
+    JSON::Writer &writer = getWriter();
+    if (!rowCount++) writer.beginList();
+
+    writer.beginAppend();
+    if (db->getFieldCount() == 1) db->writeField(writer, 0);
+    else db->writeRowDict(writer);
+
+    flushStream();
+    break;
+  }
+
+  case MariaDB::EventDB::EVENTDB_DONE: {
+    JSON::Writer &writer = getWriter();
+    if (!rowCount) writer.beginList(); // Empty list
+    writer.endList();
+    writer.close();
+    flushStream(true);
+    break;
+  }
+
+  default: break;
+  }
+}
+
+
+void Query::returnNDJSON(MariaDB::EventDB::state_t state) {
+  if (!checkStream(state)) return;
+
+  switch (state) {
+  case MariaDB::EventDB::EVENTDB_ROW: {
+    JSON::Writer &writer = getWriter();
+    rowCount++;
+
+    if (db->getFieldCount() == 1) db->writeField(writer, 0);
+    else db->writeRowDict(writer);
+    writer.reset();
+    getStream() << '\n';
+
+    flushStream();
+    break;
+  }
+
+  case MariaDB::EventDB::EVENTDB_DONE: flushStream(true); break;
+  default: break;
+  }
+}
+
+
+void Query::returnCSV(MariaDB::EventDB::state_t state) {
+  if (!checkStream(state)) return;
+
+  switch (state) {
+  case MariaDB::EventDB::EVENTDB_BEGIN_RESULT: {
+    ostream &stream = getStream();
+
+    for (unsigned i = 0; i < db->getFieldCount(); i++) {
+      if (i) stream << ',';
+      writeCSV(stream, db->getField(i).getName());
+    }
+    stream << "\r\n";
+    break;
+  }
+
+  case MariaDB::EventDB::EVENTDB_ROW: {
+    ostream &stream = getStream();
+    rowCount++;
+
+    for (unsigned i = 0; i < db->getFieldCount(); i++) {
+      if (i) stream << ',';
+      if (!db->isNull(i)) writeCSV(stream, db->getString(i));
+    }
+    stream << "\r\n";
+
+    flushStream();
+    break;
+  }
+
+  case MariaDB::EventDB::EVENTDB_DONE: flushStream(true); break;
+  default: break;
+  }
+}
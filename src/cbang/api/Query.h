@@ -34,11 +34,17 @@
 
 #include <cbang/json/Value.h>
 #include <cbang/json/Builder.h>
+#include <cbang/json/Writer.h>
 #include <cbang/http/Status.h>
+#include <cbang/event/Buffer.h>
 #include <cbang/db/maria/EventDB.h>
 
+#include <ostream>
+
 
 namespace cb {
+  namespace HTTP {class Request;}
+
   namespace API {
     class API;
     class QueryDef;
@@ -55,6 +61,7 @@ namespace cb {
       callback_t cb;
 
       SmartPointer<MariaDB::EventDB> db;
+      bool dbFailed = false;
 
       std::string nextField;
       unsigned currentField = 0;
@@ -66,23 +73,53 @@ namespace cb {
 
       JSON::Builder sink;
 
+      // For the streaming return types
+      SmartPointer<HTTP::Request> req;
+      Event::Buffer streamBuf;
+      SmartPointer<std::ostream> streamOut;
+      SmartPointer<JSON::Writer> writer;
+      unsigned inFlight   = 0; // Bytes written but not yet sent
+      double stallTimeout = 0; // Seconds a paused stream may wait
+      SmartPointer<Event::Event> stallEvent;
+      bool streamStarted  = false;
+      bool streamPaused   = false;
+      bool streamAborted  = false;
+
     public:
       Query(const QueryDef &def, callback_t cb);
-      virtual ~Query() {}
+      virtual ~Query();
 
       void setContentType(const std::string &contentType)
         {this->contentType = contentType;}
 
+      /// Write rows straight to @param req as a chunked response
+      void setStream(const SmartPointer<HTTP::Request> &req)
+        {this->req = req;}
+
+      /// Close a stream whose client has not read for @param timeout seconds
+      void setStallTimeout(double timeout) {stallTimeout = timeout;}
+
       void exec(const std::string &sql,
                 const std::vector<JSON::ValuePtr> &params = {});
       static return_t getReturnType(const std::string &name);
+      static bool isStreaming(const std::string &name);
 
     protected:
+      void dbCallback(state_t state);
+      void releaseDB(bool reuse);
       virtual void callback(state_t state);
 
       void reply(HTTP::Status code = HTTP_OK);
       void errorReply(HTTP::Status code, const std::string &msg = "");
 
+      std::ostream &getStream();
+      JSON::Writer &getWriter();
+      void flushStream(bool final = false);
+      void streamSent(unsigned length, bool success);
+      void abortStream();
+      void streamStalled();
+      bool checkStream(state_t state);
+
       // MariaDB::EventDB callbacks
       void returnPass  (state_t state);
       void returnBinary(state_t state);
@@ -96,6 +133,9 @@ namespace cb {
       void returnOne   (state_t state);
       bool checkOne    (state_t state);
       void returnOk    (state_t state);
+      void returnStream(state_t state);
+      void returnNDJSON(state_t state);
+      void returnCSV   (state_t state);
     };
   }
 }
@@ -44,7 +44,9 @@ using namespace cb::API;
 QueryDef::QueryDef(API &api, const JSON::ValuePtr &config) :
   api(api), sql(String::trim(config->getString("sql", ""))),
   into(config->getString("into", "")),
-  contentType(config->getString("content-type", "")) {
+  contentType(config->getString("content-type", "")),
+  stallTimeout(config->getNumber("stall-timeout", 60)), sqlTmpl(sql),
+  contentTypeTmpl(contentType) {
 
   if (sql.empty()) THROW("Query must have 'sql'");
 
@@ -54,11 +56,19 @@ QueryDef::QueryDef(API &api, const JSON::ValuePtr &config) :
 
   if (!into.empty() && ret == "pass")
     THROW("Query cannot have both 'into' and 'return: pass'");
+  if (!into.empty() && Query::isStreaming(ret))
+    THROW("Query cannot have both 'into' and 'return: " << ret << "'");
 }
 
 
-SmartPointer<MariaDB::EventDB> QueryDef::getDBConnection() const {
-  return api.getDBConnector().getConnection();
+void QueryDef::getDBConnection(MariaDB::Connector::callback_t cb) const {
+  api.getDBConnector().acquire(cb);
+}
+
+
+void QueryDef::releaseDBConnection(
+  const SmartPointer<MariaDB::EventDB> &db, bool reuse) const {
+  api.getDBConnector().release(db, reuse);
 }
 
 
@@ -73,9 +83,10 @@ SmartPointer<Query> QueryDef::query(
 
 
 SmartPointer<Query> QueryDef::query(
-  const ResolverPtr &resolver, Query::callback_t cb) const {
+  const ResolverPtr &resolver, Query::callback_t cb,
+  const SmartPointer<HTTP::Request> &stream) const {
   vector<JSON::ValuePtr> params;
-  string s = resolver->resolveSQL(sql, params);
+  string s = resolver->resolveSQL(sqlTmpl, params);
 
   // Check the bound parameters match the ? placeholders, counting quote-aware
   // so a ref resolved inside a string literal is caught here with a clear
@@ -93,7 +104,11 @@ SmartPointer<Query> QueryDef::query(
 
   auto query = SmartPtr(new Query(*this, cb));
   query->setContentType(
-    contentType.empty() ? contentType : resolver->resolve(contentType));
+    contentType.empty() ? contentType : resolver->resolve(contentTypeTmpl));
+  if (stream.isSet()) {
+    query->setStream(stream);
+    query->setStallTimeout(stallTimeout);
+  }
   query->exec(s, params);
   return query;
 }
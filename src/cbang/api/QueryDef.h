@@ -35,6 +35,8 @@
 #include "Query.h"
 #include "Resolver.h"
 
+#include <cbang/db/maria/Connector.h>
+
 
 namespace cb {
   namespace API {
@@ -47,18 +49,25 @@ namespace cb {
       std::string ret;
       std::string into;        // capture the result instead of replying
       std::string contentType; // for ``return: binary``
+      double stallTimeout;     // for the streaming return types
       JSON::ValuePtr fields;
+      Template sqlTmpl;
+      Template contentTypeTmpl;
 
       QueryDef(API &api, const JSON::ValuePtr &config);
       virtual ~QueryDef() {}
 
       const std::string &getSQL() const {return sql;}
-      virtual SmartPointer<MariaDB::EventDB> getDBConnection() const;
+      const Template &getSQLTemplate() const {return sqlTmpl;}
+      virtual void getDBConnection(MariaDB::Connector::callback_t cb) const;
+      void releaseDBConnection(const SmartPointer<MariaDB::EventDB> &db,
+                               bool reuse) const;
 
       SmartPointer<Query> query(const std::string &sql,
         Query::callback_t cb) const;
       SmartPointer<Query> query(const ResolverPtr &resolver,
-        Query::callback_t cb) const;
+        Query::callback_t cb,
+        const SmartPointer<HTTP::Request> &stream = 0) const;
    };
 
    using QueryDefPtr = SmartPointer<QueryDef>;
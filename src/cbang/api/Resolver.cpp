@@ -50,6 +50,30 @@ using namespace cb::API;
 
 
 namespace {
+  [[noreturn]] void missingRef(const string &id) {
+    THROW("Variable '" << id << "' not found; use {~" << id
+          << "} to resolve null when missing");
+  }
+
+
+  void appendEscaped(string &result, const string &s) {
+    for (char c: s) {
+      if (c == '{' || c == '}') result.push_back(c);
+      result.push_back(c);
+    }
+  }
+
+
+  // The final resolve parses a partially resolved string again only if it
+  // has a '{', so only then must its literal braces stay escaped.
+  string escape(const string &s) {
+    if (s.find('{') == string::npos) return s;
+    string result;
+    appendEscaped(result, s);
+    return result;
+  }
+
+
   // The {request.*} root.  Values materialize on first reference, so an
   // unreferenced value costs nothing.  Holds the Request, like Context, so
   // the request must outlive resolution.
@@ -181,12 +205,22 @@ JSON::ValuePtr Resolver::select(const string &path) const {
 }
 
 
+JSON::ValuePtr Resolver::select(const JSON::Path &path) const {
+  if (path.empty()) return 0;
+
+  auto result = path.select(vars, JSON::ValuePtr());
+  if (result.isSet()) return result;
+  return parent.isSet() ? parent->select(path) : 0;
+}
+
+
 // A ``~`` marks the ref optional: missing resolves to null rather than an
 // error, except in a partial resolve which leaves it for a later resolve.
-JSON::ValuePtr Resolver::selectRef(const string &id, bool partial) const {
-  bool opt = !id.empty() && id[0] == '~';
-  auto value = select(opt ? id.substr(1) : id);
-  if (value.isNull() && opt && !partial) return JSON::Null::instancePtr();
+JSON::ValuePtr Resolver::selectRef(
+  const Template::Token &token, bool partial) const {
+  auto value = select(*token.path);
+  if (value.isNull() && token.optional && !partial)
+    return JSON::Null::instancePtr();
   return value;
 }
 
@@ -218,41 +252,83 @@ uint64_t Resolver::selectTime(const string &path, uint64_t defaultValue) const {
 
 
 string Resolver::resolve(const string &s, bool partial) const {
-  return resolve(s, partial, 0);
+  return resolve(Template(s), partial, 0);
 }
 
 
 string Resolver::resolveSQL(
   const string &s, vector<JSON::ValuePtr> &params) const {
-  return resolve(s, false, &params);
+  return resolve(Template(s), false, &params);
+}
+
+
+string Resolver::resolve(const Template &tmpl) const {
+  return resolve(tmpl, false, 0);
+}
+
+
+string Resolver::resolveSQL(
+  const Template &tmpl, vector<JSON::ValuePtr> &params) const {
+  return resolve(tmpl, false, &params);
 }
 
 
 string Resolver::resolve(
-  const string &s, bool partial, vector<JSON::ValuePtr> *params) const {
-  auto cb = [&] (const string &id, const string &spec) -> string {
-    auto value = selectRef(id, partial);
-
-    if (value.isNull()) {
-      if (partial) // Leave for a later resolve with more vars
-        return "{" + id + (spec.empty() ? string() : (":" + spec)) + "}";
-      THROW("Variable '" << id << "' not found; use {~" << id
-            << "} to resolve null when missing");
-    }
+  const Template &tmpl, bool partial, vector<JSON::ValuePtr> *params) const {
+  auto &tokens = tmpl.getTokens();
+  if (tmpl.isConstant()) {
+    string text = tokens.empty() ? string() : tokens.front().text;
+    return partial ? escape(text) : text;
+  }
 
-    if (params) { // SQL: every ref is bound as a statement parameter
-      auto *blob = dynamic_cast<Blob *>(value.get());
-      params->push_back(
-        blob ? new JSON::String(blob->getData()) :
-        spec.empty() || value->isNull() ? value :
-        new JSON::String(value->formatAs(spec)));
-      return "?";
-    }
+  // Refs left for a later resolve keep the result's braces escaped
+  bool escaped = false;
+  if (partial)
+    for (auto &token: tokens)
+      if (token.ref && selectRef(token, true).isNull()) escaped = true;
+
+  string result;
+  result.reserve(tmpl.getSource().length());
+
+  for (auto &token: tokens)
+    try {
+      if (!token.ref) {
+        if (escaped) appendEscaped(result, token.text);
+        else result.append(token.text);
+        continue;
+      }
 
-    return value->formatAs(spec);
-  };
+      auto value = selectRef(token, partial);
+      const string &spec = token.spec;
+
+      if (value.isNull()) {
+        if (!partial) missingRef(token.text);
+
+        // Leave for a later resolve with more vars
+        result.push_back('{');
+        appendEscaped(result, token.text);
+        if (!spec.empty()) {
+          result.push_back(':');
+          appendEscaped(result, spec);
+        }
+        result.push_back('}');
+
+      } else if (params) { // SQL: every ref is bound as a statement parameter
+        auto *blob = dynamic_cast<Blob *>(value.get());
+        params->push_back(
+          blob ? new JSON::String(blob->getData()) :
+          spec.empty() || value->isNull() ? value :
+          new JSON::String(value->formatAs(spec)));
+        result.push_back('?');
+
+      } else if (escaped) appendEscaped(result, value->formatAs(spec));
+      else result.append(value->formatAs(spec));
+
+    } catch (const Exception &e) {
+      THROWC("String format error at character " << token.offset, e);
+    }
 
-  return String(s).format(cb);
+  return partial && !escaped ? escape(result) : result;
 }
 
 
@@ -265,27 +341,78 @@ JSON::ValuePtr Resolver::resolveValue(
 
   if (value->isString()) {
     const string &s = value->getString();
+    if (s.find('{') == string::npos) return value;
+
+    Template tmpl(s);
 
     // A lone reference with no format spec resolves to the native value
-    if (2 <= s.length() && s.front() == '{' && s.back() == '}') {
-      string id = s.substr(1, s.length() - 2);
-      if (id.find_first_of("{}:") == string::npos) {
-        auto v = selectRef(id, partial);
-        if (v.isSet()) return v->copy(true);
-        if (partial) return value; // Leave for a later resolve
-        THROW("Variable '" << id << "' not found; use {~" << id
-              << "} to resolve null when missing");
-      }
+    if (tmpl.isRef()) {
+      auto v = selectRef(tmpl.getTokens().front(), partial);
+
+      if (partial && v.isSet() && v->isString())
+        return new JSON::String(escape(v->getString()));
+
+      if (v.isSet()) return v->copy(true);
+      if (partial) return value; // Leave for a later resolve
+      missingRef(tmpl.getTokens().front().text);
     }
 
-    if (s.find('{') != string::npos)
-      return new JSON::String(resolve(s, partial));
+    return new JSON::String(resolve(tmpl, partial, 0));
   }
 
   return value;
 }
 
 
+JSON::ValuePtr Resolver::resolveValue(const ValueTemplate &tmpl) const {
+  auto &value = tmpl.getValue();
+
+  if (tmpl.isConstant())
+    return value->isList() || value->isDict() ? value->copy(true) : value;
+
+  auto &t = tmpl.getTemplate();
+  if (t.isSet()) {
+    if (t->isRef()) {
+      auto &token = t->getTokens().front();
+      auto v = selectRef(token, false);
+      if (v.isSet()) return v->copy(true);
+      missingRef(token.text);
+    }
+
+    return new JSON::String(resolve(*t));
+  }
+
+  auto &children = tmpl.getChildren();
+  auto &keys     = tmpl.getKeys();
+
+  if (value->isDict()) {
+    auto result = value->createDict();
+    for (unsigned i = 0; i < children.size(); i++)
+      result->insert(keys[i], resolveValue(*children[i]));
+    return result;
+  }
+
+  auto result = value->createList();
+  for (auto &child: children) result->append(resolveValue(*child));
+  return result;
+}
+
+
+JSON::ValuePtr Resolver::selectValue(const ValueTemplate &tmpl) const {
+  if (tmpl.isConstant()) return tmpl.getValue();
+
+  auto &t = tmpl.getTemplate();
+  if (t.isSet() && t->isRef()) {
+    auto &token = t->getTokens().front();
+    auto v = selectRef(token, false);
+    if (v.isSet()) return v;
+    missingRef(token.text);
+  }
+
+  return resolveValue(tmpl);
+}
+
+
 void Resolver::resolve(JSON::Value &value, bool partial) const {
   if (value.isList())
     for (unsigned i = 0; i < value.size(); i++)
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include "Template.h"
+
 #include <cbang/String.h>
 #include <cbang/json/Dict.h>
 
@@ -53,8 +55,9 @@ namespace cb {
       SmartPointer<Resolver> parent;
       JSON::Dict vars;
 
-      JSON::ValuePtr selectRef(const std::string &id, bool partial) const;
-      std::string resolve(const std::string &s, bool partial,
+      JSON::ValuePtr selectRef(
+        const Template::Token &token, bool partial) const;
+      std::string resolve(const Template &tmpl, bool partial,
                           std::vector<JSON::ValuePtr> *params) const;
 
     public:
@@ -67,6 +70,7 @@ namespace cb {
       void setSession(const SmartPointer<HTTP::Session> &session);
 
       virtual JSON::ValuePtr select(const std::string &path) const;
+      JSON::ValuePtr select(const JSON::Path &path) const;
       std::string selectString(const std::string &path) const;
       std::string selectString(
         const std::string &path, const std::string &defaultValue) const;
@@ -75,7 +79,8 @@ namespace cb {
 
       // A missing {ref} is an error and a missing {~ref} resolves null,
       // except in a partial resolve, which leaves missing refs unresolved
-      // for a later resolve with more vars, e.g. at request time.
+      // for a later resolve with more vars, e.g. at request time.  A partial
+      // resolve also keeps literal braces escaped for that later resolve.
       std::string resolve(const std::string &s, bool partial = false) const;
       // SQL resolve: every ref becomes a ``?`` placeholder and its value is
       // appended to ``params``; a missing {~ref} binds NULL.
@@ -85,6 +90,16 @@ namespace cb {
       // Resolve a single value; a lone {ref} retypes to its native JSON value.
       JSON::ValuePtr resolveValue(
         const JSON::ValuePtr &value, bool partial = false) const;
+
+      // Compiled templates, as above but without parsing per request
+      std::string resolve(const Template &tmpl) const;
+      std::string resolveSQL(
+        const Template &tmpl, std::vector<JSON::ValuePtr> &params) const;
+      // Returns a new value; the template is not modified.
+      JSON::ValuePtr resolveValue(const ValueTemplate &tmpl) const;
+      // As resolveValue() but constants and lone {ref}s are returned without
+      // a copy, so the result must not be modified.
+      JSON::ValuePtr selectValue(const ValueTemplate &tmpl) const;
     };
 
     using ResolverPtr = SmartPointer<Resolver>;
@@ -0,0 +1,217 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ResponseCache.h"
+
+#include <cbang/json/Sink.h>
+#include <cbang/util/RateCollection.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::API;
+
+
+uint64_t ResponseCache::Response::getSize() const {
+  uint64_t size = sizeof(Response) + body.size();
+  for (auto &h: headers) size += h.first.size() + h.second.size();
+  return size;
+}
+
+
+void ResponseCache::setMaxSize(uint64_t maxSize) {
+  this->maxSize = maxSize;
+  evict();
+}
+
+
+ResponseCache::result_t ResponseCache::lookup(
+  const string &key, ResponsePtr &response, const callback_t &waiter,
+  uint64_t now) {
+  auto it = entries.find(key);
+
+  if (it != entries.end()) {
+    auto entry = it->second;
+
+    if (now < entry->expires) {
+      lru.splice(lru.begin(), lru, entry);
+      response = entry->response;
+      hits++;
+      event("hit");
+      return CACHE_HIT;
+    }
+
+    if (now < entry->staleUntil) {
+      // Serve stale while another request refreshes the entry
+      if (flights.find(key) != flights.end()) {
+        lru.splice(lru.begin(), lru, entry);
+        response = entry->response;
+        staleHits++;
+        event("stale");
+        return CACHE_STALE;
+      }
+
+    } else erase(entry);
+  }
+
+  auto flight = flights.find(key);
+  if (flight != flights.end()) {
+    flight->second.waiters.push_back(waiter);
+    coalesced++;
+    event("coalesced");
+    return CACHE_WAIT;
+  }
+
+  flights[key].epoch = epoch;
+  misses++;
+  event("miss");
+  return CACHE_MISS;
+}
+
+
+void ResponseCache::store(
+  const string &key, const ResponsePtr &response, uint64_t ttl,
+  uint64_t stale, const vector<string> &tags, uint64_t now) {
+  vector<callback_t> waiters;
+
+  auto flight = flights.find(key);
+  bool invalidated = false;
+  if (flight != flights.end()) {
+    invalidated = flight->second.epoch != epoch;
+    waiters.swap(flight->second.waiters);
+    flights.erase(flight);
+  }
+
+  // A response computed across an invalidation may already be out of date
+  Entry entry = {key, response, now + ttl, now + ttl + stale, tags,
+                 key.size() + response->getSize()};
+
+  if (!invalidated && ttl && entry.size <= maxSize) {
+    auto it = entries.find(key);
+    if (it != entries.end()) erase(it->second);
+
+    lru.push_front(entry);
+    entries[key] = lru.begin();
+    for (auto &tag: tags) tagKeys[tag].insert(key);
+    size += entry.size;
+
+    evict();
+  }
+
+  for (auto &cb: waiters) cb(response);
+}
+
+
+void ResponseCache::abandon(const string &key) {
+  auto flight = flights.find(key);
+  if (flight == flights.end()) return;
+
+  vector<callback_t> waiters;
+  waiters.swap(flight->second.waiters);
+  flights.erase(flight);
+
+  for (auto &cb: waiters) cb(0);
+}
+
+
+unsigned ResponseCache::invalidate(const string &tag) {
+  epoch++;
+
+  auto it = tagKeys.find(tag);
+  if (it == tagKeys.end()) return 0;
+
+  // Copy, erase() updates the tag index
+  auto keys = it->second;
+  for (auto &key: keys) {
+    auto entry = entries.find(key);
+    if (entry != entries.end()) erase(entry->second);
+  }
+
+  invalidations += keys.size();
+  event("invalidated");
+  LOG_DEBUG(4, "Invalidated " << keys.size() << " cached replies tagged '"
+            << tag << "'");
+
+  return keys.size();
+}
+
+
+void ResponseCache::clear() {
+  epoch++;
+  lru.clear();
+  entries.clear();
+  tagKeys.clear();
+  size = 0;
+}
+
+
+void ResponseCache::writeStats(JSON::Sink &sink) const {
+  sink.beginDict();
+  sink.insert("entries",       entries.size());
+  sink.insert("size",          size);
+  sink.insert("max-size",      maxSize);
+  sink.insert("hits",          hits);
+  sink.insert("stale-hits",    staleHits);
+  sink.insert("misses",        misses);
+  sink.insert("coalesced",     coalesced);
+  sink.insert("evictions",     evictions);
+  sink.insert("invalidations", invalidations);
+  sink.endDict();
+}
+
+
+void ResponseCache::erase(lru_t::iterator it) {
+  for (auto &tag: it->tags) {
+    auto keys = tagKeys.find(tag);
+    if (keys == tagKeys.end()) continue;
+    keys->second.erase(it->key);
+    if (keys->second.empty()) tagKeys.erase(keys);
+  }
+
+  size -= it->size;
+  entries.erase(it->key);
+  lru.erase(it);
+}
+
+
+void ResponseCache::evict() {
+  while (maxSize < size && !lru.empty()) {
+    erase(prev(lru.end()));
+    evictions++;
+    event("evicted");
+  }
+}
+
+
+void ResponseCache::event(const string &name) {
+  if (stats.isSet()) stats->event(name);
+}
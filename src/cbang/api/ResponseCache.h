@@ -0,0 +1,150 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/time/Time.h>
+
+#include <string>
+#include <vector>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+
+namespace cb {
+  class RateCollection;
+  namespace JSON {class Sink;}
+
+  namespace API {
+    // In-memory cache of endpoint replies, bounded in bytes with LRU
+    // eviction.  An entry is fresh for its TTL and may then be served stale
+    // for a grace period while a single request refreshes it.  Concurrent
+    // misses on a key are coalesced so only one request, the leader, runs the
+    // endpoint; the rest wait for its reply.
+    class ResponseCache {
+    public:
+      struct Response : public RefCounted {
+        unsigned code = 200;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string body;
+
+        uint64_t getSize() const;
+      };
+
+      using ResponsePtr = SmartPointer<Response>;
+
+      // Called with the leader's reply, or with null when it was not
+      // cacheable and the waiter must run the endpoint itself.
+      using callback_t = std::function<void (const ResponsePtr &)>;
+
+      enum result_t {
+        CACHE_HIT,   // Fresh response returned
+        CACHE_STALE, // Stale response returned, a refresh is in progress
+        CACHE_MISS,  // Caller is the leader; it must store() or abandon()
+        CACHE_WAIT,  // Caller's callback will be called by the leader
+      };
+
+    protected:
+      struct Entry {
+        std::string key;
+        ResponsePtr response;
+        uint64_t expires;
+        uint64_t staleUntil;
+        std::vector<std::string> tags;
+        uint64_t size;
+      };
+
+      struct Flight {
+        uint64_t epoch;
+        std::vector<callback_t> waiters;
+      };
+
+      typedef std::list<Entry> lru_t;
+      lru_t lru; // Most recently used first
+      std::unordered_map<std::string, lru_t::iterator> entries;
+      std::unordered_map<std::string, std::set<std::string>> tagKeys;
+      std::unordered_map<std::string, Flight> flights;
+
+      uint64_t maxSize;
+      uint64_t size = 0;
+      uint64_t epoch = 0; // Incremented by every invalidation
+
+      SmartPointer<RateCollection> stats;
+      uint64_t hits = 0;
+      uint64_t staleHits = 0;
+      uint64_t misses = 0;
+      uint64_t coalesced = 0;
+      uint64_t evictions = 0;
+      uint64_t invalidations = 0;
+
+    public:
+      ResponseCache(uint64_t maxSize = 64 * 1024 * 1024) : maxSize(maxSize) {}
+
+      uint64_t getMaxSize() const {return maxSize;}
+      void setMaxSize(uint64_t maxSize);
+      uint64_t getSize() const {return size;}
+      unsigned getCount() const {return entries.size();}
+
+      void setStats(const SmartPointer<RateCollection> &stats)
+        {this->stats = stats;}
+
+      uint64_t getHits() const {return hits;}
+      uint64_t getStaleHits() const {return staleHits;}
+      uint64_t getMisses() const {return misses;}
+      uint64_t getCoalesced() const {return coalesced;}
+      uint64_t getEvictions() const {return evictions;}
+      uint64_t getInvalidations() const {return invalidations;}
+
+      result_t lookup(const std::string &key, ResponsePtr &response,
+                      const callback_t &waiter, uint64_t now = Time::now());
+      void store(const std::string &key, const ResponsePtr &response,
+                 uint64_t ttl, uint64_t stale,
+                 const std::vector<std::string> &tags,
+                 uint64_t now = Time::now());
+      void abandon(const std::string &key);
+
+      unsigned invalidate(const std::string &tag);
+      void clear();
+
+      void writeStats(JSON::Sink &sink) const;
+
+    protected:
+      void erase(lru_t::iterator it);
+      void evict();
+      void event(const std::string &name);
+    };
+  }
+}
@@ -0,0 +1,143 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Template.h"
+
+#include <cbang/String.h>
+#include <cbang/Exception.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::API;
+
+
+Template::Token::Token(
+  const string &id, const string &spec, unsigned offset) :
+  ref(true), optional(!id.empty() && id[0] == '~'), text(id), spec(spec),
+  offset(offset) {
+  string p = optional ? id.substr(1) : id;
+  path = p.empty() ? new JSON::Path(vector<string>()) : new JSON::Path(p);
+}
+
+
+// Parses exactly as String::format() does, so a compiled template resolves
+// to the same string the format callback would have produced.
+Template::Template(const string &source) : source(source) {
+  auto end = source.end();
+  string text;
+  int index = 0;
+
+  for (auto it = source.begin(); it != end; it++)
+    try {
+      switch (*it) {
+      case '{':
+        if (++it == end) THROW("Unmatched '{'");
+
+        if (*it == '{') text.push_back('{');
+        else {
+          string fmt;
+
+          while (true) {
+            if (*it == '}') {
+              if (it + 1 != end && *(it + 1) == '}') fmt.push_back(*it++);
+              else break;
+
+            } else if (*it == '{') {
+              if (it + 1 != end && *(it + 1) == '{') fmt.push_back(*it++);
+              else THROW("Unexpected '{'");
+
+            } else fmt.push_back(*it);
+
+            if (++it == end) THROW("Unmatched '}'");
+          }
+
+          string id = fmt;
+          string spec;
+
+          auto colon = fmt.find_last_of(':');
+          if (colon != string::npos) {
+            id   = fmt.substr(0, colon);
+            spec = fmt.substr(colon + 1);
+          }
+
+          if (id.empty() && index != -1) id = String(index++);
+          else index = -1;
+
+          if (!text.empty()) tokens.push_back(Token(text));
+          text.clear();
+
+          tokens.push_back(Token(id, spec, it - source.begin()));
+          refs++;
+        }
+        break;
+
+      case '}':
+        if (it + 1 != end && *(it + 1) == '}') text.push_back(*it++);
+        else THROW("Unmatched '}'");
+        break;
+
+      default: text.push_back(*it); break;
+      }
+    } catch (const Exception &e) {
+      THROWC("String format error at character " << int(it - source.begin()),
+             e);
+    }
+
+  if (!text.empty()) tokens.push_back(Token(text));
+
+  // A lone reference with no format spec may resolve to a native value
+  lone = refs == 1 && tokens.size() == 1 && 3 <= source.length() &&
+    source.find_first_of("{}:", 1) == source.length() - 1;
+}
+
+
+ValueTemplate::ValueTemplate(const JSON::ValuePtr &value) : value(value) {
+  if (value->isString()) {
+    if (value->getString().find('{') != string::npos)
+      tmpl = new Template(value->getString());
+
+  } else if (value->isDict())
+    for (auto e: value->entries()) {
+      keys.push_back(e.key());
+      children.push_back(new ValueTemplate(e.value()));
+    }
+
+  else if (value->isList())
+    for (auto &v: *value) children.push_back(new ValueTemplate(v));
+
+  // Keep a constant container whole
+  for (auto &child: children)
+    if (!child->isConstant()) return;
+
+  keys.clear();
+  children.clear();
+}
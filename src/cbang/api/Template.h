@@ -0,0 +1,108 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/json/Path.h>
+#include <cbang/json/Value.h>
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  namespace API {
+    // A ``{ref}`` template parsed once, when the API loads, so that request
+    // time resolution is a linear pass over literal text and pre-split ref
+    // paths.  The syntax is that of String::format(): ``{{`` and ``}}`` are
+    // literal braces, ``{id:spec}`` formats a ref and ``{~id}`` marks it
+    // optional.
+    class Template {
+    public:
+      struct Token {
+        bool ref = false;
+        bool optional = false;
+        std::string text; // Literal text, or the ref id as written
+        std::string spec;
+        unsigned offset = 0; // Of the closing brace, for error messages
+        SmartPointer<JSON::Path> path;
+
+        Token(const std::string &text) : text(text) {}
+        Token(const std::string &id, const std::string &spec,
+              unsigned offset);
+      };
+
+      typedef std::vector<Token> tokens_t;
+
+    protected:
+      std::string source;
+      tokens_t tokens;
+      unsigned refs = 0;
+      bool lone = false;
+
+    public:
+      explicit Template(const std::string &source = std::string());
+
+      const std::string &getSource() const {return source;}
+      const tokens_t &getTokens() const {return tokens;}
+
+      bool isConstant() const {return !refs;}
+      /// True for a lone ``{ref}`` with no spec, which may resolve to a
+      /// native JSON value rather than a string.
+      bool isRef() const {return lone;}
+    };
+
+
+    // A JSON value with templates compiled in every string it contains.
+    // Constant subtrees are kept as is and only copied when resolved.
+    class ValueTemplate : public RefCounted {
+      JSON::ValuePtr value;
+      SmartPointer<Template> tmpl;
+      std::vector<std::string> keys;
+      std::vector<SmartPointer<ValueTemplate>> children;
+
+    public:
+      explicit ValueTemplate(const JSON::ValuePtr &value);
+
+      const JSON::ValuePtr &getValue() const {return value;}
+      const SmartPointer<Template> &getTemplate() const {return tmpl;}
+      const std::vector<std::string> &getKeys() const {return keys;}
+      const std::vector<SmartPointer<ValueTemplate>> &getChildren() const
+        {return children;}
+
+      bool isConstant() const {return tmpl.isNull() && children.empty();}
+    };
+
+    using ValueTemplatePtr = SmartPointer<ValueTemplate>;
+  }
+}
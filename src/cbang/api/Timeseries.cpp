@@ -37,6 +37,8 @@
 
 #include <cbang/api/handler/TimeseriesHandler.h>
 #include <cbang/json/Reader.h>
+#include <cbang/json/Builder.h>
+#include <cbang/json/InternFactory.h>
 #include <cbang/log/Logger.h>
 
 #include <cmath>
@@ -71,11 +73,13 @@ void Timeseries::query(uint64_t since, unsigned maxResults, const cb_t &cb) {
     if (!status.isOk()) return cb(status.getException(), 0);
 
     JSON::ValuePtr data = new JSON::List;
+    JSON::Builder builder(0, &JSON::InternFactory::instance());
 
     for (auto &result: *results) {
-      auto time  = Time::parse(result.first, TIME_FMT);
-      auto value = JSON::Reader::parse(result.second);
-      data->append(makeEntry(time, value));
+      auto time = Time::parse(result.first, TIME_FMT);
+      JSON::Reader::parse(result.second, builder);
+      data->append(makeEntry(time, builder.getRoot()));
+      builder.reset();
     }
 
     LOG_DEBUG(5, data->size() << " results");
@@ -32,22 +32,54 @@
 
 #include "BoolOpCondition.h"
 
+using namespace std;
 using namespace cb;
 using namespace cb::API;
 
 
+BoolOpCondition::BoolOpCondition(
+  bool isAnd, const vector<ConditionPtr> &conds) : isAnd(isAnd), conds(conds) {
+  for (auto &cond: conds)
+    if (cond->isAsync()) async = true;
+}
+
+
+bool BoolOpCondition::isConstant() const {
+  for (auto &cond: conds)
+    if (!cond->isConstant()) return false;
+  return true;
+}
+
+
+bool BoolOpCondition::eval(const CtxPtr &ctx) {
+  for (auto &cond: conds)
+    if (cond->eval(ctx) != isAnd) return !isAnd; // false ends `and`, etc.
+
+  return isAnd; // all true / none true
+}
+
+
 void BoolOpCondition::operator()(
   const CtxPtr &ctx, const BoolCallback &done) {
-  evalFrom(ctx, 0, done);
+  if (async) evalFrom(ctx, 0, done);
+  else done(eval(ctx));
 }
 
 
 void BoolOpCondition::evalFrom(
   const CtxPtr &ctx, unsigned i, const BoolCallback &done) {
-  if (i == conds.size()) return done(isAnd); // all true / none true
+  // Synchronous conditions run inline, only async ones need a continuation
+  for (; i < conds.size(); i++) {
+    auto &cond = *conds[i];
+
+    if (cond.isAsync())
+      return cond(ctx, [this, ctx, i, done] (bool r) {
+        if (r != isAnd) done(r); // false ends `and`; true ends `or`
+        else evalFrom(ctx, i + 1, done);
+      });
+
+    if (cond.eval(ctx) != isAnd) return done(!isAnd);
+  }
 
-  (*conds[i])(ctx, [this, ctx, i, done] (bool r) {
-    if (r != isAnd) done(r); // false ends `and`; true ends `or`
-    else evalFrom(ctx, i + 1, done);
-  });
+  done(isAnd); // all true / none true
 }
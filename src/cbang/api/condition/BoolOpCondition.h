@@ -44,12 +44,15 @@ namespace cb {
     class BoolOpCondition : public Condition {
       bool isAnd;
       std::vector<ConditionPtr> conds;
+      bool async = false;
 
     public:
-      BoolOpCondition(bool isAnd, const std::vector<ConditionPtr> &conds) :
-        isAnd(isAnd), conds(conds) {}
+      BoolOpCondition(bool isAnd, const std::vector<ConditionPtr> &conds);
 
       // From Condition
+      bool isAsync() const override {return async;}
+      bool isConstant() const override;
+      bool eval(const CtxPtr &ctx) override;
       void operator()(const CtxPtr &ctx, const BoolCallback &done) override;
 
     protected:
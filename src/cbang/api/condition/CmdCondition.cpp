@@ -44,10 +44,13 @@ using namespace cb::API;
 
 
 CmdCondition::CmdCondition(API &api, const JSON::ValuePtr &config) : api(api) {
-  if (config->isString()) Subprocess::parse(config->asString(), cmd);
+  vector<string> args;
+  if (config->isString()) Subprocess::parse(config->asString(), args);
   else if (config->isList())
-    for (auto &v: *config) cmd.push_back(v->asString());
+    for (auto &v: *config) args.push_back(v->asString());
   else THROW("'cmd' must be a string or list");
+
+  for (auto &arg: args) cmd.push_back(Template(arg));
 }
 
 
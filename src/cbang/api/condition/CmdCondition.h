@@ -34,6 +34,8 @@
 
 #include "Condition.h"
 
+#include <cbang/api/Template.h>
+
 #include <vector>
 #include <string>
 
@@ -45,12 +47,13 @@ namespace cb {
     // {cmd: <command>} — true when the process exits 0 (async)
     class CmdCondition : public Condition {
       API &api;
-      std::vector<std::string> cmd;
+      std::vector<Template> cmd;
 
     public:
       CmdCondition(API &api, const JSON::ValuePtr &config);
 
       // From Condition
+      bool isAsync() const override {return true;}
       void operator()(const CtxPtr &ctx, const BoolCallback &done) override;
     };
   }
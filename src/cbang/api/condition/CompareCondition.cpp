@@ -40,23 +40,41 @@ using namespace cb::API;
 
 
 CompareCondition::CompareCondition(
-  const string &op, const JSON::ValuePtr &operands) :
-  op(op), operands(operands) {
+  const string &op, const JSON::ValuePtr &operands) {
   if (!operands->isList() || operands->size() != 2)
     THROW("'" << op << "' takes a list of exactly two values");
+
+  if      (op == "=")  this->op = OP_EQ;
+  else if (op == "!=") this->op = OP_NE;
+  else if (op == "<")  this->op = OP_LT;
+  else if (op == "<=") this->op = OP_LE;
+  else THROW("Unknown comparison '" << op << "'");
+
+  left  = new ValueTemplate(operands->get(0u));
+  right = new ValueTemplate(operands->get(1u));
+}
+
+
+bool CompareCondition::isConstant() const {
+  return left->isConstant() && right->isConstant();
 }
 
 
-void CompareCondition::operator()(
-  const CtxPtr &ctx, const BoolCallback &done) {
-  // Copy so per-request typed substitution does not corrupt the template
-  auto ops = operands->copy(true);
-  ctx->getResolver()->resolve(*ops);
+bool CompareCondition::eval(const CtxPtr &ctx) {
+  int c;
+
+  if (isConstant()) c = left->getValue()->compare(*right->getValue());
+  else {
+    auto resolver = ctx->getResolver();
+    c = resolver->selectValue(*left)->compare(*resolver->selectValue(*right));
+  }
 
-  int c = ops->get(0u)->compare(*ops->get(1u));
+  switch (op) {
+  case OP_EQ: return c == 0;
+  case OP_NE: return c != 0;
+  case OP_LT: return c <  0;
+  case OP_LE: return c <= 0;
+  }
 
-  if      (op == "=")  done(c == 0);
-  else if (op == "!=") done(c != 0);
-  else if (op == "<")  done(c <  0);
-  else                 done(c <= 0); // "<="
+  return false;
 }
@@ -34,21 +34,28 @@
 
 #include "Condition.h"
 
+#include <cbang/api/Template.h>
+
 #include <string>
 
 
 namespace cb {
   namespace API {
-    // {=|!=|<|<=: [a, b]} — compare two values by C!'s JSON rules
+    // {=|!=|<|<=: [a, b]} — compare two values by C!'s JSON rules.  Refs
+    // keep their native type and are compared without copying.
     class CompareCondition : public Condition {
-      std::string op;
-      JSON::ValuePtr operands;
+      typedef enum {OP_EQ, OP_NE, OP_LT, OP_LE} op_t;
+
+      op_t op;
+      ValueTemplatePtr left;
+      ValueTemplatePtr right;
 
     public:
       CompareCondition(const std::string &op, const JSON::ValuePtr &operands);
 
       // From Condition
-      void operator()(const CtxPtr &ctx, const BoolCallback &done) override;
+      bool isConstant() const override;
+      bool eval(const CtxPtr &ctx) override;
     };
   }
 }
@@ -38,6 +38,7 @@
 #include "SQLCondition.h"
 #include "CmdCondition.h"
 #include "TruthyCondition.h"
+#include "ConstCondition.h"
 
 #include <cbang/Exception.h>
 #include <cbang/json/Value.h>
@@ -49,6 +50,11 @@ using namespace cb;
 using namespace cb::API;
 
 
+bool cb::API::Condition::eval(const CtxPtr &ctx) {
+  THROW("Async condition cannot be evaluated synchronously");
+}
+
+
 bool cb::API::Condition::truthy(const JSON::ValuePtr &v) {
   if (v.isNull() || v->isNull() || v->isUndefined()) return false;
   if (v->isBoolean()) return v->getBoolean();
@@ -59,12 +65,22 @@ bool cb::API::Condition::truthy(const JSON::ValuePtr &v) {
 }
 
 
+namespace {
+  // Conditions which do not depend on the request are evaluated once, here.
+  // They never touch the context.
+  ConditionPtr fold(const ConditionPtr &cond) {
+    if (cond->isConstant()) return new ConstCondition(cond->eval(0));
+    return cond;
+  }
+}
+
+
 // Fully qualified so `Condition` is unambiguous despite cb::Condition.
 ConditionPtr cb::API::Condition::parse(
   API &api, const JSON::ValuePtr &config) {
   // A bare scalar value (a ref or literal) is a truthiness test
   if (!config->isDict() && !config->isList())
-    return new TruthyCondition(config);
+    return fold(new TruthyCondition(config));
 
   if (!config->isDict() || config->size() != 1)
     THROW("Condition must be a dict with exactly one key");
@@ -75,15 +91,25 @@ ConditionPtr cb::API::Condition::parse(
 
   if (op == "exists") return new ExistsCondition(val);
   if (op == "=" || op == "!=" || op == "<" || op == "<=")
-    return new CompareCondition(op, val);
+    return fold(new CompareCondition(op, val));
 
-  if (op == "not") return new NotCondition(parse(api, val));
+  if (op == "not") return fold(new NotCondition(parse(api, val)));
 
   if (op == "and" || op == "or") {
     if (!val->isList()) THROW("'" << op << "' takes a list of conditions");
+    bool isAnd = op == "and";
+
+    // Constants either decide the result or drop out
     vector<ConditionPtr> conds;
-    for (auto &c: *val) conds.push_back(parse(api, c));
-    return new BoolOpCondition(op == "and", conds);
+    for (auto &c: *val) {
+      auto cond = parse(api, c);
+      if (!cond->isConstant()) conds.push_back(cond);
+      else if (cond->eval(0) != isAnd) return new ConstCondition(!isAnd);
+    }
+
+    if (conds.empty()) return new ConstCondition(isAnd);
+    if (conds.size() == 1) return conds.front();
+    return new BoolOpCondition(isAnd, conds);
   }
 
   if (op == "sql") return new SQLCondition(api, val);
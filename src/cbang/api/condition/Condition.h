@@ -43,14 +43,25 @@ namespace cb {
 
     // A pipeline condition (see doc/conditions.md).  Evaluation may be async
     // (`sql`/`cmd`) so the result is delivered through a continuation.
+    // Conditions without async leaves also evaluate directly with eval().
     using BoolCallback = std::function<void (bool)>;
 
     class Condition : public RefCounted {
     public:
       virtual ~Condition() {}
 
+      // True if evaluation must go through operator()
+      virtual bool isAsync() const {return false;}
+      // True if the result does not depend on the request.  parse() folds
+      // these to a ConstCondition.
+      virtual bool isConstant() const {return false;}
+
+      // Evaluate a synchronous condition against the request.
+      virtual bool eval(const CtxPtr &ctx);
+
       // Evaluate against the request, delivering the result to `done`.
-      virtual void operator()(const CtxPtr &ctx, const BoolCallback &done) = 0;
+      virtual void operator()(const CtxPtr &ctx, const BoolCallback &done)
+        {done(eval(ctx));}
 
       // Truthiness: set and not false/empty/zero/null (see doc/conditions.md).
       static bool truthy(const JSON::ValuePtr &v);
@@ -44,6 +44,6 @@ ExistsCondition::ExistsCondition(const JSON::ValuePtr &config) :
   path(config->asString()) {}
 
 
-void ExistsCondition::operator()(const CtxPtr &ctx, const BoolCallback &done) {
-  done(SystemUtilities::exists(ctx->getResolver()->resolve(path)));
+bool ExistsCondition::eval(const CtxPtr &ctx) {
+  return SystemUtilities::exists(ctx->getResolver()->resolve(path));
 }
@@ -34,20 +34,20 @@
 
 #include "Condition.h"
 
-#include <string>
+#include <cbang/api/Template.h>
 
 
 namespace cb {
   namespace API {
     // {exists: '<path>'} — true when the file or directory exists
     class ExistsCondition : public Condition {
-      std::string path;
+      Template path;
 
     public:
       ExistsCondition(const JSON::ValuePtr &config);
 
       // From Condition
-      void operator()(const CtxPtr &ctx, const BoolCallback &done) override;
+      bool eval(const CtxPtr &ctx) override;
     };
   }
 }
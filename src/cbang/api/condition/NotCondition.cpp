@@ -37,5 +37,6 @@ using namespace cb::API;
 
 
 void NotCondition::operator()(const CtxPtr &ctx, const BoolCallback &done) {
-  (*cond)(ctx, [done] (bool r) {done(!r);});
+  if (!isAsync()) done(eval(ctx));
+  else (*cond)(ctx, [done] (bool r) {done(!r);});
 }
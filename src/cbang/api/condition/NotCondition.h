@@ -45,6 +45,9 @@ namespace cb {
       NotCondition(const ConditionPtr &cond) : cond(cond) {}
 
       // From Condition
+      bool isAsync() const override {return cond->isAsync();}
+      bool isConstant() const override {return cond->isConstant();}
+      bool eval(const CtxPtr &ctx) override {return !cond->eval(ctx);}
       void operator()(const CtxPtr &ctx, const BoolCallback &done) override;
     };
   }
@@ -49,6 +49,7 @@ namespace cb {
       SQLCondition(API &api, const JSON::ValuePtr &config);
 
       // From Condition
+      bool isAsync() const override {return true;}
       void operator()(const CtxPtr &ctx, const BoolCallback &done) override;
     };
   }
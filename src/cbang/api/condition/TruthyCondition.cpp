@@ -38,7 +38,9 @@ using namespace cb;
 using namespace cb::API;
 
 
-void TruthyCondition::operator()(const CtxPtr &ctx, const BoolCallback &done) {
+bool TruthyCondition::eval(const CtxPtr &ctx) {
+  if (isConstant()) return truthy(value.getValue());
+
   // A lone {ref} retypes to its native value (null when missing via {~ref})
-  done(truthy(ctx->getResolver()->resolveValue(value)));
+  return truthy(ctx->getResolver()->selectValue(value));
 }
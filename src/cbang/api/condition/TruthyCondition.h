@@ -34,18 +34,21 @@
 
 #include "Condition.h"
 
+#include <cbang/api/Template.h>
+
 
 namespace cb {
   namespace API {
     // A bare scalar value (a ref or literal) used as a truthiness test
     class TruthyCondition : public Condition {
-      JSON::ValuePtr value;
+      ValueTemplate value;
 
     public:
       TruthyCondition(const JSON::ValuePtr &value) : value(value) {}
 
       // From Condition
-      void operator()(const CtxPtr &ctx, const BoolCallback &done) override;
+      bool isConstant() const override {return value.isConstant();}
+      bool eval(const CtxPtr &ctx) override;
     };
   }
 }
@@ -0,0 +1,220 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "CacheHandler.h"
+
+#include <cbang/api/API.h>
+#include <cbang/api/Resolver.h>
+#include <cbang/http/Request.h>
+#include <cbang/http/Session.h>
+
+#include <map>
+#include <algorithm>
+
+using namespace std;
+using namespace cb;
+using namespace cb::API;
+
+
+namespace {
+  // Abandons the flight, releasing any waiters, if the leader never replies
+  struct Flight : public RefCounted {
+    ResponseCache &cache;
+    string key;
+    bool done = false;
+
+    Flight(ResponseCache &cache, const string &key) : cache(cache), key(key) {}
+    ~Flight() {abandon();}
+
+    void abandon() {if (!done) {done = true; cache.abandon(key);}}
+  };
+
+
+  // Headers written anew for every reply
+  bool isPerReply(const string &name) {
+    string lower = String::toLower(name);
+    return lower == "date" || lower == "content-length" ||
+      lower == "connection";
+  }
+
+
+  bool isCacheable(const HTTP::Request &req) {
+    unsigned code = req.getResponseCode();
+    return 200 <= code && code < 300 && !req.isChunked() &&
+      !req.outHas("Set-Cookie") &&
+      req.outFind("Cache-Control").find("no-store") == string::npos;
+  }
+}
+
+
+CacheHandler::CacheHandler(API &api, const string &id,
+                           const JSON::ValuePtr &config,
+                           const HandlerPtr &child) :
+  api(api), id(id), child(child) {
+
+  if (config->isNumber()) ttl = config->getU64();
+  else {
+    ttl   = config->getU64("ttl", ttl);
+    stale = config->getU64("stale", stale);
+    scope = config->getString("scope", scope);
+
+    if (scope != "session" && scope != "group" && scope != "public")
+      THROW("Invalid cache scope '" << scope << "'");
+
+    if (config->has("vary"))
+      for (auto &v: *config->get("vary")) vary.push_back(v->asString());
+
+    if (config->has("tags"))
+      for (auto &v: *config->get("tags"))
+        tags.push_back(Template(v->asString()));
+  }
+}
+
+
+void CacheHandler::operator()(const CtxPtr &ctx, const Cont &next) {
+  auto &req = ctx->getRequest();
+  if (ctx->getWebsocket().isSet() || req.getMethod() != HTTP::Method::HTTP_GET)
+    return (*child)(ctx, next);
+
+  string key = getKey(ctx);
+
+  auto cb = [this, ctx, next] (const ResponseCache::ResponsePtr &response) {
+    ctx->errorHandler([&] {
+      if (response.isSet()) replay(ctx, *response, "HIT");
+      else run(ctx, next); // The leader's reply was not cacheable
+    });
+  };
+
+  ResponseCache::ResponsePtr response;
+  switch (api.getResponseCache().lookup(key, response, cb)) {
+  case ResponseCache::CACHE_HIT:   return replay(ctx, *response, "HIT");
+  case ResponseCache::CACHE_STALE: return replay(ctx, *response, "STALE");
+  case ResponseCache::CACHE_WAIT:  return;
+  case ResponseCache::CACHE_MISS:  return fetch(ctx, next, key);
+  }
+}
+
+
+string CacheHandler::getKey(const CtxPtr &ctx) const {
+  auto &req = ctx->getRequest();
+  string key = id + "\n" + req.getURI().getPath();
+
+  // Sort args so their order in the request does not matter
+  auto args = ctx->getResolver()->select("args");
+  if (args.isNull()) args = ctx->getArgs();
+  if (args.isSet() && args->isDict()) {
+    map<string, string> sorted;
+    for (auto e: args->entries())
+      sorted[e.key()] = e.value()->toString(0, true);
+    for (auto &p: sorted) key += "\n" + p.first + "=" + p.second;
+  }
+
+  // The reply's JSON encoding and compression are negotiated per request
+  key += string("\nencoding=") + req.getJSONEncoding().toString() +
+    "\ncompression=" + req.getRequestedCompression().toString();
+
+  for (auto &name: vary) key += "\n" + name + ":" + req.inFind(name);
+
+  auto &session = req.getSession();
+  if (scope == "session")
+    key += "\nuser=" + (session.isSet() ? session->getUser() : string());
+
+  else if (scope == "group" && session.isSet()) {
+    auto groups = session->getGroups();
+    sort(groups.begin(), groups.end());
+    key += "\ngroups=" + String::join(groups, ",");
+  }
+
+  return key;
+}
+
+
+void CacheHandler::fetch(
+  const CtxPtr &ctx, const Cont &next, const string &key) {
+  auto &cache    = api.getResponseCache();
+  auto &req      = ctx->getRequest();
+  auto flight    = SmartPtr(new Flight(cache, key));
+  auto prevReply = req.getOnReply();
+
+  // Resolve tags now, while the resolver has this request's args
+  vector<string> tags;
+  for (auto &t: this->tags) tags.push_back(ctx->getResolver()->resolve(t));
+
+  req.setOnReply([this, &cache, &req, flight, prevReply, tags] () {
+    if (prevReply) prevReply();
+    if (flight->done) return;
+    flight->done = true;
+
+    if (!isCacheable(req)) {
+      cache.abandon(flight->key);
+      return;
+    }
+
+    auto response = SmartPtr(new ResponseCache::Response);
+    response->code = req.getResponseCode();
+    response->body = req.getOutput();
+    for (auto it: req.getOutputHeaders())
+      if (!isPerReply(it.key()))
+        response->headers.push_back(make_pair(it.key(), it.value()));
+
+    req.outSet("X-Cache", "MISS");
+    cache.store(flight->key, response, ttl, stale, tags);
+  });
+
+  // The endpoint passed, so it will not reply for this key
+  auto pass = [flight, prevReply, &req, next] (const CtxPtr &ctx) {
+    req.setOnReply(prevReply);
+    flight->abandon();
+    next(ctx);
+  };
+
+  (*child)(ctx, pass);
+}
+
+
+void CacheHandler::run(const CtxPtr &ctx, const Cont &next) {
+  ctx->getRequest().outSet("X-Cache", "MISS");
+  (*child)(ctx, next);
+}
+
+
+void CacheHandler::replay(const CtxPtr &ctx,
+                          const ResponseCache::Response &response,
+                          const char *status) {
+  auto &req = ctx->getRequest();
+
+  for (auto &h: response.headers) req.outSet(h.first, h.second);
+  req.outSet("X-Cache", status);
+
+  req.reply(HTTP::Status((HTTP::Status::enum_t)response.code),
+            response.body.data(), response.body.length());
+}
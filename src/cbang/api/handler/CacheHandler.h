@@ -0,0 +1,78 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/api/Handler.h>
+#include <cbang/api/Template.h>
+#include <cbang/api/ResponseCache.h>
+
+#include <vector>
+#include <string>
+
+
+namespace cb {
+  namespace API {
+    class API;
+
+    // Caches GET replies of an endpoint per its ``cache:`` option.  The key
+    // is the endpoint, the path, the validated args, the negotiated JSON
+    // encoding and compression, any ``vary`` request headers and, unless
+    // ``scope`` is ``public``, the session user or its groups.  Only 2xx, non-chunked replies which set no cookie are cached.
+    class CacheHandler : public Handler {
+      API &api;
+      std::string id;
+      HandlerPtr child;
+
+      uint64_t ttl   = 60;
+      uint64_t stale = 0;
+      std::string scope = "session";
+      std::vector<std::string> vary;
+      std::vector<Template> tags;
+
+    public:
+      CacheHandler(API &api, const std::string &id,
+                   const JSON::ValuePtr &config, const HandlerPtr &child);
+
+      // From Handler
+      void operator()(const CtxPtr &ctx, const Cont &next) override;
+
+    protected:
+      std::string getKey(const CtxPtr &ctx) const;
+      void fetch(const CtxPtr &ctx, const Cont &next, const std::string &key);
+      void run(const CtxPtr &ctx, const Cont &next);
+      void replay(const CtxPtr &ctx, const ResponseCache::Response &response,
+                  const char *status);
+    };
+
+  }
+}
@@ -64,12 +64,19 @@ ConditionalHandler::ConditionalHandler(API &api, const CfgPtr &cfg) {
 
 void ConditionalHandler::operator()(const CtxPtr &ctx, const Cont &next) {
   ctx->errorHandler([&] {
+    // Without sql/cmd leaves the condition is evaluated in one pass
+    if (!cond->isAsync()) return branch(ctx, next, cond->eval(ctx));
+
     (*cond)(ctx, [this, ctx, next] (bool result) {
-      ctx->errorHandler([&] {
-        if      (result)             (*thenHandler)(ctx, next);
-        else if (elseHandler.isSet()) (*elseHandler)(ctx, next);
-        else                          next(ctx);
-      });
+      ctx->errorHandler([&] {branch(ctx, next, result);});
     });
   });
 }
+
+
+void ConditionalHandler::branch(
+  const CtxPtr &ctx, const Cont &next, bool result) {
+  if      (result)             (*thenHandler)(ctx, next);
+  else if (elseHandler.isSet()) (*elseHandler)(ctx, next);
+  else                          next(ctx);
+}
@@ -53,6 +53,9 @@ namespace cb {
 
       // From Handler
       void operator()(const CtxPtr &ctx, const Cont &next) override;
+
+    protected:
+      void branch(const CtxPtr &ctx, const Cont &next, bool result);
     };
   }
 }
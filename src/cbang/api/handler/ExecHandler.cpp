@@ -89,23 +89,39 @@ ExecHandler::ExecHandler(API &api, const JSON::ValuePtr &config) :
   api(api) {
 
   JSON::ValuePtr cmdVal;
+  JSON::ValuePtr inputVal;
 
   if (config->isString()) cmdVal = config;
   else {
     if (!config->isDict()) THROW("Invalid exec config");
     cmdVal = config->get("cmd");
-    if (config->has("input")) input = config->get("input");
+    if (config->has("input")) inputVal = config->get("input");
+    group       = config->getString("group", "");
+    workers     = config->getU32("workers", 0);
+    maxRequests = config->getU32("max-requests", 0);
+    timeout     = config->getNumber("timeout", timeout);
+    maxLine     = config->getU32("max-line", maxLine);
   }
 
-  if (cmdVal->isString()) Subprocess::parse(cmdVal->asString(), cmd);
-  else if (cmdVal->isList()) for (auto &v: *cmdVal) cmd.push_back(v->asString());
+  vector<string> args;
+  if (cmdVal->isString()) Subprocess::parse(cmdVal->asString(), args);
+  else if (cmdVal->isList())
+    for (auto &v: *cmdVal) args.push_back(v->asString());
   else THROW("exec 'cmd' must be a string or list");
 
+  for (auto &arg: args) {
+    cmd.push_back(Template(arg));
+    if (workers && !cmd.back().isConstant())
+      THROW("exec 'workers' requires a 'cmd' without request variables");
+  }
+
   // Default envelope sends the request args
-  if (input.isNull()) {
-    input = new JSON::Dict;
-    input->insert("args", new JSON::String("{args}"));
+  if (inputVal.isNull()) {
+    inputVal = new JSON::Dict;
+    inputVal->insert("args", new JSON::String("{args}"));
   }
+
+  input = new ValueTemplate(inputVal);
 }
 
 
@@ -116,8 +132,7 @@ void ExecHandler::operator()(const CtxPtr &ctx, const Cont &next) {
   vector<string> rcmd;
   for (auto &arg: cmd) rcmd.push_back(resolver->resolve(arg));
 
-  auto in = input->copy(true);
-  resolver->resolve(*in);
+  auto in = resolver->resolveValue(*input);
 
   // A private temp dir for this step, exported to the process as TMPDIR and
   // removed when the step completes.  Binary envelope values are written to
@@ -126,7 +141,17 @@ void ExecHandler::operator()(const CtxPtr &ctx, const Cont &next) {
     std::filesystem::temp_directory_path().string()));
   writeBlobs(*in, tmpDir->getPath());
 
-  auto &pool = api.getProcPool();
-  pool.enqueue(
-    new ExecProcess(pool.getBase(), rcmd, in->toString(), tmpDir, ctx, next));
+  auto &procPool = api.getProcPool();
+
+  if (workers) {
+    if (pool.isNull())
+      pool = new ExecWorkerPool(procPool.getBase(), rcmd, workers,
+                                maxRequests, timeout, maxLine);
+    return pool->call(in, tmpDir, ctx, next);
+  }
+
+  auto proc = SmartPtr(new ExecProcess(
+    procPool.getBase(), rcmd, in->toString(), tmpDir, ctx, next));
+  proc->setGroup(group);
+  procPool.enqueue(proc);
 }
@@ -32,9 +32,13 @@
 
 #pragma once
 
+#include "ExecWorkerPool.h"
+
 #include <cbang/api/Handler.h>
+#include <cbang/api/Template.h>
 
 #include <vector>
+#include <string>
 
 
 namespace cb {
@@ -43,11 +47,19 @@ namespace cb {
 
     // Runs an external program as a pipeline step.  Sends a JSON metadata
     // envelope on stdin and applies the program's JSON result (see
-    // doc/exec.md).
+    // doc/exec.md).  With ``workers`` the program is kept running and
+    // serves requests as JSON lines, see ExecWorker.
     class ExecHandler : public Handler {
       API &api;
-      std::vector<std::string> cmd;
-      JSON::ValuePtr input;
+      std::vector<Template> cmd;
+      ValueTemplatePtr input;
+
+      std::string group;
+      unsigned workers = 0;
+      unsigned maxRequests = 0;
+      double   timeout = 60;
+      unsigned maxLine = 16 * 1024 * 1024;
+      SmartPointer<ExecWorkerPool> pool;
 
     public:
       ExecHandler(API &api, const JSON::ValuePtr &config);
@@ -69,64 +69,70 @@ void ExecProcess::exec() {
 }
 
 
-void ExecProcess::done() {
-  try {
-    outStr->read();
-    errStr->flush();
-
-    string output = outStr->toString();
-    if (output.empty()) THROW("No output from exec");
-
-    auto results  = JSON::Reader::parse(output);
-    unsigned code = results->getU32("code", 200);
-
-    if (200 <= code && code < 300) {
-      // Merge returned args ("data" is the legacy alias)
-      if (results->hasDict("args")) ctx->getArgs()->merge(results->getDict("args"));
-      else if (results->hasDict("data"))
-        ctx->getArgs()->merge(results->getDict("data"));
-
-      // Response headers
-      if (results->hasDict("headers"))
-        for (auto e: results->getDict("headers").entries())
-          ctx->getRequest().outSet(e.key(), e.value()->asString());
-
-      // Files the program wrote become binary values under {files.*}
-      if (results->hasDict("files")) {
-        auto resolver = ctx->getResolver();
-        auto files    = resolver->select("files");
-        if (files.isNull()) {
-          files = new JSON::Dict;
-          resolver->set("files", files);
-        }
+void ExecProcess::apply(
+  const CtxPtr &ctx, const Cont &next, const JSON::ValuePtr &results) {
+  unsigned code = results->getU32("code", 200);
+
+  if (200 <= code && code < 300) {
+    // Merge returned args ("data" is the legacy alias)
+    if (results->hasDict("args"))
+      ctx->getArgs()->merge(results->getDict("args"));
+    else if (results->hasDict("data"))
+      ctx->getArgs()->merge(results->getDict("data"));
+
+    // Response headers
+    if (results->hasDict("headers"))
+      for (auto e: results->getDict("headers").entries())
+        ctx->getRequest().outSet(e.key(), e.value()->asString());
+
+    // Files the program wrote become binary values under {files.*}
+    if (results->hasDict("files")) {
+      auto resolver = ctx->getResolver();
+      auto files    = resolver->select("files");
+      if (files.isNull()) {
+        files = new JSON::Dict;
+        resolver->set("files", files);
+      }
 
-        for (auto e: results->getDict("files").entries()) {
-          string path, type, filename;
-          if (e.value()->isString()) path = e.value()->getString();
-          else {
-            path     = e.value()->getString("path");
-            type     = e.value()->getString("type", "");
-            filename = e.value()->getString("filename", "");
-          }
-
-          files->insert(
-            e.key(), new Blob(SystemUtilities::read(path), type, filename));
+      for (auto e: results->getDict("files").entries()) {
+        string path, type, filename;
+        if (e.value()->isString()) path = e.value()->getString();
+        else {
+          path     = e.value()->getString("path");
+          type     = e.value()->getString("type", "");
+          filename = e.value()->getString("filename", "");
         }
-      }
 
-      // An explicit response short-circuits the pipeline
-      if (results->has("response")) {
-        ctx->reply((HTTP::Status::enum_t)code, results->get("response"));
-        return;
+        files->insert(
+          e.key(), new Blob(SystemUtilities::read(path), type, filename));
       }
+    }
 
-      // Otherwise continue to the next statement
-      ctx->errorHandler([&] {next(ctx);});
+    // An explicit response short-circuits the pipeline
+    if (results->has("response")) {
+      ctx->reply((HTTP::Status::enum_t)code, results->get("response"));
       return;
     }
 
-    if (results->hasString("error")) LOG_WARNING(results->getString("error"));
-    ctx->reply((HTTP::Status::enum_t)code);
+    // Otherwise continue to the next statement
+    ctx->errorHandler([&] {next(ctx);});
+    return;
+  }
+
+  if (results->hasString("error")) LOG_WARNING(results->getString("error"));
+  ctx->reply((HTTP::Status::enum_t)code);
+}
+
+
+void ExecProcess::done() {
+  try {
+    outStr->read();
+    errStr->flush();
+
+    string output = outStr->toString();
+    if (output.empty()) THROW("No output from exec");
+
+    apply(ctx, next, JSON::Reader::parse(output));
     return;
 
   } CATCH_ERROR;
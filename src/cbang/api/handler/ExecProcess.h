@@ -67,6 +67,11 @@ namespace cb {
         base(base), cmd(cmd), input(input), tmpDir(tmpDir), ctx(ctx),
         next(next) {}
 
+      // Apply an exec program's JSON result to the request: merge args, set
+      // headers and files, then reply or continue to ``next``.
+      static void apply(const CtxPtr &ctx, const Cont &next,
+                        const JSON::ValuePtr &results);
+
       // From AsyncSubprocess
       void exec() override;
       void done() override;
@@ -0,0 +1,259 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ExecWorker.h"
+#include "ExecProcess.h"
+
+#include <cbang/Catch.h>
+#include <cbang/api/Context.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
+#include <cbang/http/Enum.h>
+#include <cbang/json/Dict.h>
+#include <cbang/json/Reader.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Timer.h>
+
+#include <cerrno>
+
+using namespace std;
+using namespace cb;
+using namespace cb::API;
+
+
+ExecWorker::~ExecWorker() {
+  if (closed) return;
+  retiring = true; // Stopped deliberately
+  TRY_CATCH_ERROR(shutdown());
+}
+
+
+void ExecWorker::start(const vector<string> &cmd) {
+  // Do not let a long lived worker hold its siblings' pipes open
+  Subprocess::exec(cmd, SHELL | REDIR_STDERR | REDIR_STDOUT | REDIR_STDIN |
+                   CLOSE_FDS);
+
+  // Make pipes non-blocking
+  for (unsigned i = 0; i < 3; i++)
+    getPipe(i).setBlocking(false);
+
+  readEvent  = base.newEvent(getPipeOut(), [this] {read();},
+                             Event::EventFlag::EVENT_READ |
+                             Event::EventFlag::EVENT_PERSIST);
+  writeEvent = base.newEvent(getPipeIn(), [this] {write();},
+                             Event::EventFlag::EVENT_WRITE |
+                             Event::EventFlag::EVENT_PERSIST);
+  errLog = new Event::StreamLogger(
+    base, getPipeErr(), SSTR("PID:" << getPID() << ':'),
+    CBANG_LOG_DOMAIN, CBANG_LOG_WARNING_LEVEL);
+
+  timeoutEvent = base.newEvent([this] {timedOut();}, 0);
+
+  readEvent->add();
+
+  LOG_DEBUG(4, "Started exec worker " << getPID());
+}
+
+
+void ExecWorker::call(const JSON::ValuePtr &input,
+                      const SmartPointer<TemporaryDirectory> &tmpDir,
+                      const CtxPtr &ctx, const Cont &next) {
+  if (closed || retiring) THROW("Exec worker not accepting requests");
+
+  uint64_t id = ++nextID;
+  double deadline = timeout ? Timer::now() + timeout : 0;
+  calls[id] = Call{ctx, next, tmpDir, deadline};
+  served++;
+  if (calls.size() == 1) scheduleTimeout();
+
+  JSON::Dict frame;
+  frame.insert("id", id);
+  frame.insert("tmpdir", tmpDir->getPath());
+  frame.insert("input", input);
+
+  inBuf.add(frame.toString(0, true) + "\n");
+  write();
+}
+
+
+// Finish the requests in flight, then close stdin so the program exits
+void ExecWorker::retire() {
+  retiring = true;
+  write();
+}
+
+
+void ExecWorker::close() {
+  if (closed) return;
+  auto self = SmartPtr(this); // Replies may drop this worker from its pool
+  shutdown();
+}
+
+
+void ExecWorker::shutdown() {
+  closed = true;
+
+  if (readEvent.isSet())    readEvent->del();
+  if (writeEvent.isSet())   writeEvent->del();
+  if (timeoutEvent.isSet()) timeoutEvent->del();
+  if (errLog.isSet()) TRY_CATCH_ERROR(errLog->flush());
+  errLog.release();
+
+  if (isRunning()) kill();
+  closePipes();
+
+  if (!calls.empty() || !retiring)
+    LOG_WARNING("Exec worker " << getPID() << " exited with "
+                << calls.size() << " requests pending, return code "
+                << getReturnCode());
+
+  // Fail the requests it will never answer
+  auto calls = this->calls;
+  this->calls.clear();
+  for (auto &p: calls)
+    TRY_CATCH_ERROR(p.second.ctx->reply(HTTP::Enum::HTTP_BAD_GATEWAY));
+}
+
+
+void ExecWorker::read() {
+  auto self = SmartPtr(this); // Keep alive
+  int bytes = outBuf.read(getPipeOut(), 1e6);
+
+  // Each line is one result
+  while (scanned < outBuf.getLength()) {
+    int index = outBuf.indexOf("\n", scanned);
+    if (index < 0) scanned = outBuf.getLength();
+
+    if (maxLine && maxLine < (index < 0 ? scanned : (unsigned)index)) {
+      LOG_ERROR("Exec worker " << getPID() << " result longer than "
+                << maxLine << " bytes");
+      return close();
+    }
+
+    if (index < 0) break;
+
+    string line(index, 0);
+    outBuf.remove(&line[0], index);
+    outBuf.drain(1);
+    scanned = 0;
+
+    receive(line);
+    if (closed) return;
+  }
+
+  if (!bytes || (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+    close();
+}
+
+
+void ExecWorker::write() {
+  if (closed || !getPipeIn().isOpen()) return;
+
+  if (!inBuf.isEmpty() &&
+      inBuf.write(getPipeIn()) < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+    return close();
+
+  if (!inBuf.isEmpty()) {
+    if (!writeEvent->isPending()) writeEvent->add();
+    return;
+  }
+
+  writeEvent->del();
+  if (retiring && calls.empty()) getPipeIn().close();
+}
+
+
+void ExecWorker::receive(const string &line) {
+  JSON::ValuePtr results;
+  uint64_t id;
+
+  try {
+    results = JSON::Reader::parse(line);
+    id = results->getU64("id");
+
+  } catch (const Exception &e) {
+    // Results can no longer be matched to requests
+    LOG_ERROR("Invalid exec worker result: " << e.getMessage());
+    return close();
+  }
+
+  auto it = calls.find(id);
+  if (it == calls.end()) {
+    LOG_WARNING("Exec worker result for unknown id " << id);
+    return;
+  }
+
+  Call call = it->second;
+  calls.erase(it);
+  scheduleTimeout();
+
+  try {
+    ExecProcess::apply(call.ctx, call.next, results);
+  } catch (const Exception &e) {
+    LOG_ERROR(e);
+    TRY_CATCH_ERROR(call.ctx->reply(HTTP::Enum::HTTP_INTERNAL_SERVER_ERROR));
+  }
+
+  if (retiring) write();
+}
+
+
+// The oldest request has the earliest deadline
+void ExecWorker::scheduleTimeout() {
+  if (!timeout || closed) return;
+  if (calls.empty()) return timeoutEvent->del();
+
+  double delay = calls.begin()->second.deadline - Timer::now();
+  timeoutEvent->add(0 < delay ? delay : 0);
+}
+
+
+void ExecWorker::timedOut() {
+  auto self = SmartPtr(this); // Keep alive
+  double now = Timer::now();
+
+  if (calls.empty() || now < calls.begin()->second.deadline)
+    return scheduleTimeout();
+
+  LOG_WARNING("Exec worker " << getPID() << " request timed out after "
+              << timeout << " seconds");
+
+  // Answer the expired requests, close() fails the rest
+  while (!calls.empty() && calls.begin()->second.deadline <= now) {
+    Call call = calls.begin()->second;
+    calls.erase(calls.begin());
+    TRY_CATCH_ERROR(call.ctx->reply(HTTP::Enum::HTTP_GATEWAY_TIME_OUT));
+  }
+
+  retiring = true; // Already reported
+  close();
+}
@@ -0,0 +1,113 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/api/Handler.h>
+#include <cbang/os/Subprocess.h>
+#include <cbang/os/TemporaryDirectory.h>
+#include <cbang/event/Buffer.h>
+#include <cbang/event/StreamLogger.h>
+#include <cbang/json/Value.h>
+
+#include <vector>
+#include <string>
+#include <map>
+
+
+namespace cb {
+  namespace Event {
+    class Base;
+    class Event;
+  }
+
+  namespace API {
+    // A long-lived exec program serving many requests.  Each request is one
+    // line of JSON, ``{"id": N, "tmpdir": <path>, "input": <envelope>}``, on
+    // the program's stdin.  It answers each with one line of JSON carrying
+    // the same ``id`` plus the usual exec result, in any order.  A worker
+    // which does not answer within ``timeout`` seconds, or writes a line
+    // longer than ``maxLine``, is killed.
+    class ExecWorker : public Subprocess, public RefCounted {
+      struct Call {
+        CtxPtr ctx;
+        Cont next;
+        SmartPointer<TemporaryDirectory> tmpDir;
+        double deadline;
+      };
+
+      Event::Base &base;
+      double timeout;
+      unsigned maxLine;
+
+      Event::Buffer inBuf;
+      Event::Buffer outBuf;
+      unsigned scanned = 0;
+
+      SmartPointer<Event::Event>       readEvent;
+      SmartPointer<Event::Event>       writeEvent;
+      SmartPointer<Event::Event>       timeoutEvent;
+      SmartPointer<Event::StreamLogger> errLog;
+
+      std::map<uint64_t, Call> calls;
+      uint64_t nextID = 0;
+      unsigned served = 0;
+      bool retiring = false;
+      bool closed = false;
+
+    public:
+      ExecWorker(Event::Base &base, double timeout = 0, unsigned maxLine = 0) :
+        base(base), timeout(timeout), maxLine(maxLine) {}
+      ~ExecWorker();
+
+      unsigned getPending() const {return calls.size();}
+      unsigned getServed() const {return served;}
+      bool isRetiring() const {return retiring;}
+      bool isClosed() const {return closed;}
+
+      void start(const std::vector<std::string> &cmd);
+      void call(const JSON::ValuePtr &input,
+                const SmartPointer<TemporaryDirectory> &tmpDir,
+                const CtxPtr &ctx, const Cont &next);
+      void retire();
+      void close();
+
+    protected:
+      void shutdown();
+      void read();
+      void write();
+      void receive(const std::string &line);
+      void scheduleTimeout();
+      void timedOut();
+    };
+  }
+}
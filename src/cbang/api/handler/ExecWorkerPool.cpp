@@ -0,0 +1,94 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ExecWorkerPool.h"
+
+#include <cbang/Exception.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::API;
+
+
+ExecWorkerPool::ExecWorkerPool(
+  Event::Base &base, const vector<string> &cmd, unsigned size,
+  unsigned maxRequests, double timeout, unsigned maxLine) :
+  base(base), cmd(cmd), size(size), maxRequests(maxRequests),
+  timeout(timeout), maxLine(maxLine) {
+  if (!size) THROW("Exec worker pool size must be at least 1");
+}
+
+
+void ExecWorkerPool::call(
+  const JSON::ValuePtr &input, const SmartPointer<TemporaryDirectory> &tmpDir,
+  const CtxPtr &ctx, const Cont &next) {
+  auto &worker = select();
+
+  worker.call(input, tmpDir, ctx, next);
+
+  if (maxRequests && maxRequests <= worker.getServed()) {
+    LOG_DEBUG(4, "Recycling exec worker " << worker.getPID() << " after "
+              << worker.getServed() << " requests");
+    worker.retire();
+  }
+}
+
+
+// The least loaded worker, starting new ones to fill the pool
+ExecWorker &ExecWorkerPool::select() {
+  unsigned active = 0;
+
+  for (auto it = workers.begin(); it != workers.end();)
+    if ((*it)->isClosed()) it = workers.erase(it);
+    else {
+      if (!(*it)->isRetiring()) active++;
+      it++;
+    }
+
+  for (; active < size; active++) {
+    SmartPointer<ExecWorker> worker = new ExecWorker(base, timeout, maxLine);
+    worker->start(cmd);
+    workers.push_back(worker);
+  }
+
+  ExecWorker *best = 0;
+  for (unsigned i = 0; i < workers.size(); i++) {
+    auto &worker = *workers[(nextWorker + i) % workers.size()];
+    if (worker.isRetiring()) continue;
+    if (!best || worker.getPending() < best->getPending()) best = &worker;
+  }
+
+  nextWorker++;
+
+  return *best;
+}
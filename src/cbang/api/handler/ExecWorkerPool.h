@@ -0,0 +1,75 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "ExecWorker.h"
+
+#include <vector>
+#include <string>
+
+
+namespace cb {
+  namespace API {
+    // Keeps ``size`` persistent workers running one exec command and spreads
+    // requests over them.  Workers which die are replaced on the next
+    // request.  A worker is retired after ``maxRequests`` so a leaking
+    // program is recycled.  ``timeout`` and ``maxLine`` limit each worker,
+    // see ExecWorker.
+    class ExecWorkerPool {
+      Event::Base &base;
+      std::vector<std::string> cmd;
+      unsigned size;
+      unsigned maxRequests;
+      double timeout;
+      unsigned maxLine;
+
+      std::vector<SmartPointer<ExecWorker>> workers;
+      unsigned nextWorker = 0;
+
+    public:
+      ExecWorkerPool(Event::Base &base, const std::vector<std::string> &cmd,
+                     unsigned size, unsigned maxRequests = 0,
+                     double timeout = 0, unsigned maxLine = 0);
+
+      unsigned getSize() const {return size;}
+      unsigned getMaxRequests() const {return maxRequests;}
+
+      void call(const JSON::ValuePtr &input,
+                const SmartPointer<TemporaryDirectory> &tmpDir,
+                const CtxPtr &ctx, const Cont &next);
+
+    protected:
+      ExecWorker &select();
+    };
+  }
+}
@@ -34,18 +34,31 @@
 
 #include <cbang/api/Headers.h>
 #include <cbang/api/Handler.h>
+#include <cbang/api/Resolver.h>
+#include <cbang/api/Template.h>
+
+#include <vector>
 
 
 namespace cb {
   namespace API {
     class HeadersHandler : public Handler, public Headers {
+      std::vector<Template> values;
+
     public:
       HeadersHandler() {}
-      HeadersHandler(const JSON::ValuePtr &config) : Headers(config) {}
+      HeadersHandler(const JSON::ValuePtr &config) : Headers(config) {
+        for (auto &p: *this) values.push_back(Template(p.second));
+      }
 
       // From Handler
       void operator()(const CtxPtr &ctx, const Cont &next) override {
-        set(ctx->getRequest());
+        auto &req      = ctx->getRequest();
+        auto &resolver = ctx->getResolver();
+
+        for (unsigned i = 0; i < values.size(); i++)
+          req.outSet(at(i).first, resolver->resolve(values[i]));
+
         next(ctx);
       }
     };
@@ -0,0 +1,68 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "InvalidateHandler.h"
+
+#include <cbang/api/API.h>
+#include <cbang/api/Resolver.h>
+#include <cbang/http/Request.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::API;
+
+
+InvalidateHandler::InvalidateHandler(
+  API &api, const JSON::ValuePtr &config, const HandlerPtr &child) :
+  api(api), child(child) {
+  if (config->isString()) tags.push_back(Template(config->getString()));
+  else for (auto &v: *config) tags.push_back(Template(v->asString()));
+}
+
+
+void InvalidateHandler::operator()(const CtxPtr &ctx, const Cont &next) {
+  // Resolve now, while the resolver has this request's args
+  vector<string> tags;
+  for (auto &t: this->tags) tags.push_back(ctx->getResolver()->resolve(t));
+
+  auto &req      = ctx->getRequest();
+  auto &cache    = api.getResponseCache();
+  auto prevReply = req.getOnReply();
+
+  req.setOnReply([&cache, &req, prevReply, tags] () {
+    if (prevReply) prevReply();
+    if (400 <= req.getResponseCode()) return;
+    for (auto &tag: tags) cache.invalidate(tag);
+  });
+
+  (*child)(ctx, next);
+}
@@ -64,5 +64,14 @@ void QueryHandler::operator()(const CtxPtr &ctx, const Cont &next) {
       } else reply(ctx, status, result);
     };
 
-  queryDef->query(ctx->getResolver(), cb);
+  // Streaming return types write rows straight to the HTTP response
+  SmartPointer<HTTP::Request> stream;
+  if (Query::isStreaming(queryDef->ret)) {
+    if (ctx->getWebsocket().isSet())
+      THROW("Query return type '" << queryDef->ret
+            << "' is not supported over websockets");
+    stream = SmartPtr(&ctx->getRequest());
+  }
+
+  queryDef->query(ctx->getResolver(), cb, stream);
 }
@@ -32,6 +32,7 @@
 
 #include "RedirectHandler.h"
 
+#include <cbang/api/Resolver.h>
 #include <cbang/http/Request.h>
 
 using namespace cb::API;
@@ -49,6 +50,7 @@ RedirectHandler::RedirectHandler(const JSON::ValuePtr &config) :
 
 
 void RedirectHandler::operator()(const CtxPtr &ctx, const Cont &next) {
-  ctx->getRequest().outSet("Location", location);
+  auto &req = ctx->getRequest();
+  req.outSet("Location", ctx->getResolver()->resolve(location));
   StatusHandler::operator()(ctx, next);
 }
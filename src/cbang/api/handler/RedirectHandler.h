@@ -34,11 +34,13 @@
 
 #include "StatusHandler.h"
 
+#include <cbang/api/Template.h>
+
 
 namespace cb {
   namespace API {
     class RedirectHandler : public StatusHandler {
-      std::string location;
+      Template location;
 
     public:
       RedirectHandler(const std::string &location,
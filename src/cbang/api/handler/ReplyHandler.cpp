@@ -44,13 +44,8 @@ ReplyHandler::ReplyHandler(const JSON::ValuePtr &config) :
 
 
 void ReplyHandler::operator()(const CtxPtr &ctx, const Cont &next) {
+  // A lone '{ref}' keeps its native type, binary included
   ctx->errorHandler([&] {
-    // Resolve a copy inside a list so a lone '{ref}' keeps its native type,
-    // binary included.
-    auto wrapper = tmpl->createList();
-    wrapper->append(tmpl->copy(true));
-    ctx->getResolver()->resolve(*wrapper);
-
-    ctx->reply(code, wrapper->get(0));
+    ctx->reply(code, ctx->getResolver()->resolveValue(tmpl));
   });
 }
@@ -33,8 +33,7 @@
 #pragma once
 
 #include <cbang/api/Handler.h>
-
-#include <cbang/json/Value.h>
+#include <cbang/api/Template.h>
 
 
 namespace cb {
@@ -43,7 +42,7 @@ namespace cb {
     // A binary value replies as the raw response body.  A sibling ``code:``
     // sets the response status.
     class ReplyHandler : public Handler {
-      JSON::ValuePtr tmpl;
+      ValueTemplate tmpl;
       HTTP::Status code;
 
     public:
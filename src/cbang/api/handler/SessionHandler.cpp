@@ -106,6 +106,7 @@ void SessionHandler::operator()(const CtxPtr &ctx, const Cont &next) {
 
   auto query = SmartPtr(new SessionQuery(*queryDef, req.getSession(), cb));
   vector<JSON::ValuePtr> params;
-  string s = ctx->getResolver()->resolveSQL(queryDef->getSQL(), params);
+  string s =
+    ctx->getResolver()->resolveSQL(queryDef->getSQLTemplate(), params);
   query->exec(s, params);
 }
@@ -92,7 +92,8 @@ TimeseriesHandler::TimeseriesHandler(
 
   // Query return type
   if (!config->hasString("return")) ret = "list";
-  if (ret == "hlist") THROW("Timeseries return type cannot be 'hlist'");
+  if (ret == "hlist" || Query::isStreaming(ret))
+    THROW("Timeseries return type cannot be '" << ret << "'");
 
   // Key
   if (config->has("key")) {
@@ -190,14 +191,13 @@ void TimeseriesHandler::process() {
           if (batch.isSet()) {
             LOG_DEBUG(3, "Writing to DB " << name);
 
-            auto cb = [batch = batch, last = last, name = name] () {
-              batch->set("\0"s, last->toString());
-              batch->commit();
+            auto cb = [name = name] (bool success) {
               LOG_DEBUG(3, "Done " << name);
             };
 
+            batch->set("\0"s, last->toString());
+            db.commit(batch, cb);
             batch.release();
-            db.getPool()->submit(0, cb);
 
           } else LOG_DEBUG(3, "No results, done " << name);
 
@@ -298,10 +298,13 @@ void TimeseriesHandler::action(const CtxPtr &ctx) {
 }
 
 
-SmartPointer<MariaDB::EventDB> TimeseriesHandler::getDBConnection() const {
-  auto db = QueryDef::getDBConnection();
-  db->setPriority(8); // Lower priority to avoid blocking regular API requests
-  return db;
+void TimeseriesHandler::getDBConnection(
+  MariaDB::Connector::callback_t cb) const {
+  QueryDef::getDBConnection([cb] (const SmartPointer<MariaDB::EventDB> &db) {
+    // Lower priority to avoid blocking regular API requests
+    if (db.isSet()) db->setPriority(8);
+    cb(db);
+  });
 }
 
 
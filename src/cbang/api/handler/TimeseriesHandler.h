@@ -78,7 +78,7 @@ namespace cb {
       void action(const CtxPtr &ctx);
 
       // From QueryDef
-      SmartPointer<MariaDB::EventDB> getDBConnection() const override;
+      void getDBConnection(MariaDB::Connector::callback_t cb) const override;
 
       // From Handler
       void operator()(const CtxPtr &ctx, const Cont &next) override;
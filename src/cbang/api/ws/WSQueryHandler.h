@@ -33,6 +33,7 @@
 #pragma once
 
 #include <cbang/api/Handler.h>
+#include <cbang/api/Template.h>
 
 
 namespace cb {
@@ -42,7 +43,7 @@ namespace cb {
     class WSQueryHandler : public Handler {
       API &api;
       std::string category;
-      std::string query;
+      Template query;
 
     public:
       WSQueryHandler(API &api, const JSON::ValuePtr &config);
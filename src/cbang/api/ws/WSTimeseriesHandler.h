@@ -33,6 +33,7 @@
 #pragma once
 
 #include <cbang/api/Handler.h>
+#include <cbang/api/Template.h>
 
 
 namespace cb {
@@ -42,7 +43,7 @@ namespace cb {
    class WSTimeseriesHandler : public Handler {
     API &api;
     std::string category;
-    std::string timeseries;
+    Template timeseries;
 
     public:
       WSTimeseriesHandler(API &api, const JSON::ValuePtr &config);
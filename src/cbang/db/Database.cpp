@@ -75,6 +75,8 @@ void Database::open(const string &filename, unsigned flags) {
 
 
 void Database::close() {
+  clearStmtCache();
+
   if (isOpen()) {
     if (sqlite3_close(db) != SQLITE_OK)
       LOG_WARNING("Failed to close DB connection: " << lastErrorMsg());
@@ -83,6 +85,56 @@ void Database::close() {
 }
 
 
+void Database::setJournalMode(journal_mode_t mode) {
+  // Returns the resulting mode, e.g. an in-memory database cannot use WAL
+  string result;
+  execute(SSTR("PRAGMA journal_mode = " << toString(mode)), result);
+
+  if (String::toLower(result) != toString(mode))
+    LOG_WARNING("SQLite journal mode " << toString(mode)
+                << " not available, using " << result);
+}
+
+
+void Database::setSynchronous(synchronous_t level) {
+  execute(SSTR("PRAGMA synchronous = " << toString(level)));
+}
+
+
+void Database::setMMapSize(uint64_t size) {
+  execute(SSTR("PRAGMA mmap_size = " << size));
+}
+
+
+void Database::setCacheSize(int64_t size) {
+  execute(SSTR("PRAGMA cache_size = " << size));
+}
+
+
+const char *Database::toString(journal_mode_t mode) {
+  switch (mode) {
+  case JOURNAL_DELETE:   return "delete";
+  case JOURNAL_TRUNCATE: return "truncate";
+  case JOURNAL_PERSIST:  return "persist";
+  case JOURNAL_MEMORY:   return "memory";
+  case JOURNAL_WAL:      return "wal";
+  case JOURNAL_OFF:      return "off";
+  }
+  THROW("Invalid journal mode " << (int)mode);
+}
+
+
+const char *Database::toString(synchronous_t level) {
+  switch (level) {
+  case SYNC_OFF:    return "off";
+  case SYNC_NORMAL: return "normal";
+  case SYNC_FULL:   return "full";
+  case SYNC_EXTRA:  return "extra";
+  }
+  THROW("Invalid synchronous level " << (int)level);
+}
+
+
 void Database::executef(const char *sql, ...) {
   va_list ap;
 
@@ -116,17 +168,17 @@ void Database::execute(const string &sql) {
 
 
 bool Database::execute(const string &sql, int64_t &result) {
-  return compile(sql)->execute(result);
+  return compileCached(sql)->execute(result);
 }
 
 
 bool Database::execute(const string &sql, double &result) {
-  return compile(sql)->execute(result);
+  return compileCached(sql)->execute(result);
 }
 
 
 bool Database::execute(const string &sql, string &result) {
-  return compile(sql)->execute(result);
+  return compileCached(sql)->execute(result);
 }
 
 
@@ -146,6 +198,69 @@ SmartPointer<Statement> Database::compile(const string &sql) {
 }
 
 
+SmartPointer<Statement> Database::compileCached(const string &sql) {
+  if (!stmtCacheSize) return compile(sql);
+
+  auto it = stmtCache.find(sql);
+  if (it != stmtCache.end()) {
+    stmtCacheHits++;
+    stmtLRU.splice(stmtLRU.begin(), stmtLRU, it->second);
+
+    SmartPointer<Statement> stmt = it->second->second;
+    stmt->reset();
+    stmt->clearBindings();
+    return stmt;
+  }
+
+  stmtCacheMisses++;
+  SmartPointer<Statement> stmt = compile(sql);
+  stmtLRU.push_front(make_pair(sql, stmt));
+  stmtCache[sql] = stmtLRU.begin();
+
+  // Evict least recently used.  A caller may still hold the statement.
+  while (stmtCacheSize < stmtLRU.size()) {
+    stmtCache.erase(stmtLRU.back().first);
+    stmtLRU.pop_back();
+  }
+
+  return stmt;
+}
+
+
+void Database::setStmtCacheSize(unsigned size) {
+  if (size == stmtCacheSize) return;
+  clearStmtCache();
+  stmtCacheSize = size;
+}
+
+
+void Database::clearStmtCache() {
+  stmtLRU.clear();
+  stmtCache.clear();
+}
+
+
+unsigned Database::bulk(const string &sql, bind_cb_t bind) {
+  SmartPointer<Statement> stmt = compileCached(sql);
+
+  // One transaction for all rows, unless the caller already opened one.  On
+  // error the Transaction destructor rolls back.
+  SmartPointer<Transaction> tx;
+  if (!transaction) tx = begin(IMMEDIATE, timeout);
+
+  unsigned row = 0;
+  while (bind(*stmt, row)) {
+    stmt->execute();
+    stmt->clearBindings();
+    row++;
+  }
+
+  if (tx.isSet()) tx->commit();
+
+  return row;
+}
+
+
 SmartPointer<Transaction> Database::begin(transaction_t type, double timeout) {
   if (transaction) THROW("Already in a transaction");
 
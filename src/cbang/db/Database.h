@@ -38,6 +38,10 @@
 #include <cbang/SmartPointer.h>
 
 #include <string>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
 
 struct sqlite3;
 
@@ -51,6 +55,15 @@ namespace cb {
       sqlite3 *db;
       Transaction *transaction;
 
+      // Compiled statements keyed by SQL text, most recently used first
+      using stmtLRU_t =
+        std::list<std::pair<std::string, SmartPointer<Statement>>>;
+      stmtLRU_t stmtLRU;
+      std::unordered_map<std::string, stmtLRU_t::iterator> stmtCache;
+      unsigned stmtCacheSize = 32;
+      uint64_t stmtCacheHits = 0;
+      uint64_t stmtCacheMisses = 0;
+
     public:
       typedef enum {
         DEFERRED,
@@ -69,6 +82,24 @@ namespace cb {
         PRIVATE_CACHE = 0x00040000,
       } open_mode_t;
 
+      enum journal_mode_t {
+        JOURNAL_DELETE,
+        JOURNAL_TRUNCATE,
+        JOURNAL_PERSIST,
+        JOURNAL_MEMORY,
+        JOURNAL_WAL,
+        JOURNAL_OFF,
+      };
+
+      enum synchronous_t {
+        SYNC_OFF,
+        SYNC_NORMAL,
+        SYNC_FULL,
+        SYNC_EXTRA,
+      };
+
+      using bind_cb_t = std::function<bool (Statement &stmt, unsigned row)>;
+
       Database(double timeout = 30);
       virtual ~Database();
 
@@ -79,6 +110,16 @@ namespace cb {
       void open(const std::string &con, unsigned flags = READ_WRITE | CREATE);
       void close();
 
+      // Tuning, applied with PRAGMA on an open database
+      void setJournalMode(journal_mode_t mode);
+      void setSynchronous(synchronous_t level);
+      /// Memory map up to @param size bytes of the file, zero disables
+      void setMMapSize(uint64_t size);
+      /// Page cache size, in pages if positive or in KiB if negative
+      void setCacheSize(int64_t size);
+      static const char *toString(journal_mode_t mode);
+      static const char *toString(synchronous_t level);
+
       [[gnu::format(printf, 2, 3)]]
       void executef(const char *sql, ...);
       void execute(const std::string &sql);
@@ -90,6 +131,32 @@ namespace cb {
       SmartPointer<Statement> compilef(const char *sql, ...);
       SmartPointer<Statement> compile(const std::string &sql);
 
+      /**
+       * Compile @param sql or reuse the statement cached for the same text.
+       * The statement is reset with its bindings cleared.  It is shared, so
+       * it is only valid until the next compileCached() of the same SQL.
+       */
+      SmartPointer<Statement> compileCached(const std::string &sql);
+
+      // Statement cache.  A size of zero disables caching.
+      unsigned getStmtCacheSize() const {return stmtCacheSize;}
+      void setStmtCacheSize(unsigned size);
+      uint64_t getStmtCacheHits() const {return stmtCacheHits;}
+      uint64_t getStmtCacheMisses() const {return stmtCacheMisses;}
+      void resetStmtCacheStats() {stmtCacheHits = stmtCacheMisses = 0;}
+      void clearStmtCache();
+
+      /**
+       * Execute @param sql once per row in a single transaction.  @param bind
+       * binds the parameters of row @param row and returns false when there
+       * are no more rows.  Joins the caller's transaction if one is open,
+       * otherwise any error rolls back every row.
+       *
+       * @return The number of rows executed.
+       */
+      unsigned bulk(const std::string &sql, bind_cb_t bind);
+
+      bool inTransaction() const {return transaction;}
       SmartPointer<Transaction> begin(transaction_t type = DEFERRED,
                                       double timeout = 30);
       void commit();
@@ -0,0 +1,114 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "EventDatabase.h"
+#include "Statement.h"
+
+#include <cbang/Catch.h>
+#include <cbang/json/Builder.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::DB;
+
+
+EventDatabase::EventDatabase(const SmartPointer<Event::ConcurrentPool> &pool,
+                             double timeout, int priority) :
+  db(new Database(timeout)), pool(pool), priority(priority) {}
+
+
+void EventDatabase::submit(run_cb_t run, done_cb_t done) {
+  jobs.push_back(Job{run, done});
+  if (!running) next();
+}
+
+
+void EventDatabase::open(const string &con, done_cb_t done, unsigned flags) {
+  submit([=] (Database &db) {db.open(con, flags);}, done);
+}
+
+
+void EventDatabase::execute(const string &sql, done_cb_t done) {
+  submit([=] (Database &db) {db.execute(sql);}, done);
+}
+
+
+void EventDatabase::query(const string &sql, query_cb_t cb) {
+  auto builder = SmartPtr(new JSON::Builder);
+
+  auto run = [=] (Database &db) {db.compileCached(sql)->readAll(*builder);};
+  auto done = [=] (bool success) {
+    if (cb) cb(success, success ? builder->getRoot() : JSON::ValuePtr());
+  };
+
+  submit(run, done);
+}
+
+
+void EventDatabase::bulk(const string &sql, Database::bind_cb_t bind,
+                         bulk_cb_t cb) {
+  auto rows = SmartPtr(new unsigned(0));
+
+  auto run  = [=] (Database &db) {*rows = db.bulk(sql, bind);};
+  auto done = [=] (bool success) {if (cb) cb(success, *rows);};
+
+  submit(run, done);
+}
+
+
+void EventDatabase::next() {
+  if (jobs.empty()) return;
+
+  Job job = jobs.front();
+  jobs.pop_front();
+  running = true;
+
+  auto db = this->db;
+  auto run = [db, job] () {job.run(*db);};
+
+  auto complete = [this, job] (bool success) {
+    running = false;
+    try {
+      if (job.done) job.done(success);
+    } CATCH_ERROR;
+    next();
+  };
+
+  auto success = [complete] () {complete(true);};
+  auto error = [complete] (const Exception &e) {
+    LOG_WARNING("SQLite job failed: " << e.getMessages());
+    complete(false);
+  };
+
+  pool->submit(priority, run, success, error);
+}
@@ -0,0 +1,99 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Database.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/event/ConcurrentPool.h>
+#include <cbang/json/Value.h>
+
+#include <deque>
+#include <functional>
+
+
+namespace cb {
+  namespace DB {
+    /**
+     * Runs SQLite work for an event loop.  A single connection cannot be
+     * used concurrently, so jobs are queued in FIFO order and handed to the
+     * ConcurrentPool one at a time.  Completion callbacks are called on the
+     * event loop thread.  The EventDatabase must outlive its queued jobs.
+     */
+    class EventDatabase {
+    public:
+      using run_cb_t   = std::function<void (Database &)>;
+      using done_cb_t  = std::function<void (bool)>;
+      using query_cb_t = std::function<void (bool, const JSON::ValuePtr &)>;
+      using bulk_cb_t  = std::function<void (bool, unsigned)>;
+
+    protected:
+      SmartPointer<Database> db;
+      SmartPointer<Event::ConcurrentPool> pool;
+      int priority;
+
+      struct Job {
+        run_cb_t run;
+        done_cb_t done;
+      };
+
+      std::deque<Job> jobs;
+      bool running = false;
+
+    public:
+      EventDatabase(const SmartPointer<Event::ConcurrentPool> &pool,
+                    double timeout = 30, int priority = 0);
+
+      /// Only safe to use directly while no jobs are queued.
+      Database &getDatabase() {return *db;}
+      const SmartPointer<Event::ConcurrentPool> &getPool() const {return pool;}
+
+      unsigned getNumQueued() const {return jobs.size();}
+      bool isBusy() const {return running;}
+
+      void submit(run_cb_t run, done_cb_t done = 0);
+
+      void open(const std::string &con, done_cb_t done,
+                unsigned flags = Database::READ_WRITE | Database::CREATE);
+      void execute(const std::string &sql, done_cb_t done = 0);
+      /// Results are a list of rows, the first holding the column names.
+      void query(const std::string &sql, query_cb_t cb);
+      /// See Database::bulk().  @param bind is called on a pool thread.
+      void bulk(const std::string &sql, Database::bind_cb_t bind,
+                bulk_cb_t cb);
+
+    protected:
+      void next();
+    };
+  }
+}
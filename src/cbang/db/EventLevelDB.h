@@ -37,6 +37,7 @@
 #ifdef HAVE_LEVELDB
 
 #include "LevelDB.h"
+#include "LevelDBWriter.h"
 
 #include <cbang/SmartPointer.h>
 #include <cbang/event/ConcurrentPool.h>
@@ -48,6 +49,7 @@ namespace cb {
   class EventLevelDB : public LevelDB {
     SmartPointer<Event::ConcurrentPool> pool;
     int priority = 0;
+    SmartPointer<LevelDBWriter> writer;
 
   public:
     class Status {
@@ -90,13 +92,31 @@ namespace cb {
     void setPriority(int priority) {this->priority = priority;}
 
 
+    /**
+     * Route commit() through a LevelDBWriter which merges concurrent batches.
+     * Must be called after open().  Namespaces created afterwards share it.
+     */
+    void enableGroupCommit(double maxLatency = 0, unsigned maxBatches = 1000,
+                           unsigned maxBytes = 4 * 1024 * 1024) {
+      writer = new LevelDBWriter(
+        *this, pool, maxLatency, maxBatches, maxBytes, priority);
+    }
+
+
+    const SmartPointer<LevelDBWriter> &getWriter() const {return writer;}
+
+
     EventLevelDB ns(const std::string &name) {
-      return EventLevelDB(LevelDB::ns(name), pool, priority);
+      EventLevelDB db(LevelDB::ns(name), pool, priority);
+      db.writer = writer;
+      return db;
     }
 
 
     EventLevelDB snapshot() {
-      return EventLevelDB(LevelDB::snapshot(), pool, priority);
+      EventLevelDB db(LevelDB::snapshot(), pool, priority);
+      db.writer = writer;
+      return db;
     }
 
 
@@ -175,7 +195,8 @@ namespace cb {
 
     void commit(const SmartPointer<Batch> &batch,
       std::function<void (bool)> cb, int options = 0) {
-      pool->submit([=] () {batch->commit(options);}, cb, priority);
+      if (writer.isSet()) writer->commit(*batch, cb, options);
+      else pool->submit([=] () {batch->commit(options);}, cb, priority);
     }
 
 
@@ -160,6 +160,8 @@ namespace cb {
 
       Batch ns(const std::string &name);
 
+      const leveldb::WriteBatch &getWriteBatch() const {return *batch;}
+
       void clear();
       void set(const std::string &key, const std::string &value);
       void erase(const std::string &key);
@@ -0,0 +1,135 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/config.h>
+
+#ifdef HAVE_LEVELDB
+
+#include "LevelDBWriter.h"
+
+#include <cbang/Catch.h>
+#include <cbang/event/Event.h>
+#include <cbang/log/Logger.h>
+
+#include <leveldb/write_batch.h>
+
+using namespace cb;
+using namespace std;
+
+
+LevelDBWriter::LevelDBWriter(
+  const LevelDB &db, const SmartPointer<Event::ConcurrentPool> &pool,
+  double maxLatency, unsigned maxBatches, unsigned maxBytes, int priority) :
+  db(db), pool(pool), maxLatency(maxLatency), maxBatches(maxBatches),
+  maxBytes(maxBytes), priority(priority) {
+  if (!db.isOpen()) THROW("LevelDB must be open");
+  timer = pool->getEventBase().newEvent([this] {write();}, 0);
+}
+
+
+LevelDBWriter::~LevelDBWriter() {timer->del();}
+
+
+unsigned LevelDBWriter::getNumQueued() const {
+  unsigned count = 0;
+  for (auto &group: groups) count += group->callbacks.size();
+  return count;
+}
+
+
+void LevelDBWriter::commit(
+  const LevelDB::Batch &batch, done_cb_t cb, int options) {
+  if (groups.empty() || isFull(*groups.back())) {
+    groups.push_back(new Group);
+    groups.back()->batch = new leveldb::WriteBatch;
+  }
+
+  Group &group = *groups.back();
+  group.batch->Append(batch.getWriteBatch());
+  group.callbacks.push_back(cb);
+  group.options |= options;
+
+  // Otherwise the group is written when the current write completes
+  if (writing) return;
+
+  if (!maxLatency || isFull(*groups.front())) write();
+  else if (!timer->isPending()) timer->add(maxLatency);
+}
+
+
+void LevelDBWriter::flush() {write();}
+
+
+bool LevelDBWriter::isFull(const Group &group) const {
+  return maxBatches <= group.callbacks.size() ||
+    maxBytes <= group.batch->ApproximateSize();
+}
+
+
+void LevelDBWriter::write(leveldb::WriteBatch &batch, int options) {
+  db.commit(batch, options);
+}
+
+
+void LevelDBWriter::write() {
+  if (writing || groups.empty()) return;
+  timer->del();
+
+  SmartPointer<Group> group = groups.front();
+  groups.pop_front();
+  writing = true;
+
+  auto self = SmartPtr(this);
+  auto run = [self, group] () {self->write(*group->batch, group->options);};
+
+  auto complete = [self, group] (bool success) {
+    self->writing = false;
+    self->writes++;
+    self->batches += group->callbacks.size();
+
+    for (auto &cb: group->callbacks)
+      if (cb) TRY_CATCH_ERROR(cb(success));
+
+    // Batches queued during the write have waited long enough
+    self->write();
+  };
+
+  auto success = [complete] () {complete(true);};
+  auto error = [complete] (const Exception &e) {
+    LOG_WARNING("LevelDB group commit failed: " << e.getMessages());
+    complete(false);
+  };
+
+  pool->submit(priority, run, success, error);
+}
+
+#endif // HAVE_LEVELDB
@@ -0,0 +1,113 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/config.h>
+
+#ifdef HAVE_LEVELDB
+
+#include "LevelDB.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/event/ConcurrentPool.h>
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+
+namespace cb {
+  /**
+   * Group commit for LevelDB batches.  Only one write is in flight at a time.
+   * Batches committed while it runs, or within @param maxLatency seconds of
+   * the first one, are merged into a single WriteBatch and written with one
+   * log write.  The merged write is synced if any of its batches asked for
+   * SYNC.  All callbacks of a group are called together on the event loop
+   * thread, with the same result.
+   */
+  class LevelDBWriter : public RefCounted {
+  public:
+    using done_cb_t = std::function<void (bool)>;
+
+  protected:
+    LevelDB db;
+    SmartPointer<Event::ConcurrentPool> pool;
+    double maxLatency;
+    unsigned maxBatches;
+    unsigned maxBytes;
+    int priority;
+
+    struct Group {
+      SmartPointer<leveldb::WriteBatch> batch;
+      std::vector<done_cb_t> callbacks;
+      int options = 0;
+    };
+
+    std::deque<SmartPointer<Group>> groups;
+    SmartPointer<Event::Event> timer;
+    bool writing = false;
+
+    uint64_t writes = 0;
+    uint64_t batches = 0;
+
+  public:
+    LevelDBWriter(const LevelDB &db,
+                  const SmartPointer<Event::ConcurrentPool> &pool,
+                  double maxLatency = 0, unsigned maxBatches = 1000,
+                  unsigned maxBytes = 4 * 1024 * 1024, int priority = 0);
+    virtual ~LevelDBWriter();
+
+    double getMaxLatency() const {return maxLatency;}
+    unsigned getMaxBatches() const {return maxBatches;}
+    unsigned getMaxBytes() const {return maxBytes;}
+
+    /// Number of LevelDB writes and of batches they carried
+    uint64_t getWrites() const {return writes;}
+    uint64_t getBatches() const {return batches;}
+    unsigned getNumQueued() const;
+
+    /// The batch is copied, so it may be reused once this returns.
+    void commit(const LevelDB::Batch &batch, done_cb_t cb, int options = 0);
+    /// Start writing queued batches now, without waiting for maxLatency.
+    void flush();
+
+  protected:
+    bool isFull(const Group &group) const;
+    /// Called on a pool thread to write a group's merged batches
+    virtual void write(leveldb::WriteBatch &batch, int options);
+    void write();
+  };
+}
+
+#endif // HAVE_LEVELDB
@@ -86,7 +86,7 @@ bool Statement::next() {
 
 void Statement::reset() {
   sqlite3_reset(stmt); // Ignore errors
-  done = false;
+  done = validRow = false;
 }
 
 
@@ -32,12 +32,26 @@
 
 #include "Connector.h"
 
+#include <cbang/Catch.h>
 #include <cbang/config/Options.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
+#include <cbang/json/Sink.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Timer.h>
 
+using namespace std;
 using namespace cb;
 using namespace cb::MariaDB;
 
 
+Connector::Connector(Event::Base &base) :
+  base(base), releaseEvent(base.newEvent([this] {returned();}, 0)),
+  maintainEvent(base.newEvent([this] {maintain();})) {
+  maintainEvent->add(5);
+}
+
+
 void Connector::addOptions(Options &options) {
   options.pushCategory("Database");
   options.addTarget("db-host",    host,     "DB host name");
@@ -46,13 +60,28 @@ void Connector::addOptions(Options &options) {
   options.addTarget("db-name",    database, "DB name");
   options.addTarget("db-port",    port,     "DB port");
   options.addTarget("db-timeout", timeout,  "DB timeout");
+  options.addTarget("db-pool-min", minConnections,
+                    "Minimum number of pooled DB connections");
+  options.addTarget("db-pool-max", maxConnections,
+                    "Maximum number of pooled DB connections");
+  options.addTarget("db-pool-idle-timeout", idleTimeout,
+                    "Seconds before closing an idle pooled DB connection");
+  options.addTarget("db-pool-ping", pingInterval,
+                    "Seconds between health checks of idle DB connections");
+  options.addTarget("db-stmt-cache", stmtCacheSize,
+                    "Prepared statements cached per DB connection");
   options.popCategory();
 }
 
 
 SmartPointer<MariaDB::EventDB> Connector::getConnection() {
-  // TODO Limit the total number of active connections
+  auto db = create();
+  db->connectNB(host, user, password, database, port);
+  return db;
+}
 
+
+SmartPointer<MariaDB::EventDB> Connector::create() {
   auto db = SmartPtr(new MariaDB::EventDB(base));
 
   // Configure
@@ -63,9 +92,188 @@ SmartPointer<MariaDB::EventDB> Connector::getConnection() {
   db->enableNonBlocking();
   db->setCharacterSet("utf8mb4");
   db->setPriority(priority);
-
-  // Connect
-  db->connectNB(host, user, password, database, port);
+  db->setStmtCacheSize(stmtCacheSize);
 
   return db;
 }
+
+
+void Connector::acquire(callback_t cb) {
+  waiters.push_back(Waiter{cb, Timer::now()});
+  if (idle.empty() && maxConnections <= total) queued++;
+  dispatch();
+}
+
+
+void Connector::release(const SmartPointer<EventDB> &db, bool reuse) {
+  if (db.isNull()) return;
+
+  // Deferred, the caller may be inside one of the connection's callbacks
+  released.push_back(Released{db, reuse, true, false, Timer::now()});
+  releaseEvent->activate();
+}
+
+
+void Connector::writeStats(JSON::Sink &sink) const {
+  uint64_t lookups = stmtCacheHits + stmtCacheMisses;
+
+  sink.beginDict();
+  sink.insert("connections", total);
+  sink.insert("active",      active);
+  sink.insert("idle",        idle.size());
+  sink.insert("waiting",     waiters.size());
+  sink.insert("acquired",    acquired);
+  sink.insert("queued",      queued);
+  sink.insert("created",     created);
+  sink.insert("closed",      closed);
+  sink.insert("wait-avg",    acquired ? waitTotal / acquired : 0);
+  sink.insert("wait-max",    waitMax);
+  sink.insert("stmt-cache-hits",   stmtCacheHits);
+  sink.insert("stmt-cache-misses", stmtCacheMisses);
+  sink.insert("stmt-cache-hit-rate",
+              lookups ? (double)stmtCacheHits / lookups : 0);
+  sink.endDict();
+}
+
+
+void Connector::dispatch() {
+  // Callbacks may acquire again, the outer loop will serve them
+  if (dispatching) return;
+  dispatching = true;
+
+  while (!waiters.empty()) {
+    if (idle.empty()) {
+      // Waiters are served by returned() once a connect completes
+      if (connecting < waiters.size() && total < maxConnections) {
+        if (!connect(Timer::now())) fail();
+        continue;
+      }
+
+      break;
+    }
+
+    SmartPointer<EventDB> db = idle.back().db;
+    idle.pop_back();
+
+    Waiter waiter = waiters.front();
+    waiters.pop_front();
+
+    double wait = Timer::now() - waiter.since;
+    waitTotal += wait;
+    if (waitMax < wait) waitMax = wait;
+    acquired++;
+
+    if (db.isSet()) {
+      db->setPriority(priority);
+      active++;
+    }
+
+    try {
+      waiter.cb(db);
+    } catch (const Exception &e) {
+      LOG_ERROR(e);
+      release(db, false);
+    }
+  }
+
+  dispatching = false;
+}
+
+
+void Connector::fail() {
+  if (waiters.empty()) return;
+
+  Waiter waiter = waiters.front();
+  waiters.pop_front();
+  TRY_CATCH_ERROR(waiter.cb(0));
+}
+
+
+void Connector::returned() {
+  double now = Timer::now();
+  vector<Released> list;
+  list.swap(released);
+
+  for (auto &r: list) {
+    if (r.active) active--;
+
+    if (r.failed) fail();
+
+    stmtCacheHits   += r.db->getStmtCacheHits();
+    stmtCacheMisses += r.db->getStmtCacheMisses();
+    r.db->resetStmtCacheStats();
+
+    if (r.reuse && r.db->isConnected() && !r.db->isPending())
+      idle.push_back(Idle{r.db, r.lastUsed, now});
+
+    else {
+      total--;
+      closed++;
+    }
+  }
+
+  dispatch();
+}
+
+
+void Connector::maintain() {
+  double now = Timer::now();
+
+  for (auto it = idle.begin(); it != idle.end();) {
+    if (minConnections < total && idleTimeout < now - it->lastUsed) {
+      LOG_DEBUG(4, "Closing idle DB connection");
+      it = idle.erase(it);
+      total--;
+      closed++;
+
+    } else if (pingInterval < now - it->checked) {
+      check(it->db, it->lastUsed, false);
+      it = idle.erase(it);
+
+    } else it++;
+  }
+
+  // Open up to the minimum in the background
+  while (total < minConnections)
+    if (!connect(now)) break;
+}
+
+
+bool Connector::connect(double lastUsed) {
+  connecting++;
+
+  try {
+    check(create(), lastUsed, true);
+    total++;
+    created++;
+    return true;
+  } CATCH_ERROR;
+
+  connecting--;
+  return false;
+}
+
+
+void Connector::check(const SmartPointer<EventDB> &db, double lastUsed,
+                      bool connect) {
+  EventDB *ptr = db.get();
+  checking[ptr] = Idle{db, lastUsed, 0};
+
+  // The connection's own event holds the callback so capture a raw pointer
+  auto cb = [this, ptr, connect] (EventDB::state_t state) {
+    auto it = checking.find(ptr);
+    if (it == checking.end()) return;
+
+    bool ok = state == EventDB::EVENTDB_DONE;
+    if (!ok) LOG_WARNING("DB connection check failed: " << ptr->getError());
+    if (connect) connecting--;
+
+    auto &c = it->second;
+    released.push_back(Released{c.db, ok, false, connect && !ok, c.lastUsed});
+    checking.erase(it);
+    releaseEvent->activate();
+  };
+
+  if (connect) db->connect(cb, host, user, password, database, port);
+  else db->ping(cb);
+}
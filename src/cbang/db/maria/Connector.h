@@ -36,13 +36,35 @@
 
 #include <cbang/SmartPointer.h>
 
+#include <list>
+#include <map>
+#include <deque>
+#include <vector>
+#include <functional>
+
 
 namespace cb {
   class Options;
+  namespace JSON {class Sink;}
   namespace Event {class Base;}
 
   namespace MariaDB {
+    /***
+     * Creates MariaDB connections and keeps a bounded pool of them.
+     * Pooled connections are handed out in request order with acquire()
+     * and must be returned with release().  Only fully connected
+     * connections are handed out.  If a new connection fails the oldest
+     * waiter is called with null.  Idle connections are pinged
+     * periodically and closed after the idle timeout while more than the
+     * minimum are open.
+     */
     class Connector {
+    public:
+      /// @param db The connection or null if one could not be opened.
+      typedef std::function<void (const SmartPointer<EventDB> &db)>
+      callback_t;
+
+    private:
       Event::Base &base;
 
       std::string user;
@@ -53,8 +75,56 @@ namespace cb {
       unsigned    timeout  = 5;
       int         priority = 0;
 
+      unsigned minConnections = 0;
+      unsigned maxConnections = 32;
+      double   idleTimeout    = 60;
+      double   pingInterval   = 30;
+      unsigned stmtCacheSize  = 32;
+
+      struct Idle {
+        SmartPointer<EventDB> db;
+        double lastUsed;
+        double checked;
+      };
+
+      struct Released {
+        SmartPointer<EventDB> db;
+        bool reuse;
+        bool active;
+        bool failed; // Connect failed
+        double lastUsed;
+      };
+
+      struct Waiter {
+        callback_t cb;
+        double since;
+      };
+
+      std::list<Idle> idle; // Most recently used at the back
+      std::map<EventDB *, Idle> checking; // Pinging or connecting
+      std::vector<Released> released;
+      std::deque<Waiter> waiters;
+
+      unsigned total  = 0; // Open or opening connections
+      unsigned active = 0;
+      unsigned connecting = 0;
+      bool dispatching = false;
+
+      SmartPointer<Event::Event> releaseEvent;
+      SmartPointer<Event::Event> maintainEvent;
+
+      // Stats
+      uint64_t acquired = 0;
+      uint64_t queued   = 0;
+      uint64_t created  = 0;
+      uint64_t closed   = 0;
+      double   waitTotal = 0;
+      double   waitMax   = 0;
+      uint64_t stmtCacheHits   = 0;
+      uint64_t stmtCacheMisses = 0;
+
     public:
-      Connector(Event::Base &base) : base(base) {}
+      Connector(Event::Base &base);
 
       void addOptions(Options &options);
 
@@ -74,7 +144,43 @@ namespace cb {
       void getTimeout (unsigned timeout)            {this->timeout  = timeout;}
       void getPriority(int priority)                {this->priority = priority;}
 
+      unsigned getMinConnections() const {return minConnections;}
+      unsigned getMaxConnections() const {return maxConnections;}
+      double   getIdleTimeout()    const {return idleTimeout;}
+      double   getPingInterval()   const {return pingInterval;}
+      unsigned getStmtCacheSize()  const {return stmtCacheSize;}
+
+      void setMinConnections(unsigned x) {minConnections = x;}
+      void setMaxConnections(unsigned x) {maxConnections = x;}
+      void setIdleTimeout(double x)      {idleTimeout = x;}
+      void setPingInterval(double x)     {pingInterval = x;}
+      void setStmtCacheSize(unsigned x)  {stmtCacheSize = x;}
+
+      unsigned getNumConnections() const {return total;}
+      unsigned getNumActive()      const {return active;}
+      unsigned getNumIdle()        const {return idle.size();}
+      unsigned getNumWaiting()     const {return waiters.size();}
+
+      /// Open a new connection outside of the pool.
       SmartPointer<MariaDB::EventDB> getConnection();
+
+      /// Call @param cb with a pooled connection once one is available.
+      void acquire(callback_t cb);
+      /// Return a connection from acquire().  Pass @param reuse false if
+      /// the connection may be in an unknown state, e.g. after an error.
+      void release(const SmartPointer<EventDB> &db, bool reuse = true);
+
+      void writeStats(JSON::Sink &sink) const;
+
+    private:
+      SmartPointer<EventDB> create();
+      bool connect(double lastUsed);
+      void dispatch();
+      void fail();
+      void returned();
+      void maintain();
+      void check(const SmartPointer<EventDB> &db, double lastUsed,
+                 bool connect);
     };
   }
 }
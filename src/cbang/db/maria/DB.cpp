@@ -39,6 +39,7 @@
 #include <cbang/log/Logger.h>
 
 #include <mysql/mysql.h>
+#include <mysql/mysqld_error.h>
 
 #include <cstring>
 
@@ -106,7 +107,9 @@ DB::DB(st_mysql *db) :
 DB::~DB() {
   LOG_DEBUG(5, CBANG_FUNC << "()");
   freeMeta();
-  if (stmt) mysql_stmt_close(stmt);
+  if (stmt && !stmtCached) mysql_stmt_close(stmt);
+  for (auto &e: stmtLRU) mysql_stmt_close(e.second);
+  for (auto s: stmtClosing) mysql_stmt_close(s);
   if (db) mysql_close(db);
   delete binding;
 }
@@ -391,9 +394,6 @@ bool DB::queryNB(const string &s, const vector<JSON::ValuePtr> &params) {
   assertNotPending();
   assertNonBlocking();
 
-  if (!stmt && !(stmt = mysql_stmt_init(db)))
-    RAISE_DB_ERROR("Failed to allocate statement");
-
   rowReady = false;
 
   // Convert params to bound buffers; nulls bind NULL, booleans bind 1/0
@@ -407,17 +407,138 @@ bool DB::queryNB(const string &s, const vector<JSON::ValuePtr> &params) {
       p->isBoolean() ? string(p->getBoolean() ? "1" : "0") : p->asString());
   }
 
+  stmtSQL = s;
+  stmtReused = false;
+
+  if (stmtCacheSize) {
+    if (stmt && !stmtCached) stmtClosing.push_back(stmt);
+    stmt = 0;
+    stmtCached = false;
+
+    auto it = stmtCache.find(s);
+    if (it != stmtCache.end()) {
+      stmtLRU.splice(stmtLRU.begin(), stmtLRU, it->second);
+      stmt = it->second->second;
+      stmtCached = stmtReused = true;
+      stmtCacheHits++;
+
+    } else stmtCacheMisses++;
+  }
+
+  return closeStmtsNB();
+}
+
+
+void DB::setStmtCacheSize(unsigned size) {
+  if (size == stmtCacheSize) return;
+  clearStmtCache();
+  stmtCacheSize = size;
+}
+
+
+void DB::clearStmtCache() {
+  assertNotPending();
+
+  freeMeta();
+  if (stmt && !stmtCached) mysql_stmt_close(stmt);
+  for (auto &e: stmtLRU) mysql_stmt_close(e.second);
+  for (auto s: stmtClosing) mysql_stmt_close(s);
+
+  stmt = 0;
+  stmtCached = false;
+  stmtLRU.clear();
+  stmtCache.clear();
+  stmtClosing.clear();
+}
+
+
+void DB::discardStmt() {
+  if (!stmt || isPending()) return;
+
+  if (stmtCached) {
+    auto it = stmtCache.find(stmtSQL);
+    if (it != stmtCache.end()) {
+      stmtLRU.erase(it->second);
+      stmtCache.erase(it);
+    }
+  }
+
+  freeMeta();
+  stmtClosing.push_back(stmt);
+  stmt = 0;
+  stmtCached = stmtReused = false;
+}
+
+
+bool DB::closeStmtsNB() {
+  // mysql_stmt_close() may block writing COM_STMT_CLOSE
+  while (!stmtClosing.empty()) {
+    my_bool ret = 0;
+    status = mysql_stmt_close_start(&ret, stmtClosing.back());
+    if (status) {continueFunc = &DB::closeStmtContinue; return false;}
+    stmtClosing.pop_back();
+  }
+
+  return stmtReused ? resetStmtNB() : prepareNB();
+}
+
+
+bool DB::resetStmtNB() {
+  // Drop results and server side state left by the statement's last use
+  my_bool ret = 0;
+  status = mysql_stmt_reset_start(&ret, stmt);
+  if (status) {continueFunc = &DB::resetStmtContinue; return false;}
+
+  return resetStmtDone(ret);
+}
+
+
+bool DB::resetStmtDone(bool failed) {
+  if (!failed) return startExecute();
+
+  // A cached statement is invalidated by reconnects
+  LOG_DEBUG(3, "Re-preparing cached statement: " << getError());
+  discardStmt();
+  return closeStmtsNB();
+}
+
+
+bool DB::prepareNB() {
+  stmtReused = false;
+
+  if (!stmt && !(stmt = mysql_stmt_init(db)))
+    RAISE_DB_ERROR("Failed to allocate statement");
+
   int ret = 0;
-  status = mysql_stmt_prepare_start(&ret, stmt, s.data(), s.length());
+  status =
+    mysql_stmt_prepare_start(&ret, stmt, stmtSQL.data(), stmtSQL.length());
   LOG_DEBUG(5, CBANG_FUNC << "() status=" << status);
 
   if (status) {continueFunc = &DB::prepareContinue; return false;}
   if (ret) RAISE_DB_ERROR("Prepare failed");
 
+  cacheStmt();
   return startExecute();
 }
 
 
+void DB::cacheStmt() {
+  if (!stmtCacheSize || stmtCached) return;
+
+  stmtLRU.push_front(make_pair(stmtSQL, stmt));
+  stmtCache[stmtSQL] = stmtLRU.begin();
+  stmtCached = true;
+
+  // Evict least recently used, never the current statement at the front
+  while (stmtCacheSize < stmtLRU.size()) {
+    auto &e = stmtLRU.back();
+    stmtCache.erase(e.first);
+    stmtClosing.push_back(e.second);
+    stmtLRU.pop_back();
+  }
+}
+
+
 bool DB::startExecute() {
   auto &params = binding->params;
   unsigned count = mysql_stmt_param_count(stmt);
@@ -449,12 +570,28 @@ bool DB::startExecute() {
   status = mysql_stmt_execute_start(&ret, stmt);
 
   if (status) {continueFunc = &DB::executeContinue; return false;}
-  if (ret) RAISE_DB_ERROR("Execute failed");
+  if (ret) return executeFailed();
 
   return true;
 }
 
 
+bool DB::executeFailed() {
+  // A cached statement is invalidated by schema changes and reconnects
+  unsigned err = mysql_stmt_errno(stmt);
+
+  if (stmtReused &&
+      (err == ER_UNKNOWN_STMT_HANDLER || err == ER_NEED_REPREPARE)) {
+    LOG_DEBUG(3, "Re-preparing cached statement: " << getError());
+    discardStmt();
+    return closeStmtsNB();
+  }
+
+  RAISE_DB_ERROR("Execute failed");
+  return false; // Not reached
+}
+
+
 void DB::freeMeta() {if (meta) {mysql_free_result(meta); meta = 0;}}
 
 
@@ -505,6 +642,21 @@ bool DB::storeResultNB() {
 }
 
 
+void DB::useResult() {
+  LOG_DEBUG(5, CBANG_FUNC << "()");
+
+  assertConnected();
+  assertNotPending();
+
+  rowReady = false;
+  freeMeta();
+
+  // Without mysql_stmt_store_result() each fetch reads from the connection
+  meta = mysql_stmt_result_metadata(stmt);
+  if (meta) setupResultBind();
+}
+
+
 bool DB::haveResult() const {return meta;}
 
 
@@ -1073,12 +1225,32 @@ bool DB::useContinue(unsigned ready) {
 }
 
 
+bool DB::closeStmtContinue(unsigned ready) {
+  my_bool ret = 0;
+  status = mysql_stmt_close_cont(&ret, stmtClosing.back(), ready);
+  if (status) return false;
+
+  stmtClosing.pop_back();
+  return closeStmtsNB();
+}
+
+
+bool DB::resetStmtContinue(unsigned ready) {
+  my_bool ret = 0;
+  status = mysql_stmt_reset_cont(&ret, stmt, ready);
+  if (status) return false;
+
+  return resetStmtDone(ret);
+}
+
+
 bool DB::prepareContinue(unsigned ready) {
   int ret = 0;
   status = mysql_stmt_prepare_cont(&ret, stmt, ready);
   if (status) return false;
   if (ret) RAISE_DB_ERROR("Prepare failed");
 
+  cacheStmt();
   return startExecute();
 }
 
@@ -1087,7 +1259,7 @@ bool DB::executeContinue(unsigned ready) {
   int ret = 0;
   status = mysql_stmt_execute_cont(&ret, stmt, ready);
   if (status) return false;
-  if (ret) RAISE_DB_ERROR("Execute failed");
+  if (ret) return executeFailed();
 
   return true;
 }
@@ -39,6 +39,8 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <list>
+#include <unordered_map>
 #include <cstdint>
 
 
@@ -97,6 +99,18 @@ namespace cb {
       st_mysql_res  *meta = 0;     // result-set field metadata
       Binding       *binding = 0;  // bound result-column buffers (PIMPL)
 
+      // Prepared statements keyed by SQL text, most recently used first
+      typedef std::list<std::pair<std::string, st_mysql_stmt *>> stmtLRU_t;
+      stmtLRU_t stmtLRU;
+      std::unordered_map<std::string, stmtLRU_t::iterator> stmtCache;
+      unsigned stmtCacheSize = 32;
+      uint64_t stmtCacheHits = 0;
+      uint64_t stmtCacheMisses = 0;
+      std::string stmtSQL;         // SQL of the current statement
+      bool stmtCached = false;     // stmt is owned by the cache
+      bool stmtReused = false;     // stmt came from the cache
+      std::vector<st_mysql_stmt *> stmtClosing; // Closed before next query
+
       typedef bool (DB::*continue_func_t)(unsigned ready);
 
       bool nonBlocking;
@@ -165,8 +179,21 @@ namespace cb {
       bool queryNB(const std::string &s,
                    const std::vector<JSON::ValuePtr> &params = {});
 
+      // Prepared statement cache.  A size of zero disables caching.
+      unsigned getStmtCacheSize() const {return stmtCacheSize;}
+      void setStmtCacheSize(unsigned size);
+      uint64_t getStmtCacheHits() const {return stmtCacheHits;}
+      uint64_t getStmtCacheMisses() const {return stmtCacheMisses;}
+      void resetStmtCacheStats() {stmtCacheHits = stmtCacheMisses = 0;}
+      void clearStmtCache();
+      /// Drop the current statement, e.g. after an error left it unusable.
+      /// It is closed before the next query runs.
+      void discardStmt();
+
       // Result set
       bool storeResultNB();
+      /// Read rows from the server one fetch at a time instead of buffering
+      void useResult();
       bool haveResult() const;
       bool nextResultNB();
       bool moreResults() const;
@@ -275,7 +302,13 @@ namespace cb {
 
     protected:
       // Prepared-statement helpers
+      bool closeStmtsNB();      // close dropped stmts then prepare or reset
+      bool resetStmtNB();       // reset a cached stmt then execute
+      bool resetStmtDone(bool failed);
+      bool prepareNB();         // prepare stmtSQL then execute
+      void cacheStmt();         // add the prepared stmt to the cache
       bool startExecute();      // bind params + execute (after prepare)
+      bool executeFailed();     // re-prepare stale cached stmts or raise
       void setupResultBind();   // result metadata + bind output columns
       void processFetch();      // pull the fetched row into bound buffers
       void freeMeta();
@@ -287,6 +320,8 @@ namespace cb {
       bool changeUserContinue(unsigned ready);
       bool pingContinue(unsigned ready);
       bool useContinue(unsigned ready);
+      bool closeStmtContinue(unsigned ready);
+      bool resetStmtContinue(unsigned ready);
       bool prepareContinue(unsigned ready);
       bool executeContinue(unsigned ready);
       bool storeResultContinue(unsigned ready);
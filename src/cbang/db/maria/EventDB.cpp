@@ -61,6 +61,13 @@ unsigned EventDB::getEventFlags() const {
 }
 
 
+void EventDB::resumeFetch() {
+  if (!fetchPaused) return;
+  fetchPaused = false;
+  if (event.isSet() && !event->isPending()) rescheduleEvent();
+}
+
+
 void EventDB::connect(callback_t cb, const string &host, const string &user,
                       const string &password, const string &dbName,
                       unsigned port, const string &socketName, flags_t flags) {
@@ -105,10 +112,11 @@ void EventDB::query(callback_t cb, const string &s,
 
 
 void EventDB::query(callback_t cb, const string &s,
-  const vector<JSON::ValuePtr> &params) {
+  const vector<JSON::ValuePtr> &params, bool unbuffered) {
   LOG_DEBUG(5, CBANG_FUNC << "() sql=" << s);
 
-  auto queryCB = SmartPtr(new QueryCallback(*this, cb, s, params));
+  fetchPaused = false;
+  auto queryCB = SmartPtr(new QueryCallback(*this, cb, s, params, unbuffered));
 
   // By wrapping the event callback in a lambda the SmartPointer is kept alive
   auto reply =
@@ -117,6 +125,13 @@ void EventDB::query(callback_t cb, const string &s,
     };
 
   if (isPending() || !queryCB->next()) newEvent(reply);
+
+  else if (queryCB->isResuming()) {
+    // Rows remain but the first batch completed without blocking
+    event = base.newEvent(getSocket(), reply, 0);
+    event->setPriority(priority);
+    if (!fetchPaused) rescheduleEvent();
+  }
 }
 
 
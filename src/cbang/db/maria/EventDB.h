@@ -48,6 +48,7 @@ namespace cb {
       Event::Base &base;
       SmartPointer<Event::Event> event;
       int priority = 0;
+      bool fetchPaused = false;
 
     public:
       typedef enum {
@@ -73,6 +74,11 @@ namespace cb {
 
       unsigned getEventFlags() const;
 
+      /// Stop delivering rows until resumeFetch(), e.g. while output drains
+      void pauseFetch() {fetchPaused = true;}
+      void resumeFetch();
+      bool isFetchPaused() const {return fetchPaused;}
+
       void connect(callback_t cb,
         const std::string &host       = "localhost",
         const std::string &user       = "root",
@@ -113,7 +119,8 @@ namespace cb {
       void query(callback_t cb, const std::string &s,
                  const SmartPointer<const JSON::Value> &dict = 0);
       void query(callback_t cb, const std::string &s,
-                 const std::vector<JSON::ValuePtr> &params);
+                 const std::vector<JSON::ValuePtr> &params,
+                 bool unbuffered = false);
 
       template <class T>
       void query(T *obj, typename Callback<T>::member_t member,
@@ -45,8 +45,9 @@ using namespace cb::MariaDB;
 QueryCallback::QueryCallback(EventDB &db, EventDB::callback_t cb,
                              const string &query,
                              const vector<JSON::ValuePtr> &params,
-                             unsigned retry) :
-  db(db), cb(cb), query(query), params(params), retry(retry) {}
+                             bool unbuffered, unsigned retry) :
+  db(db), cb(cb), query(query), params(params), retry(retry),
+  unbuffered(unbuffered) {}
 
 
 void QueryCallback::call(EventDB::state_t state) {
@@ -73,7 +74,8 @@ bool QueryCallback::next() {
 
   case STATE_QUERY:
     state = STATE_STORE;
-    if (!db.storeResultNB()) return false;
+    if (unbuffered) db.useResult();
+    else if (!db.storeResultNB()) return false;
 
   case STATE_STORE:
     if (!db.haveResult()) {
@@ -89,7 +91,7 @@ bool QueryCallback::next() {
   case STATE_FETCH:
     // Limit number of rows processed per event
     unsigned i;
-    for (i = 0; i < 1000 && db.haveRow(); i++) {
+    for (i = 0; i < 1000 && db.haveRow() && !db.isFetchPaused(); i++) {
       call(EventDB::EVENTDB_ROW);
       if (!db.fetchRowNB()) return false;
     }
@@ -128,7 +130,11 @@ void QueryCallback::operator()(Event::Event &, int, unsigned flags) {
     if (resume || db.continueNB(db.eventFlagsToDBReady(flags))) {
       resume = false;
       if (!next()) return db.renewEvent();
-      if (resume)  return db.rescheduleEvent();
+      if (resume) {
+        // Keep the event, resumeFetch() reschedules it
+        if (db.isFetchPaused()) return;
+        return db.rescheduleEvent();
+      }
       // The operation is still pending; the wait flags may have changed
       // (e.g. a large write blocked), so renew rather than re-add.
     } else return db.renewEvent();
@@ -144,6 +150,9 @@ void QueryCallback::operator()(Event::Event &, int, unsigned flags) {
     } else {
       LOG_DEBUG(5, e);
       call(EventDB::EVENTDB_ERROR);
+
+      // The statement may hold unread results
+      TRY_CATCH_ERROR(db.discardStmt());
     }
   }
 
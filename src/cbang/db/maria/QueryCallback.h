@@ -43,6 +43,7 @@ namespace cb {
       std::string query;
       std::vector<JSON::ValuePtr> params;
       unsigned retry;
+      bool unbuffered;
       bool resume = false;
 
       typedef enum {
@@ -60,7 +61,10 @@ namespace cb {
     public:
       QueryCallback(EventDB &db, EventDB::callback_t cb,
         const std::string &query,
-        const std::vector<JSON::ValuePtr> &params = {}, unsigned retry = 5);
+        const std::vector<JSON::ValuePtr> &params = {},
+        bool unbuffered = false, unsigned retry = 5);
+
+      bool isResuming() const {return resume;}
 
       void call(EventDB::state_t state);
       bool next();
@@ -34,6 +34,8 @@
 
 #include <cbang/log/Logger.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace cb;
 using namespace cb::Event;
@@ -55,3 +57,24 @@ void AsyncSubprocess::setArgs(const string &cmd) {
 
 
 void AsyncSubprocess::exec() {Subprocess::exec(args, flags);}
+
+
+bool AsyncSubprocess::isCapturing(unsigned pipe) {
+  return outputLimit && getPipe(pipe).isOpen();
+}
+
+
+int AsyncSubprocess::readOutput(unsigned pipe) {
+  auto handle = getPipe(pipe).getHandle();
+  Buffer &buf = output[pipe - 1];
+  uint64_t length = buf.getLength();
+
+  if (length < outputLimit)
+    return buf.read(handle, min<uint64_t>(outputLimit - length, 1 << 16));
+
+  // Over the limit, keep draining the pipe so the child does not block
+  Buffer discard;
+  int bytes = discard.read(handle, 1 << 16);
+  if (0 < bytes) dropped[pipe - 1] += bytes;
+  return bytes;
+}
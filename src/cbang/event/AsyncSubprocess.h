@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include "Buffer.h"
+
 #include <cbang/os/Subprocess.h>
 #include <cbang/time/Time.h>
 
@@ -45,6 +47,11 @@ namespace cb {
       unsigned flags;
       int priority;
       uint64_t ts = cb::Time();
+      std::string group;
+
+      uint64_t outputLimit = 0;
+      Buffer output[2];
+      uint64_t dropped[2] = {0, 0};
 
     public:
       AsyncSubprocess(
@@ -62,6 +69,25 @@ namespace cb {
       int getPriority() const {return priority;}
       void setPriority(int priority) {this->priority = priority;}
 
+      // SubprocessPool shares launches fairly between groups
+      const std::string &getGroup() const {return group;}
+      void setGroup(const std::string &group) {this->group = group;}
+
+      // With a non-zero limit, SubprocessPool streams redirected stdout and
+      // stderr into the output buffers, keeping at most ``limit`` bytes of
+      // each and discarding the rest.
+      uint64_t getOutputLimit() const {return outputLimit;}
+      void setOutputLimit(uint64_t limit) {outputLimit = limit;}
+      bool isCapturing(unsigned pipe);
+
+      Buffer &getOutput() {return output[0];}
+      Buffer &getError()  {return output[1];}
+      uint64_t getOutputDropped() const {return dropped[0];}
+      uint64_t getErrorDropped()  const {return dropped[1];}
+
+      // Reads from pipe 1 or 2 into its buffer, returns like Buffer::read()
+      int readOutput(unsigned pipe);
+
       virtual void exec();
       virtual void done() {}
 
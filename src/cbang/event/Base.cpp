@@ -33,6 +33,7 @@
 #include "Base.h"
 #include "Event.h"
 #include "FDPool.h"
+#include "FileWatcher.h"
 
 #include <event2/thread.h>
 #include <event2/event.h>
@@ -80,6 +81,8 @@ Base::~Base() {
   // Must be released before base is freed
   dns.release();
   pool.release();
+  if (watcher.isSet()) watcher->close(); // May be shared
+  watcher.release();
 
   if (base) event_base_free(base);
 }
@@ -99,6 +102,13 @@ FDPool &Base::getPool() {
 }
 
 
+FileWatcher &Base::getFileWatcher() {
+  if (deallocating) THROW("Base deallocating");
+  if (watcher.isNull()) watcher = new FileWatcher(*this);
+  return *watcher;
+}
+
+
 void Base::initPriority(int num) {
   if (event_base_priority_init(base, num))
     THROW("Failed to init event base priority");
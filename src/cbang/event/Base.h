@@ -45,6 +45,7 @@ namespace cb {
   namespace Event {
     class Event;
     class FDPool;
+    class FileWatcher;
 
     class Base : public EventFactory {
       static bool _threadsEnabled;
@@ -54,6 +55,7 @@ namespace cb {
 
       SmartPointer<DNS::Base> dns;
       SmartPointer<FDPool> pool;
+      SmartPointer<FileWatcher> watcher;
 
     public:
       Base(bool withThreads = true, int priorities = -1);
@@ -64,6 +66,7 @@ namespace cb {
 
       DNS::Base &getDNS();
       FDPool &getPool();
+      FileWatcher &getFileWatcher();
 
       void initPriority(int num);
       bool hasPriorities() const {return 1 < getNumPriorities();}
@@ -295,6 +295,28 @@ void Buffer::add(const char *data, unsigned length) {
 }
 
 
+void Buffer::addRef(const char *data, unsigned length) {
+  if (evbuffer_add_reference(evb, data, length, 0, 0))
+    THROW("Buffer add reference failed");
+}
+
+
+void Buffer::addRef(const char *data, unsigned length, function<void ()> cb) {
+  auto cleanup = [] (const void *data, size_t length, void *arg) {
+    auto cb = (function<void ()> *)arg;
+    TRY_CATCH_ERROR((*cb)());
+    delete cb;
+  };
+
+  auto arg = new function<void ()>(cb);
+
+  if (evbuffer_add_reference(evb, data, length, cleanup, arg)) {
+    delete arg;
+    THROW("Buffer add reference failed");
+  }
+}
+
+
 void Buffer::add(const char *s) {add(s, strlen(s));}
 void Buffer::add(const string &s) {add(s.data(), s.length());}
 
@@ -331,7 +353,12 @@ void Buffer::callback(int added, int deleted, int orig) {
 }
 
 
-int Buffer::indexOf(const string &s) const {
-  auto ptr = evbuffer_search(evb, s.data(), s.length(), 0);
-  return ptr.pos;
+int Buffer::indexOf(const string &s, unsigned start) const {
+  if (!start) return evbuffer_search(evb, s.data(), s.length(), 0).pos;
+
+  // Search begins at the chain containing start and uses memchr() on the
+  // first character, so only the bytes after start are examined
+  evbuffer_ptr pos;
+  if (evbuffer_ptr_set(evb, &pos, start, EVBUFFER_PTR_SET)) return -1;
+  return evbuffer_search(evb, s.data(), s.length(), &pos).pos;
 }
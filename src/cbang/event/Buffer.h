@@ -117,6 +117,10 @@ namespace cb {
       void add(const Buffer &buf);
       void addRef(const Buffer &buf);
       void add(const char *data, unsigned length);
+      /// Add @param data without copying, it must outlive the buffer
+      void addRef(const char *data, unsigned length);
+      /// Add @param data without copying, @param cb is called when released
+      void addRef(const char *data, unsigned length, std::function<void ()> cb);
       void add(const char *s);
       void add(const std::string &s);
       void addFile(const std::string &path);
@@ -128,7 +132,8 @@ namespace cb {
 
       void callback(int added, int deleted, int orig);
 
-      int indexOf(const std::string &s) const;
+      /// @return the offset of @param s at or after @param start or -1
+      int indexOf(const std::string &s, unsigned start = 0) const;
     };
   }
 }
@@ -0,0 +1,164 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "DirectoryWatcher.h"
+
+#include <cbang/os/ParallelDirectoryWalker.h>
+#include <cbang/log/Logger.h>
+
+#include <vector>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+namespace {
+  const unsigned dirEvents =
+    FileWatcher::FW_CREATE | FileWatcher::FW_DELETE |
+    FileWatcher::FW_CLOSE_WRITE | FileWatcher::FW_MOVED_FROM |
+    FileWatcher::FW_MOVED_TO;
+
+
+  string joinPath(const string &dir, const string &name) {
+    if (!dir.empty() && dir[dir.length() - 1] == '/') return dir + name;
+    return dir + "/" + name;
+  }
+}
+
+
+DirectoryWatcher::DirectoryWatcher(Base &base, const string &root,
+                                   callback_t cb, const string &pattern) :
+  watcher(base), root(root), matcher(pattern), cb(cb) {
+  while (1 < this->root.length() && this->root[this->root.length() - 1] == '/')
+    this->root.resize(this->root.length() - 1);
+
+  watch(this->root, false);
+}
+
+
+const char *DirectoryWatcher::toString(change_t change) {
+  switch (change) {
+  case DW_ADDED:    return "added";
+  case DW_REMOVED:  return "removed";
+  case DW_MODIFIED: return "modified";
+  case DW_RESYNC:   return "resync";
+  }
+
+  return "unknown";
+}
+
+
+void DirectoryWatcher::watch(const string &dir, bool report) {
+  // Watch first so nothing created during the walk is missed
+  watchDir(dir);
+
+  vector<string> files;
+  ParallelDirectoryWalker walker("*", ~0, true);
+
+  walker.walk(dir, [&] (const ParallelDirectoryWalker::entries_t &entries) {
+    for (auto &e: entries)
+      if (e.isDir) watchDir(e.path);
+      else if (report) files.push_back(e.path);
+  });
+
+  for (auto &path: files) {
+    string::size_type i = path.rfind('/');
+    string name = i == string::npos ? path : path.substr(i + 1);
+    if (matcher.match(name)) cb(DW_ADDED, path);
+  }
+}
+
+
+void DirectoryWatcher::watchDir(const string &dir) {
+  if (dirs.find(dir) != dirs.end()) return;
+
+  try {
+    dirs[dir] = watcher.add(dir, dirEvents, [this, dir] (
+      unsigned events, const string &name) {changed(dir, events, name);});
+
+  } catch (const Exception &e) {
+    // The directory may already be gone
+    LOG_WARNING(e.getMessage());
+  }
+}
+
+
+void DirectoryWatcher::unwatch(const string &dir) {
+  auto it = dirs.lower_bound(dir);
+
+  while (it != dirs.end() && it->first.compare(0, dir.length(), dir) == 0 &&
+         (it->first.length() == dir.length() ||
+          it->first[dir.length()] == '/')) {
+    watcher.remove(it->second);
+    it = dirs.erase(it);
+  }
+}
+
+
+void DirectoryWatcher::changed(const string &dir, unsigned events,
+                               const string &name) {
+  typedef FileWatcher FW;
+
+  if (events & FW::FW_OVERFLOW) {
+    cb(DW_RESYNC, root);
+    return;
+  }
+
+  if (events & FW::FW_IGNORED) {
+    // The kernel dropped the watch; the directory was deleted or unmounted
+    auto it = dirs.find(dir);
+    if (it != dirs.end()) dirs.erase(it);
+    return;
+  }
+
+  if (name.empty()) return;
+
+  string path = joinPath(dir, name);
+
+  if (events & FW::FW_ISDIR) {
+    if (events & (FW::FW_CREATE | FW::FW_MOVED_TO)) watch(path, true);
+
+    if (events & (FW::FW_DELETE | FW::FW_MOVED_FROM)) {
+      unwatch(path);
+      cb(DW_REMOVED, path);
+    }
+
+    return;
+  }
+
+  if (!matcher.match(name)) return;
+
+  if (events & (FW::FW_CREATE | FW::FW_MOVED_TO)) cb(DW_ADDED, path);
+  if (events & FW::FW_CLOSE_WRITE) cb(DW_MODIFIED, path);
+  if (events & (FW::FW_DELETE | FW::FW_MOVED_FROM)) cb(DW_REMOVED, path);
+}
@@ -0,0 +1,87 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "FileWatcher.h"
+
+#include <cbang/util/GlobMatcher.h>
+
+#include <map>
+#include <string>
+#include <functional>
+
+
+namespace cb {
+  namespace Event {
+    /***
+     * Watches a directory tree and reports files added, removed or
+     * modified under it.  New subdirectories are watched as they appear
+     * and the files already in them are reported as added.  Only file
+     * names matching the glob are reported, except for removed
+     * directories which are always reported so cached entries under them
+     * can be dropped.  DW_RESYNC means events were lost and the tree
+     * should be rescanned.
+     */
+    class DirectoryWatcher {
+    public:
+      enum change_t {DW_ADDED, DW_REMOVED, DW_MODIFIED, DW_RESYNC};
+
+      typedef std::function<void (change_t change, const std::string &path)>
+      callback_t;
+
+    protected:
+      FileWatcher watcher;
+      std::string root;
+      GlobMatcher matcher;
+      callback_t cb;
+
+      std::map<std::string, unsigned> dirs;
+
+    public:
+      DirectoryWatcher(Base &base, const std::string &root, callback_t cb,
+                       const std::string &pattern = "*");
+
+      const std::string &getRoot() const {return root;}
+      unsigned getNumDirs() const {return dirs.size();}
+
+      static const char *toString(change_t change);
+
+    protected:
+      void watch(const std::string &dir, bool report);
+      void watchDir(const std::string &dir);
+      void unwatch(const std::string &dir);
+      void changed(const std::string &dir, unsigned events,
+                   const std::string &name);
+    };
+  }
+}
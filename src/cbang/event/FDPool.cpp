@@ -32,6 +32,7 @@
 
 #include "FDPool.h"
 #include "FDPoolEPoll.h"
+#include "FDPoolIOUring.h"
 #include "FDPoolEvent.h"
 
 #include <cbang/os/SystemUtilities.h>
@@ -43,6 +44,7 @@ using namespace cb;
 SmartPointer<FDPool> FDPool::create(Base &base) {
   const char *type = SystemUtilities::getenv("CBANG_EVENT_POOL");
 
+  // io_uring must be selected explicitly
   if (!type) {
 #ifdef HAVE_EPOLL
     type = "epoll";
@@ -57,5 +59,12 @@ SmartPointer<FDPool> FDPool::create(Base &base) {
   if (String::toLower(type) == "epoll") return new FDPoolEPoll(base);
 #endif
 
+#if defined(HAVE_EPOLL) && defined(HAVE_IO_URING)
+  if (String::toLower(type) == "io_uring") {
+    if (!FDPoolIOUring::isSupported()) THROW("io_uring is not supported");
+    return new FDPoolIOUring(base);
+  }
+#endif
+
   THROW("Unsupported event pool type: " << type);
 }
@@ -112,14 +112,13 @@ void FDPoolEPoll::FDQueue::updateTimeout(bool wasActive, bool nowActive) {
   if (!nowActive || closed) last = 0;
   else if (!wasActive) {
     last = Time::now();
-
-    if (getTimeout())
-      fdr.getPool().queueTimeout(getNextTimeout(), read, fdr.getFD());
+    if (getTimeout()) queueTimeout();
   }
 }
 
 
 void FDPoolEPoll::FDQueue::timeout(uint64_t now) {
+  timeoutQueued = false;
   if (!getNextTimeout() || closed) return;
 
   if (getNextTimeout() < now) {
@@ -128,7 +127,7 @@ void FDPoolEPoll::FDQueue::timeout(uint64_t now) {
     close();
     timedout = true;
 
-  } else fdr.getPool().queueTimeout(getNextTimeout(), read, fdr.getFD());
+  } else queueTimeout();
 }
 
 
@@ -140,7 +139,7 @@ void FDPoolEPoll::FDQueue::transfer() {
   if (newTransfer) {
     newTransfer = false;
     cmd_t cmd = read ? CMD_READ_SIZE : CMD_WRITE_SIZE;
-    pool.queueProgress(cmd, fdr.getFD(), Time::now(), front()->getLength());
+    pool.queueProgress(fdr, cmd, Time::now(), front()->getLength());
   }
 
   int ret = front()->transfer();
@@ -150,12 +149,12 @@ void FDPoolEPoll::FDQueue::transfer() {
     last = Time::now();
 
     cmd_t cmd = read ? CMD_READ_PROGRESS : CMD_WRITE_PROGRESS;
-    pool.queueProgress(cmd, fdr.getFD(), last, ret);
+    pool.queueProgress(fdr, cmd, last, ret);
 
     if (front()->isFinished()) {
       cmd = read ? CMD_READ_FINISHED : CMD_WRITE_FINISHED;
-      pool.queueProgress(cmd, fdr.getFD(), last, front()->getLength());
-      pool.queueComplete(front());
+      pool.queueProgress(fdr, cmd, last, front()->getLength());
+      pool.queueComplete(fdr, front());
       pop();
     }
   }
@@ -168,30 +167,39 @@ void FDPoolEPoll::FDQueue::transferPending() {
 
 
 void FDPoolEPoll::FDQueue::flush() {
-  while (!empty()) pop();
+  clear();
+  newTransfer = true;
   closed = timedout = false;
   last = 0;
 }
 
 
 void FDPoolEPoll::FDQueue::add(const SmartPointer<Transfer> &tran) {
-  if (closed) fdr.getPool().queueComplete(tran);
+  if (closed) fdr.getPool().queueComplete(fdr, tran);
   else push(tran);
 }
 
 
+void FDPoolEPoll::FDQueue::queueTimeout() {
+  // At most one entry per queue in the pool's timeout heap
+  if (timeoutQueued) return;
+  timeoutQueued = true;
+  fdr.getPool().queueTimeout(getNextTimeout(), read, fdr.getFD());
+}
+
+
 void FDPoolEPoll::FDQueue::close() {
   closed = true;
 
   while (!empty()) {
-    fdr.getPool().queueComplete(front());
+    fdr.getPool().queueComplete(fdr, front());
     pop();
   }
 }
 
 
 void FDPoolEPoll::FDQueue::pop() {
-  queue<SmartPointer<Transfer> >::pop();
+  RingQueue<SmartPointer<Transfer> >::pop();
   newTransfer = true;
 }
 
@@ -202,6 +210,15 @@ FDPoolEPoll::FDRec::FDRec(FDPoolEPoll &pool, int fd) :
   pool(pool), fd(fd), readQ(*this, true), writeQ(*this, false) {}
 
 
+void FDPoolEPoll::FDRec::reset(uint32_t gen) {
+  // The fd number was reused, drop state left by the previous user
+  readQ.flush();
+  writeQ.flush();
+  this->gen = gen;
+  update();
+}
+
+
 void FDPoolEPoll::FDRec::timeout(uint64_t now, bool read) {
   (read ? readQ : writeQ).timeout(now);
 }
@@ -242,14 +259,14 @@ void FDPoolEPoll::FDRec::transfer(unsigned events) {
 void FDPoolEPoll::FDRec::flush() {
   readQ.flush();
   writeQ.flush();
-  pool.queueFlushed(fd);
+  pool.queueFlushed(*this);
 }
 
 
 void FDPoolEPoll::FDRec::process(cmd_t cmd,
                                  const SmartPointer<Transfer> &tran) {
   if ((cmd == CMD_READ || cmd == CMD_WRITE) && tran->isFinished())
-    return pool.queueComplete(tran);
+    return pool.queueComplete(*this, tran);
 
   switch (cmd) {
   case CMD_READ:  readQ.add(tran);  break;
@@ -268,15 +285,7 @@ void FDPoolEPoll::FDRec::update() {
   unsigned newEvents = getEvents();
   if (events == newEvents) return;
 
-  struct epoll_event ev;
-  memset(&ev, 0, sizeof(ev));
-  ev.events = fd_to_epoll_events(newEvents);
-  ev.data.fd = fd;
-  int op = events ? (newEvents ? EPOLL_CTL_MOD : EPOLL_CTL_DEL) : EPOLL_CTL_ADD;
-
-  if (epoll_ctl(pool.getFD(), op, fd, &ev) && op != EPOLL_CTL_DEL)
-    LOG_ERROR("epoll_ctl(" << epollOpString(op) << ") failed for fd " << fd
-              << ": " << SysError());
+  pool.setEvents(fd, events, newEvents);
 
   // Update timeouts
   readQ .updateTimeout(events & FD::READ_EVENT,  newEvents & FD::READ_EVENT);
@@ -289,11 +298,12 @@ void FDPoolEPoll::FDRec::update() {
 
 
 /******************************************************************************/
-FDPoolEPoll::FDPoolEPoll(Base &base) :
+FDPoolEPoll::FDPoolEPoll(Base &base, bool epoll) :
   event(base.newEvent([this] {processResults();})) {
+  if (!epoll) return;
 
   fd = epoll_create1(EPOLL_CLOEXEC);
-  if (!fd) THROW("Failed to create epoll");
+  if (fd == -1) THROW("Failed to create epoll: " << SysError());
   start();
 }
 
@@ -322,49 +332,53 @@ void FDPoolEPoll::write(const SmartPointer<Transfer> &t) {
 
 void FDPoolEPoll::open(FD &fd) {
   if (fd.getFD() < 0) THROW("Invalid fd " << fd.getFD());
-  if (!fds.insert(fds_t::value_type(fd.getFD(), &fd)).second)
-    THROW("FD " << fd.getFD() << " already in pool");
+
+  Slot &slot = getSlot(fd.getFD());
+  if (slot.fd) THROW("FD " << fd.getFD() << " already in pool");
+
+  slot.fd = &fd;
+  slot.gen++;
 }
 
 
 void FDPoolEPoll::flush(int fd) {
   if (fd < 0) THROW("Invalid fd " << fd);
-  if (flushing.find(fd) != flushing.end())
-    THROW("FD " << fd << " already flushing");
 
-  flushing.insert(fd);
+  Slot &slot = getSlot(fd);
+  if (slot.flushing) THROW("FD " << fd << " already flushing");
+
+  slot.flushing = true;
   queueCommand(CMD_FLUSH, fd, 0);
 }
 
 
 void FDPoolEPoll::queueTimeout(uint64_t time, bool read, int fd) {
-  if (inTimeoutQ.find({fd, read}) == inTimeoutQ.end()) {
-    inTimeoutQ.insert({fd, read});
-    timeoutQ.push({time, read, fd});
-  }
+  timeoutQ.push({time, read, fd});
 }
 
 
-void FDPoolEPoll::queueComplete(const SmartPointer<Transfer> &t) {
-  results.push({CMD_COMPLETE, t->getFD(), t, 0, 0});
+void FDPoolEPoll::queueComplete(const FDRec &fdr,
+                                const SmartPointer<Transfer> &t) {
+  results.push({CMD_COMPLETE, fdr.getFD(), fdr.getGen(), t, 0, 0});
   queuedResults = true;
 }
 
 
-void FDPoolEPoll::queueFlushed(int fd) {
-  results.push({CMD_FLUSHED, fd, 0, 0, 0});
+void FDPoolEPoll::queueFlushed(const FDRec &fdr) {
+  results.push({CMD_FLUSHED, fdr.getFD(), fdr.getGen(), 0, 0, 0});
   queuedResults = true;
 }
 
 
-void FDPoolEPoll::queueProgress(cmd_t cmd, int fd, uint64_t time, int value) {
-  results.push({cmd, fd, 0, time, value});
+void FDPoolEPoll::queueProgress(const FDRec &fdr, cmd_t cmd, uint64_t time,
+                                int value) {
+  results.push({cmd, fdr.getFD(), fdr.getGen(), 0, time, value});
   queuedResults = true;
 }
 
 
-void FDPoolEPoll::queueStatus(int fd, int status) {
-  results.push({CMD_STATUS, fd, 0, 0, status});
+void FDPoolEPoll::queueStatus(const FDRec &fdr, int status) {
+  results.push({CMD_STATUS, fdr.getFD(), fdr.getGen(), 0, 0, status});
   queuedResults = true;
 }
 
@@ -372,15 +386,57 @@ void FDPoolEPoll::queueStatus(int fd, int status) {
 void FDPoolEPoll::queueCommand(cmd_t cmd, int fd,
                                const SmartPointer<Transfer> &tran) {
   LOG_DEBUG(5, CBANG_FUNC << "() fd=" << fd << " cmd=" << cmd);
-  cmds.push({cmd, fd, tran});
+  cmds.push({cmd, fd, getSlot(fd).gen, tran});
+}
+
+
+void FDPoolEPoll::setEvents(int fd, unsigned oldEvents, unsigned newEvents) {
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = fd_to_epoll_events(newEvents);
+  ev.data.fd = fd; // The fd is also the index of its FDRec
+  int op = oldEvents ? (newEvents ? EPOLL_CTL_MOD : EPOLL_CTL_DEL) :
+    EPOLL_CTL_ADD;
+
+  if (epoll_ctl(this->fd, op, fd, &ev) && op != EPOLL_CTL_DEL)
+    LOG_ERROR("epoll_ctl(" << epollOpString(op) << ") failed for fd " << fd
+              << ": " << SysError());
+}
+
+
+unsigned FDPoolEPoll::wait(Ready *ready, unsigned size, int timeout) {
+  epoll_event records[1024];
+  int count = epoll_wait(fd, records, min(size, 1024U), timeout);
+
+  if (count == -1) {
+    if (errno == EINTR) return 0;
+    THROW("epoll_wait() failed: " << SysError());
+  }
+
+  for (int i = 0; i < count; i++) {
+    ready[i].fd     = records[i].data.fd;
+    ready[i].events = epoll_to_fd_events(records[i].events);
+  }
+
+  return count;
+}
+
+
+FDPoolEPoll::Slot &FDPoolEPoll::getSlot(int fd) {
+  if (fd < 0) THROW("Invalid fd " << fd);
+  if (slots.size() <= (unsigned)fd) slots.resize(fd + 1);
+  return slots[fd];
 }
 
 
 FDPoolEPoll::FDRec &FDPoolEPoll::getFD(int fd) {
-  auto it = pool.find(fd);
-  if (it != pool.end()) return *it->second;
-  auto result = pool.insert(pool_t::value_type(fd, new FDRec(*this, fd)));
-  return *result.first->second;
+  if (fd < 0) THROW("Invalid fd " << fd);
+  if (pool.size() <= (unsigned)fd) pool.resize(fd + 1);
+
+  auto &fdr = pool[fd];
+  if (fdr.isNull()) fdr = new FDRec(*this, fd);
+
+  return *fdr;
 }
 
 
@@ -389,25 +445,22 @@ void FDPoolEPoll::processResults() {
     auto &cmd = results.top();
     LOG_DEBUG(5, CBANG_FUNC << "() fd=" << cmd.fd << " cmd=" << cmd.cmd);
 
-    auto it = fds.find(cmd.fd);
-    if (it == fds.end()) {
-      results.pop();
-      continue;
-    }
+    Slot *slot = (unsigned)cmd.fd < slots.size() ? &slots[cmd.fd] : 0;
 
-    FD &fd = *it->second;
-
-    // Drop results from flushing FDs
-    if (flushing.find(cmd.fd) != flushing.end() && cmd.cmd != CMD_FLUSHED) {
+    // Drop results for closed or reused FDs and from flushing FDs
+    if (!slot || !slot->fd || slot->gen != cmd.gen ||
+        (slot->flushing && cmd.cmd != CMD_FLUSHED)) {
       results.pop();
       continue;
     }
 
+    FD &fd = *slot->fd;
+
     switch (cmd.cmd) {
     case CMD_FLUSHED:
       Socket::close(cmd.fd);
-      flushing.erase(cmd.fd);
-      fds.erase(cmd.fd);
+      slot->flushing = false;
+      slot->fd = 0;
       break;
 
     case CMD_COMPLETE: TRY_CATCH_ERROR(cmd.tran->complete()); break;
@@ -439,13 +492,15 @@ void FDPoolEPoll::processResults() {
 
 
 void FDPoolEPoll::run() {
-  epoll_event records[1024];
-  unordered_map<int, int> changed;
+  Ready ready[1024];
 
   while (!shouldShutdown()) {
-    int count = epoll_wait(this->fd, records, 1024, 100);
-    if (count == -1 && errno != EINTR) {
-      LOG_ERROR("epoll_wait() failed");
+    unsigned count;
+
+    try {
+      count = wait(ready, 1024, 100);
+    } catch (const Exception &e) {
+      LOG_ERROR(e.getMessage());
       break;
     }
 
@@ -456,19 +511,22 @@ void FDPoolEPoll::run() {
     int oldStatus = fd.getStatus();                                     \
     STMT;                                                               \
     int newStatus = fd.getStatus();                                     \
-    if (oldStatus != newStatus) changed[fd.getFD()] = newStatus;
+    if (oldStatus != newStatus && !fd.isChanged()) {                    \
+      fd.setChanged(true);                                              \
+      changed.push_back(fd.getFD());                                    \
+    }
 
-    for (int i = 0; i < count; i++)
+    for (unsigned i = 0; i < count; i++)
       try {
-        unsigned events = epoll_to_fd_events(records[i].events);
-        auto &fd        = getFD(records[i].data.fd);
-        CHECK_STATUS(fd.transfer(events));
+        auto &fd = getFD(ready[i].fd);
+        CHECK_STATUS(fd.transfer(ready[i].events));
       } CATCH_ERROR;
 
     // Process pending commands
     while (!cmds.empty()) {
       auto &cmd = cmds.top();
       auto &fd  = getFD(cmd.fd);
+      if (fd.getGen() != cmd.gen) fd.reset(cmd.gen);
       CHECK_STATUS(fd.process(cmd.cmd, cmd.tran));
       cmds.pop();
     }
@@ -478,18 +536,17 @@ void FDPoolEPoll::run() {
     while (!timeoutQ.empty() && timeoutQ.top().time < now) {
       auto t = timeoutQ.top();
       timeoutQ.pop();
-      inTimeoutQ.erase({t.fd, t.read});
 
-      auto it = pool.find(t.fd);
-      if (it != pool.end()) {
-        auto &fd = *it->second;
-        CHECK_STATUS(fd.timeout(now, t.read));
-      }
+      auto &fd = *pool[t.fd];
+      CHECK_STATUS(fd.timeout(now, t.read));
     }
 
     // Queue status changes
-    for (auto p: changed)
-      queueStatus(p.first, p.second);
+    for (int i : changed) {
+      auto &fd = *pool[i];
+      fd.setChanged(false);
+      queueStatus(fd, fd.getStatus());
+    }
 
     // Trigger the event once here to avoid expensive repeated calls
     if (queuedResults) event->activate();
@@ -41,9 +41,9 @@
 
 #include <cbang/thread/Thread.h>
 #include <cbang/util/SPSCQueue.h>
+#include <cbang/util/RingQueue.h>
 
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 #include <queue>
 
 
@@ -69,26 +69,12 @@ namespace cb {
       struct Command {
         cmd_t cmd;
         int fd;
+        uint32_t gen;
         SmartPointer<Transfer> tran;
         uint64_t time;
         int value;
       };
 
-      struct TimeoutMember {
-        int fd;
-        bool read;
-
-        bool operator==(const TimeoutMember &o) const {
-          return fd == o.fd && read == o.read;
-        }
-      };
-
-      struct TimeoutMemberHash {
-        size_t operator()(const TimeoutMember &m) const {
-          return std::hash<int>()(m.fd * 2 + m.read);
-        }
-      };
-
       struct Timeout {
         uint64_t time;
         bool read;
@@ -99,11 +85,12 @@ namespace cb {
 
       class FDRec;
 
-      class FDQueue : public std::queue<SmartPointer<Transfer> > {
+      class FDQueue : public RingQueue<SmartPointer<Transfer> > {
         FDRec &fdr;
         bool read;
         bool closed = false;
         bool timedout = false;
+        bool timeoutQueued = false;
         uint64_t last = 0;
         bool newTransfer = true;
 
@@ -124,6 +111,7 @@ namespace cb {
         void add(const SmartPointer<Transfer> &tran);
 
       protected:
+        void queueTimeout();
         void close();
         void pop();
       };
@@ -131,7 +119,9 @@ namespace cb {
       class FDRec {
         FDPoolEPoll &pool;
         int fd = -1;
+        uint32_t gen = 0;
         unsigned events = 0;
+        bool changed = false;
         FDQueue readQ;
         FDQueue writeQ;
 
@@ -140,7 +130,11 @@ namespace cb {
 
         FDPoolEPoll &getPool() {return pool;}
         int getFD() const {return fd;}
+        uint32_t getGen() const {return gen;}
+        bool isChanged() const {return changed;}
+        void setChanged(bool changed) {this->changed = changed;}
 
+        void reset(uint32_t gen);
         void timeout(uint64_t now, bool read);
         unsigned getEvents() const;
         int getStatus() const;
@@ -152,20 +146,27 @@ namespace cb {
 
       SPSCQueue<Command> cmds;
       SPSCQueue<Command> results;
-      std::unordered_set<TimeoutMember, TimeoutMemberHash> inTimeoutQ;
       std::priority_queue<Timeout> timeoutQ;
-      std::unordered_set<int> flushing;
 
-      typedef std::unordered_map<int, SmartPointer<FDRec> > pool_t;
-      pool_t pool;
+      // Pool thread state, indexed by fd
+      std::vector<SmartPointer<FDRec> > pool;
+      std::vector<int> changed;
+
+      /// Main thread state, indexed by fd.  The generation is incremented
+      /// each time an fd number is opened and travels with every command and
+      /// result so that state left over from a previous user is discarded.
+      struct Slot {
+        FD *fd = 0;
+        uint32_t gen = 0;
+        bool flushing = false;
+      };
 
-      typedef std::unordered_map<int, FD *> fds_t;
-      fds_t fds;
+      std::vector<Slot> slots;
 
       bool queuedResults = false;
 
     public:
-      FDPoolEPoll(Base &base);
+      FDPoolEPoll(Base &base) : FDPoolEPoll(base, true) {}
       ~FDPoolEPoll();
 
       int getFD() const {return fd;}
@@ -180,13 +181,29 @@ namespace cb {
       void flush(int fd) override;
 
       void queueTimeout(uint64_t time, bool read, int fd);
-      void queueComplete(const SmartPointer<Transfer> &t);
-      void queueFlushed(int fd);
-      void queueProgress(cmd_t cmd, int fd, uint64_t time, int value);
+      void queueComplete(const FDRec &fdr, const SmartPointer<Transfer> &t);
+      void queueFlushed(const FDRec &fdr);
+      void queueProgress(const FDRec &fdr, cmd_t cmd, uint64_t time,
+                         int value);
 
     protected:
-      void queueStatus(int fd, int status);
+      struct Ready {
+        int fd;
+        unsigned events;
+      };
+
+      /// If @param epoll is false the subclass must provide polling and
+      /// call start() once constructed
+      FDPoolEPoll(Base &base, bool epoll);
+
+      /// Change the FD::*_EVENT flags @param fd is waiting for
+      virtual void setEvents(int fd, unsigned oldEvents, unsigned newEvents);
+      /// Wait at most @param timeout ms, @return number of @param ready FDs
+      virtual unsigned wait(Ready *ready, unsigned size, int timeout);
+
+      void queueStatus(const FDRec &fdr, int status);
       void queueCommand(cmd_t cmd, int fd, const SmartPointer<Transfer> &tran);
+      Slot &getSlot(int fd);
       FDRec &getFD(int fd);
       void processResults();
 
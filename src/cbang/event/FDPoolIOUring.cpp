@@ -0,0 +1,347 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "FDPoolIOUring.h"
+
+#if defined(HAVE_EPOLL) && defined(HAVE_IO_URING)
+
+#include "FD.h"
+
+#include <cbang/log/Logger.h>
+#include <cbang/os/SysError.h>
+
+#include <cstring>
+#include <cerrno>
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace cb::Event;
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  const uint64_t TIMER_TAG  = ~(uint64_t)0;
+  const uint64_t REMOVE_TAG = ~(uint64_t)1;
+
+
+  int io_uring_setup(unsigned entries, io_uring_params *params) {
+    return syscall(__NR_io_uring_setup, entries, params);
+  }
+
+
+  int io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete,
+                     unsigned flags) {
+    return syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, 0,
+                   0);
+  }
+
+
+  uint32_t fd_to_poll_events(unsigned events) {
+    uint32_t mask =
+      ((FD::CLOSE_EVENT & events) ? POLLRDHUP : 0) |
+      ((FD::READ_EVENT  & events) ? POLLIN    : 0) |
+      ((FD::WRITE_EVENT & events) ? POLLOUT   : 0);
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    mask = mask << 16 | mask >> 16; // The kernel expects the words swapped
+#endif
+
+    return mask;
+  }
+
+
+  unsigned poll_to_fd_events(int res) {
+    if (res < 0 || (res & (POLLERR | POLLHUP | POLLNVAL)))
+      return FD::READ_EVENT | FD::WRITE_EVENT;
+
+    unsigned e = 0;
+    if (res & POLLIN)    e |= FD::READ_EVENT;
+    if (res & POLLOUT)   e |= FD::WRITE_EVENT;
+    if (res & POLLRDHUP) e |= FD::CLOSE_EVENT;
+
+    return e;
+  }
+
+
+  uint64_t pollTag(int fd, uint32_t gen) {return (uint64_t)fd << 32 | gen;}
+}
+
+
+struct FDPoolIOUring::private_t {
+  int fd = -1;
+
+  void *sqRing = MAP_FAILED;
+  size_t sqRingSize = 0;
+  void *cqRing = MAP_FAILED;
+  size_t cqRingSize = 0;
+  io_uring_sqe *sqes = (io_uring_sqe *)MAP_FAILED;
+  size_t sqesSize = 0;
+
+  unsigned *sqHead;
+  unsigned *sqTail;
+  unsigned *sqMask;
+  unsigned *sqEntries;
+  unsigned *sqArray;
+  unsigned *cqHead;
+  unsigned *cqTail;
+  unsigned *cqMask;
+  io_uring_cqe *cqes;
+
+  unsigned toSubmit = 0;
+  __kernel_timespec timeout;
+
+
+  private_t(unsigned entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    fd = io_uring_setup(entries, &params);
+    if (fd < 0) THROW("io_uring_setup() failed: " << SysError());
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) sqRingSize = cqRingSize = max(sqRingSize, cqRingSize);
+
+    sqRing = mmap(0, sqRingSize, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) THROW("Failed to map io_uring SQ");
+
+    if (single) cqRing = sqRing;
+    else {
+      cqRing = mmap(0, cqRingSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      if (cqRing == MAP_FAILED) THROW("Failed to map io_uring CQ");
+    }
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = (io_uring_sqe *)mmap(0, sqesSize, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, fd,
+                                IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) THROW("Failed to map io_uring SQEs");
+
+    char *sq = (char *)sqRing;
+    sqHead    = (unsigned *)(sq + params.sq_off.head);
+    sqTail    = (unsigned *)(sq + params.sq_off.tail);
+    sqMask    = (unsigned *)(sq + params.sq_off.ring_mask);
+    sqEntries = (unsigned *)(sq + params.sq_off.ring_entries);
+    sqArray   = (unsigned *)(sq + params.sq_off.array);
+
+    char *cq = (char *)cqRing;
+    cqHead = (unsigned *)(cq + params.cq_off.head);
+    cqTail = (unsigned *)(cq + params.cq_off.tail);
+    cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    cqes   = (io_uring_cqe *)(cq + params.cq_off.cqes);
+  }
+
+
+  ~private_t() {
+    if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+    if (fd != -1) ::close(fd);
+  }
+
+
+  /// @return false if the kernel cannot accept entries until reaped
+  bool enter(unsigned minComplete) {
+    unsigned flags = minComplete ? IORING_ENTER_GETEVENTS : 0;
+
+    while (toSubmit || minComplete) {
+      int ret = io_uring_enter(fd, toSubmit, minComplete, flags);
+
+      if (ret < 0) {
+        if (errno == EINTR) return true;
+        // Completion queue is full, caller must reap first
+        if (errno == EBUSY || errno == EAGAIN) return false;
+        THROW("io_uring_enter() failed: " << SysError());
+      }
+
+      toSubmit -= ret;
+      minComplete = 0;
+    }
+
+    return true;
+  }
+
+
+  io_uring_sqe &getSQE() {
+    unsigned tail = *sqTail;
+
+    // Submit queued entries until the ring has room, never overwrite one
+    while (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) == *sqEntries)
+      if (!toSubmit || !enter(0)) THROW("io_uring submission queue full");
+
+    unsigned index = tail & *sqMask;
+    io_uring_sqe &sqe = sqes[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqArray[index] = index;
+
+    return sqe;
+  }
+
+
+  void push() {
+    __atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+    toSubmit++;
+  }
+
+
+  bool hasCompletions() const {
+    return *cqHead != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+  }
+};
+
+
+FDPoolIOUring::FDPoolIOUring(Base &base) :
+  FDPoolEPoll(base, false), pri(new private_t(4096)) {start();}
+
+
+FDPoolIOUring::~FDPoolIOUring() {join();}
+
+
+bool FDPoolIOUring::isSupported() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+
+  int fd = io_uring_setup(1, &params);
+  if (fd < 0) return false;
+  ::close(fd);
+
+  // Need IORING_FEAT_NODROP, 5.5+, so completions are never lost
+  return params.features & IORING_FEAT_NODROP;
+}
+
+
+FDPoolIOUring::Poll &FDPoolIOUring::getPoll(int fd) {
+  if (polls.size() <= (unsigned)fd) polls.resize(fd + 1);
+  return polls[fd];
+}
+
+
+void FDPoolIOUring::addPoll(int fd, Poll &poll) {
+  io_uring_sqe &sqe = pri->getSQE();
+  sqe.opcode = IORING_OP_POLL_ADD;
+  sqe.fd = fd;
+  sqe.poll32_events = fd_to_poll_events(poll.events);
+  sqe.user_data = pollTag(fd, poll.gen);
+  pri->push();
+
+  poll.armed = true;
+}
+
+
+void FDPoolIOUring::removePoll(int fd, Poll &poll) {
+  io_uring_sqe &sqe = pri->getSQE();
+  sqe.opcode = IORING_OP_POLL_REMOVE;
+  sqe.fd = -1;
+  sqe.addr = pollTag(fd, poll.gen);
+  sqe.user_data = REMOVE_TAG;
+  pri->push();
+
+  // Any completion for the removed poll is now stale
+  poll.gen++;
+  poll.armed = false;
+}
+
+
+void FDPoolIOUring::setEvents(int fd, unsigned oldEvents,
+                              unsigned newEvents) {
+  Poll &poll = getPoll(fd);
+
+  if (poll.armed) removePoll(fd, poll);
+  poll.events = newEvents;
+  if (newEvents) addPoll(fd, poll);
+}
+
+
+unsigned FDPoolIOUring::wait(Ready *ready, unsigned size, int timeout) {
+  // Rearm polls which fired and are still wanted
+  for (int fd : rearm) {
+    Poll &poll = polls[fd];
+    if (poll.events && !poll.armed) addPoll(fd, poll);
+  }
+
+  rearm.clear();
+
+  // Wake up after timeout if nothing else completes
+  if (!timerArmed) {
+    pri->timeout.tv_sec  = timeout / 1000;
+    pri->timeout.tv_nsec = (timeout % 1000) * 1000000;
+
+    io_uring_sqe &sqe = pri->getSQE();
+    sqe.opcode = IORING_OP_TIMEOUT;
+    sqe.fd = -1;
+    sqe.addr = (uint64_t)&pri->timeout;
+    sqe.len = 1;
+    sqe.user_data = TIMER_TAG;
+    pri->push();
+
+    timerArmed = true;
+  }
+
+  // Submit and wait in one call
+  pri->enter(pri->hasCompletions() ? 0 : 1);
+
+  unsigned count = 0;
+  unsigned head = *pri->cqHead;
+  unsigned tail = __atomic_load_n(pri->cqTail, __ATOMIC_ACQUIRE);
+
+  for (; head != tail && count < size; head++) {
+    const io_uring_cqe &cqe = pri->cqes[head & *pri->cqMask];
+
+    if (cqe.user_data == TIMER_TAG) timerArmed = false;
+    if (cqe.user_data == TIMER_TAG || cqe.user_data == REMOVE_TAG) continue;
+
+    int fd = cqe.user_data >> 32;
+    Poll &poll = polls[fd];
+    if (poll.gen != (uint32_t)cqe.user_data) continue; // Stale
+
+    poll.armed = false;
+    rearm.push_back(fd);
+
+    ready[count].fd = fd;
+    ready[count].events = poll_to_fd_events(cqe.res);
+    count++;
+  }
+
+  __atomic_store_n(pri->cqHead, head, __ATOMIC_RELEASE);
+
+  return count;
+}
+
+#endif // HAVE_EPOLL && HAVE_IO_URING
@@ -0,0 +1,92 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/config.h>
+
+#if defined(HAVE_EPOLL) && defined(HAVE_IO_URING)
+
+#include "FDPoolEPoll.h"
+
+#include <vector>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * FDPoolEPoll with readiness notification via io_uring instead of epoll.
+     *
+     * Poll requests for every FD whose interest changed during a loop
+     * iteration are queued in the submission ring and submitted, together
+     * with the wait for completions, in a single io_uring_enter() call.  This
+     * replaces one epoll_ctl() per change plus epoll_wait().  Polls are
+     * one-shot and rearmed after each completion, preserving the level
+     * triggered behavior, timeouts and flush semantics of FDPoolEPoll.
+     *
+     * Transfers still perform their own reads and writes because TLS
+     * connections must be driven by OpenSSL.
+     */
+    class FDPoolIOUring : public FDPoolEPoll {
+      struct private_t;
+      SmartPointer<private_t> pri;
+
+      struct Poll {
+        unsigned events = 0;
+        uint32_t gen = 0;
+        bool armed = false;
+      };
+
+      std::vector<Poll> polls; // Indexed by fd
+      std::vector<int> rearm;
+      bool timerArmed = false;
+
+    public:
+      FDPoolIOUring(Base &base);
+      ~FDPoolIOUring();
+
+      /// @return true if the running kernel supports io_uring
+      static bool isSupported();
+
+    protected:
+      Poll &getPoll(int fd);
+      void addPoll(int fd, Poll &poll);
+      void removePoll(int fd, Poll &poll);
+
+      // From FDPoolEPoll
+      void setEvents(int fd, unsigned oldEvents, unsigned newEvents) override;
+      unsigned wait(Ready *ready, unsigned size, int timeout) override;
+    };
+  }
+}
+
+#endif // HAVE_EPOLL && HAVE_IO_URING
@@ -0,0 +1,228 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "FileWatcher.h"
+
+#include <cbang/config.h>
+#include <cbang/Catch.h>
+#include <cbang/log/Logger.h>
+#include <cbang/os/SysError.h>
+
+#include <vector>
+
+#ifdef HAVE_INOTIFY
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+#ifdef HAVE_INOTIFY
+namespace {
+  const struct {unsigned fw; uint32_t in;} eventMap[] = {
+    {FileWatcher::FW_CREATE,      IN_CREATE},
+    {FileWatcher::FW_DELETE,      IN_DELETE},
+    {FileWatcher::FW_MODIFY,      IN_MODIFY},
+    {FileWatcher::FW_CLOSE_WRITE, IN_CLOSE_WRITE},
+    {FileWatcher::FW_MOVED_FROM,  IN_MOVED_FROM},
+    {FileWatcher::FW_MOVED_TO,    IN_MOVED_TO},
+    {FileWatcher::FW_ATTRIB,      IN_ATTRIB},
+    {FileWatcher::FW_DELETE_SELF, IN_DELETE_SELF},
+    {FileWatcher::FW_MOVE_SELF,   IN_MOVE_SELF},
+    {FileWatcher::FW_ISDIR,       IN_ISDIR},
+    {FileWatcher::FW_IGNORED,     IN_IGNORED},
+    {FileWatcher::FW_OVERFLOW,    IN_Q_OVERFLOW},
+  };
+
+
+  uint32_t toNative(unsigned events) {
+    uint32_t mask = 0;
+    for (auto &e: eventMap) if (events & e.fw) mask |= e.in;
+    return mask;
+  }
+
+
+  unsigned fromNative(uint32_t mask) {
+    unsigned events = 0;
+    for (auto &e: eventMap) if (mask & e.in) events |= e.fw;
+    return events;
+  }
+}
+#endif // HAVE_INOTIFY
+
+
+FileWatcher::FileWatcher(Base &base) : base(base) {
+#ifdef HAVE_INOTIFY
+  fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0) THROW("Failed to create inotify instance: " << SysError());
+
+  event = base.newEvent(fd, [this] {read();},
+                        EF::EVENT_READ | EF::EVENT_PERSIST);
+  event->add();
+#endif
+}
+
+
+FileWatcher::~FileWatcher() {close();}
+
+
+bool FileWatcher::isSupported() {
+#ifdef HAVE_INOTIFY
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+unsigned FileWatcher::add(const string &path, unsigned events,
+                          callback_t cb) {
+#ifdef HAVE_INOTIFY
+  // IN_MASK_ADD widens the kernel mask when subscriptions share an inode
+  int wd = inotify_add_watch(fd, path.c_str(), toNative(events) | IN_MASK_ADD);
+  if (wd < 0) THROW("Failed to watch '" << path << "': " << SysError());
+
+  unsigned id = nextID++;
+  subs[id] = Subscription{wd, path, events, cb};
+  watches[wd].insert(id);
+
+  LOG_DEBUG(5, "Watching '" << path << "' wd=" << wd << " id=" << id);
+
+  return id;
+
+#else
+  THROW("File watching not supported on this platform");
+#endif
+}
+
+
+void FileWatcher::remove(unsigned id) {
+  auto it = subs.find(id);
+  if (it == subs.end()) return;
+
+  int wd = it->second.wd;
+  subs.erase(it);
+
+  auto it2 = watches.find(wd);
+  if (it2 == watches.end()) return;
+
+  it2->second.erase(id);
+  if (!it2->second.empty()) return;
+  watches.erase(it2);
+
+#ifdef HAVE_INOTIFY
+  // May fail if the kernel already dropped the watch
+  if (0 <= fd) inotify_rm_watch(fd, wd);
+#endif
+}
+
+
+void FileWatcher::close() {
+  if (event.isSet()) event->del();
+  event.release();
+
+#ifdef HAVE_INOTIFY
+  if (0 <= fd) ::close(fd);
+#endif
+  fd = -1;
+}
+
+
+void FileWatcher::read() {
+#ifdef HAVE_INOTIFY
+  alignas(struct inotify_event) char buffer[64 * 1024];
+
+  while (true) {
+    ssize_t len = ::read(fd, buffer, sizeof(buffer));
+
+    if (len < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+      if (errno == EINTR) continue;
+      LOG_ERROR("inotify read failed: " << SysError());
+      return;
+    }
+
+    if (!len) return;
+
+    for (ssize_t i = 0; i < len;) {
+      auto ev = (const struct inotify_event *)(buffer + i);
+      i += sizeof(struct inotify_event) + ev->len;
+
+      string name = ev->len ? string(ev->name) : string();
+
+      try {
+        dispatch(ev->wd, fromNative(ev->mask), name);
+      } CATCH_ERROR;
+    }
+  }
+#endif
+}
+
+
+void FileWatcher::dispatch(int wd, unsigned events, const string &name) {
+  vector<unsigned> ids;
+
+  if (events & FW_OVERFLOW) {
+    LOG_WARNING("File watch queue overflowed, events were lost");
+    for (auto &p: subs) ids.push_back(p.first);
+
+  } else {
+    auto it = watches.find(wd);
+    if (it == watches.end()) return;
+    ids.insert(ids.end(), it->second.begin(), it->second.end());
+  }
+
+  // Callbacks may add or remove subscriptions
+  for (auto id: ids) {
+    auto it = subs.find(id);
+    if (it == subs.end()) continue;
+
+    unsigned mask =
+      it->second.events | FW_ISDIR | FW_IGNORED | FW_OVERFLOW;
+    if (!(events & mask & ~FW_ISDIR)) continue;
+
+    callback_t cb = it->second.cb;
+    cb(events & mask, name);
+  }
+
+  if (events & FW_IGNORED) {
+    auto it = watches.find(wd);
+    if (it == watches.end()) return;
+
+    for (auto id: it->second) subs.erase(id);
+    watches.erase(it);
+  }
+}
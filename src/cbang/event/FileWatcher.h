@@ -0,0 +1,109 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Event.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <functional>
+
+
+namespace cb {
+  namespace Event {
+    /***
+     * Delivers file system change notifications on an Event::Base.  On
+     * Linux this is backed by a single inotify descriptor.  Several
+     * subscriptions may share one watched path.
+     */
+    class FileWatcher : public RefCounted {
+    public:
+      enum {
+        FW_CREATE      = 1 << 0,
+        FW_DELETE      = 1 << 1,
+        FW_MODIFY      = 1 << 2,
+        FW_CLOSE_WRITE = 1 << 3,
+        FW_MOVED_FROM  = 1 << 4,
+        FW_MOVED_TO    = 1 << 5,
+        FW_ATTRIB      = 1 << 6,
+        FW_DELETE_SELF = 1 << 7,
+        FW_MOVE_SELF   = 1 << 8,
+        FW_ISDIR       = 1 << 9,  // Set on events for directory entries
+        FW_IGNORED     = 1 << 10, // Watch removed, no more events follow
+        FW_OVERFLOW    = 1 << 11, // Events were lost, sent to everyone
+      };
+
+      /// @param name The entry changed, empty for the watched path itself.
+      typedef std::function<void (unsigned events, const std::string &name)>
+      callback_t;
+
+    protected:
+      Base &base;
+      int fd = -1;
+      EventPtr event;
+
+      struct Subscription {
+        int wd;
+        std::string path;
+        unsigned events;
+        callback_t cb;
+      };
+
+      unsigned nextID = 1;
+      std::map<unsigned, Subscription> subs;
+      std::map<int, std::set<unsigned>> watches;
+
+    public:
+      FileWatcher(Base &base);
+      ~FileWatcher();
+
+      static bool isSupported();
+
+      unsigned getNumWatches() const {return watches.size();}
+
+      /// @return A subscription ID to pass to remove().
+      unsigned add(const std::string &path, unsigned events, callback_t cb);
+      void remove(unsigned id);
+
+      /// Stop watching, later calls to remove() only drop subscriptions.
+      void close();
+
+    protected:
+      void read();
+      void dispatch(int wd, unsigned events, const std::string &name);
+    };
+  }
+}
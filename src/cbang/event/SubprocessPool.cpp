@@ -36,14 +36,32 @@
 
 #include <cbang/Catch.h>
 #include <cbang/os/SystemInfo.h>
+#include <cbang/time/Timer.h>
+
+#include <algorithm>
+#include <cmath>
 
 #include <csignal>
+#include <cerrno>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 using namespace cb;
 using namespace cb::Event;
 
 
+SubprocessPool::Child::~Child() {
+  if (exitEvent.isSet()) exitEvent->del();
+#ifdef __linux__
+  if (0 <= pidfd) ::close(pidfd);
+#endif
+}
+
+
 SubprocessPool::SubprocessPool(Base &base) :
   base(base), maxActive(SystemInfo::instance().getCPUCount()) {
 
@@ -51,10 +69,13 @@ SubprocessPool::SubprocessPool(Base &base) :
   if (base.hasPriorities()) execEvent->setPriority(8);
   execEvent->add();
 
+  loadEvent = base.newEvent([this] {exec();}, 0);
+
 #ifdef _WIN32
   THROW("SubprocessPool not supported on Windows");
 
 #else
+  // Reaps processes for which a pidfd could not be opened
   signalEvent = base.newSignal(SIGCHLD, [this] {childSignal();});
   if (base.hasPriorities()) signalEvent->setPriority(7);
   signalEvent->add();
@@ -62,37 +83,137 @@ SubprocessPool::SubprocessPool(Base &base) :
 }
 
 
+unsigned SubprocessPool::getLimit() {
+  if (!dynamic) return maxActive;
+
+  double now = Timer::now();
+  if (limitTime + 1 <= now) {
+    limitTime = now;
+
+    auto &info = SystemInfo::instance();
+    limit = computeLimit(maxActive, info.getCPUQuota(), info.getLoadAverage(),
+                         active.size());
+  }
+
+  return limit;
+}
+
+
+unsigned SubprocessPool::computeLimit(unsigned maxActive, double cpus,
+                                      double load, unsigned active) {
+  // The load average includes our own processes, only yield to others
+  double other = max(0.0, load - active);
+  return min<double>(maxActive, max(1.0, ceil(cpus - other)));
+}
+
+
+double SubprocessPool::getGroupWeight(const string &group) const {
+  auto it = weights.find(group);
+  return it == weights.end() ? 1 : it->second;
+}
+
+
+void SubprocessPool::setGroupWeight(const string &group, double weight) {
+  if (weight <= 0) THROW("Group weight must be positive");
+  weights[group] = weight;
+}
+
+
 void SubprocessPool::enqueue(const SmartPointer<AsyncSubprocess> &proc) {
   if (quit) THROW("Shutting down");
-  procs.push(proc);
+
+  auto it = groups.find(proc->getGroup());
+  if (it == groups.end()) {
+    it = groups.insert(make_pair(proc->getGroup(), Group())).first;
+    it->second.vtime = vtime; // Start level with the groups already waiting
+  }
+
+  it->second.procs.push(proc);
+  queued++;
+
   if (active.size() < maxActive) execEvent->activate();
 }
 
 
 void SubprocessPool::shutdown() {
   quit = true;
-  while (!procs.empty()) procs.pop();
+  groups.clear();
+  queued = 0;
   active.clear();
 }
 
 
+SmartPointer<AsyncSubprocess> SubprocessPool::dequeue() {
+  auto next = groups.begin();
+  for (auto it = groups.begin(); it != groups.end(); it++)
+    if (it->second.vtime < next->second.vtime) next = it;
+
+  Group &group = next->second;
+  auto proc = group.procs.top();
+  group.procs.pop();
+  queued--;
+
+  vtime = group.vtime;
+  group.vtime += 1 / getGroupWeight(next->first);
+  if (group.procs.empty()) groups.erase(next);
+
+  return proc;
+}
+
+
+void SubprocessPool::launch(const SmartPointer<AsyncSubprocess> &proc) {
+  proc->exec();
+
+  uint64_t pid = proc->getPID();
+  auto child = SmartPtr(new Child(proc));
+  active[pid] = child;
+
+#ifdef SYS_pidfd_open
+  // A pidfd becomes readable when this process exits, avoiding a scan of all
+  // processes on every SIGCHLD
+  child->pidfd = syscall(SYS_pidfd_open, (pid_t)pid, 0);
+  if (0 <= child->pidfd) {
+    child->exitEvent = base.newEvent(
+      child->pidfd, [this, pid] {childExit(pid);}, EF::EVENT_READ);
+    if (base.hasPriorities()) child->exitEvent->setPriority(7);
+    child->exitEvent->add();
+  }
+#endif
+
+  for (unsigned pipe = 1; pipe < 3; pipe++)
+    if (proc->isCapturing(pipe)) {
+      auto &end = proc->getPipe(pipe);
+      end.setBlocking(false);
+
+      auto &event = child->outEvents[pipe - 1];
+      event = base.newEvent(
+        end.getHandle(), [this, pid, pipe] {childOutput(pid, pipe);},
+        EF::EVENT_READ | EF::EVENT_PERSIST);
+      event->add();
+    }
+
+  LOG_DEBUG(5, "Launched process " << pid);
+}
+
+
 void SubprocessPool::exec() {
   if (quit) return;
 
-  while (active.size() < maxActive && !procs.empty()) {
-    SmartPointer<AsyncSubprocess> proc = procs.top();
-    procs.pop();
+  while (active.size() < getLimit() && queued) {
+    auto proc = dequeue();
 
     try {
-      proc->exec();
-      active.push_back(proc);
-      LOG_DEBUG(5, "Launched process " << proc->getPID());
+      launch(proc);
       continue;
     } CATCH_ERROR;
 
     // An error occurred
     proc->done();
   }
+
+  // Check again later if the load may have held processes back
+  if (queued && active.size() < maxActive && !loadEvent->isPending())
+    loadEvent->add(1);
 }
 
 
@@ -100,33 +221,74 @@ void SubprocessPool::childSignal() {
   if (quit) return;
 
   for (auto it = active.begin(); it != active.end();) {
-    AsyncSubprocess &proc = **it;
+    auto next = it;
+    next++;
 
-    try {
-      proc.wait(true);
+    if (it->second->pidfd < 0)
+      try {
+        it->second->proc->wait(true);
+        if (!it->second->proc->isRunning()) reap(it);
+      } CATCH_ERROR;
 
-      if (!proc.isRunning()) {
-        if (proc.getWasKilled())
-          LOG_WARNING("Process " << proc.getPID() << " was killed");
+    it = next;
+  }
+}
 
-        else if (proc.getDumpedCore())
-          LOG_WARNING("Process " << proc.getPID() << " dumped core");
 
-        else if (proc.getReturnCode())
-          LOG_WARNING("Process " << proc.getPID() << " returned "
-                      << proc.getReturnCode());
+void SubprocessPool::childExit(uint64_t pid) {
+  if (quit) return;
 
-        LOG_DEBUG(5, "Reaping PID " << proc.getPID());
+  auto it = active.find(pid);
+  if (it == active.end()) return;
 
-        TRY_CATCH_ERROR(proc.done());
-        if (!procs.empty()) execEvent->activate();
+  try {
+    it->second->proc->wait(true);
+    if (!it->second->proc->isRunning()) reap(it);
+  } CATCH_ERROR;
+}
 
-        it = active.erase(it);
-        continue;
-      }
 
-    } CATCH_ERROR;
+void SubprocessPool::childOutput(uint64_t pid, unsigned pipe) {
+  auto it = active.find(pid);
+  if (it == active.end()) return;
 
-    it++;
+  Child &child = *it->second;
+  int bytes = child.proc->readOutput(pipe);
+
+  if (!bytes || (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    child.outEvents[pipe - 1]->del();
+    child.proc->getPipe(pipe).close();
   }
 }
+
+
+void SubprocessPool::reap(active_t::iterator it) {
+  auto child = it->second;
+  AsyncSubprocess &proc = *child->proc;
+  active.erase(it);
+
+  if (proc.getWasKilled())
+    LOG_WARNING("Process " << proc.getPID() << " was killed");
+
+  else if (proc.getDumpedCore())
+    LOG_WARNING("Process " << proc.getPID() << " dumped core");
+
+  else if (proc.getReturnCode())
+    LOG_WARNING("Process " << proc.getPID() << " returned "
+                << proc.getReturnCode());
+
+  LOG_DEBUG(5, "Reaping PID " << proc.getPID());
+
+  // Collect output still in the pipes
+  for (unsigned pipe = 1; pipe < 3; pipe++)
+    if (child->outEvents[pipe - 1].isSet()) {
+      child->outEvents[pipe - 1]->del();
+      if (proc.getPipe(pipe).isOpen()) {
+        while (0 < proc.readOutput(pipe)) continue;
+        proc.getPipe(pipe).close();
+      }
+    }
+
+  TRY_CATCH_ERROR(proc.done());
+  if (queued) execEvent->activate();
+}
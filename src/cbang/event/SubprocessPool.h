@@ -37,8 +37,9 @@
 #include <cbang/SmartPointer.h>
 
 #include <queue>
-#include <list>
+#include <map>
 #include <vector>
+#include <string>
 #include <cstdint>
 
 
@@ -47,9 +48,17 @@ namespace cb {
     class Base;
     class Event;
 
+    // Runs queued subprocesses, at most getLimit() at a time.  Launches are
+    // shared between process groups by weighted fair queuing: each group's
+    // virtual time advances by 1 / weight per launch and the group furthest
+    // behind goes next.  Within a group, lower priority values go first.  A
+    // group that empties its queue does not bank credit for later.
     class SubprocessPool {
       Base &base;
       unsigned maxActive;
+      bool dynamic = false;
+      unsigned limit = 0;
+      double limitTime = 0;
 
       struct cmp {
         bool operator()(const cb::SmartPointer<AsyncSubprocess> &p1,
@@ -61,14 +70,34 @@ namespace cb {
       typedef std::vector<cb::SmartPointer<AsyncSubprocess> > container_t;
       typedef std::priority_queue<
         cb::SmartPointer<AsyncSubprocess>, container_t, cmp> procs_t;
-      procs_t procs;
 
-      typedef std::list<cb::SmartPointer<AsyncSubprocess> > active_t;
+      struct Group {
+        procs_t procs;
+        double vtime = 0;
+      };
+
+      std::map<std::string, Group> groups;
+      std::map<std::string, double> weights;
+      double vtime = 0;
+      unsigned queued = 0;
+
+      struct Child {
+        cb::SmartPointer<AsyncSubprocess> proc;
+        int pidfd = -1;
+        cb::SmartPointer<cb::Event::Event> exitEvent;
+        cb::SmartPointer<cb::Event::Event> outEvents[2];
+
+        Child(const cb::SmartPointer<AsyncSubprocess> &proc) : proc(proc) {}
+        ~Child();
+      };
+
+      typedef std::map<uint64_t, cb::SmartPointer<Child> > active_t;
       active_t active;
 
       bool quit = false;
 
       cb::SmartPointer<cb::Event::Event> execEvent;
+      cb::SmartPointer<cb::Event::Event> loadEvent;
       cb::SmartPointer<cb::Event::Event> signalEvent;
 
     public:
@@ -79,15 +108,33 @@ namespace cb {
       unsigned getMaxActive() const {return maxActive;}
       void setMaxActive(unsigned maxActive) {this->maxActive = maxActive;}
 
-      unsigned getNumQueued() const {return procs.size();}
+      // When dynamic, fewer than getMaxActive() processes run while other
+      // work loads the CPUs available under the cgroup quota
+      bool getDynamic() const {return dynamic;}
+      void setDynamic(bool dynamic) {this->dynamic = dynamic; limitTime = 0;}
+      unsigned getLimit();
+      // The dynamic limit given the CPU quota, the load average and the
+      // number of this pool's processes running
+      static unsigned computeLimit(unsigned maxActive, double cpus,
+                                   double load, unsigned active);
+
+      double getGroupWeight(const std::string &group) const;
+      void setGroupWeight(const std::string &group, double weight);
+
+      unsigned getNumQueued() const {return queued;}
       unsigned getNumActive() const {return active.size();}
 
       void enqueue(const cb::SmartPointer<AsyncSubprocess> &proc);
       void shutdown();
 
     protected:
+      cb::SmartPointer<AsyncSubprocess> dequeue();
+      void launch(const cb::SmartPointer<AsyncSubprocess> &proc);
       void exec();
       void childSignal();
+      void childExit(uint64_t pid);
+      void childOutput(uint64_t pid, unsigned pipe);
+      void reap(active_t::iterator it);
     };
   }
 }
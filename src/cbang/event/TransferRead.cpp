@@ -137,8 +137,23 @@ void TransferRead::checkFinished() {
   if (finished) return;
 
   unsigned bytesRead = buffer.getLength();
-  if (length <= bytesRead || (!until.empty() && buffer.indexOf(until) != -1)) {
+  if (length <= bytesRead || foundUntil(bytesRead)) {
     finished = success = true;
     length = bytesRead;
   }
 }
+
+
+bool TransferRead::foundUntil(unsigned bytesRead) {
+  if (until.empty()) return false;
+
+  // Resume where the last search stopped, overlapping by all but one byte
+  // of the delimiter in case it spans reads
+  if (bytesRead < searched) searched = 0;
+  if (buffer.indexOf(until, searched) != -1) return true;
+
+  unsigned overlap = until.length() - 1;
+  searched = overlap < bytesRead ? bytesRead - overlap : 0;
+
+  return false;
+}
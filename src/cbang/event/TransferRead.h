@@ -43,6 +43,7 @@ namespace cb {
     class TransferRead : public Transfer {
       Buffer buffer;
       std::string until;
+      unsigned searched = 0;
 
     public:
       TransferRead(int fd, const SmartPointer<SSL> &ssl, cb_t cb,
@@ -56,6 +57,7 @@ namespace cb {
     protected:
       int read(Buffer &buffer, unsigned length);
       void checkFinished();
+      bool foundUntil(unsigned bytesRead);
     };
   }
 }
@@ -0,0 +1,463 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Rectangle.h"
+#include "Segment.h"
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+
+namespace cb {
+  /**
+   * A static bounding volume hierarchy over axis aligned boxes.
+   *
+   * The tree is bulk loaded with a binned surface area heuristic and stored
+   * depth first in a flat node array.  A node's left child immediately
+   * follows it and the right child is found by index.  Queries report the
+   * index of each item, in the order the boxes were passed to build(),
+   * whose bounds pass the test.  Exact item tests are left to the caller.
+   */
+  template <const unsigned DIM, typename T>
+  class BVH {
+  public:
+    typedef Vector<DIM, T> Vector_T;
+    typedef Rectangle<DIM, T> Rectangle_T;
+    typedef Segment<DIM, T> Segment_T;
+
+    struct Node {
+      Rectangle_T bounds;
+      unsigned offset; ///< First item if leaf, else right child
+      unsigned count;  ///< Item count, zero for interior nodes
+
+      bool isLeaf() const {return count;}
+    };
+
+  protected:
+    std::vector<Node> nodes;
+    std::vector<unsigned> items;
+    std::vector<Rectangle_T> itemBounds; // In leaf order, parallel to items
+    std::vector<Vector_T> centroids;
+
+    static const unsigned BINS = 16;
+
+  public:
+    BVH() {}
+    BVH(const std::vector<Rectangle_T> &boxes, unsigned leafSize = 4,
+        unsigned threads = 1) {build(boxes, leafSize, threads);}
+    BVH(const std::vector<Segment_T> &segs, unsigned leafSize = 4,
+        unsigned threads = 1) {build(segs, leafSize, threads);}
+
+    const std::vector<Node> &getNodes() const {return nodes;}
+    unsigned size() const {return items.size();}
+    bool empty() const {return items.empty();}
+
+    Rectangle_T getBounds() const
+    {return nodes.empty() ? Rectangle_T() : nodes[0].bounds;}
+
+
+    void clear() {
+      nodes.clear();
+      items.clear();
+      itemBounds.clear();
+    }
+
+
+    void build(const std::vector<Rectangle_T> &boxes, unsigned leafSize = 4,
+               unsigned threads = 1) {
+      clear();
+      if (boxes.empty()) return;
+      if (!leafSize) leafSize = 1;
+      if (!threads) threads = 1;
+
+      unsigned n = boxes.size();
+      items.resize(n);
+      centroids.resize(n);
+      for (unsigned i = 0; i < n; i++) {
+        items[i] = i;
+        centroids[i] = boxes[i].getCenter();
+      }
+
+      nodes.reserve(2 * n / leafSize + 1);
+      build(boxes, nodes, 0, n, leafSize, threads);
+
+      itemBounds.resize(n);
+      for (unsigned i = 0; i < n; i++) itemBounds[i] = boxes[items[i]];
+
+      centroids.clear();
+      centroids.shrink_to_fit();
+    }
+
+
+    void build(const std::vector<Segment_T> &segs, unsigned leafSize = 4,
+               unsigned threads = 1) {
+      std::vector<Rectangle_T> boxes;
+      boxes.reserve(segs.size());
+
+      for (auto &s : segs)
+        boxes.push_back(Rectangle_T(s.getStart(), s.getEnd()));
+
+      build(boxes, leafSize, threads);
+    }
+
+
+    /// Call @param cb with the index of each item overlapping @param box
+    template <typename CB>
+    void query(const Rectangle_T &box, CB cb) const {
+      traverse([&box] (const Rectangle_T &b) {return b.intersects(box);}, cb);
+    }
+
+
+    /// Call @param cb with the index of each item whose bounds @param seg hits
+    template <typename CB>
+    void query(const Segment_T &seg, CB cb) const {
+      traverse([&seg] (const Rectangle_T &b) {return intersects(b, seg);}, cb);
+    }
+
+
+    /// Call @param cb with the index of each item whose bounds a ray hits
+    template <typename CB>
+    void query(const Vector_T &origin, const Vector_T &dir, CB cb,
+               T maxDist = std::numeric_limits<T>::max()) const {
+      traverse([&] (const Rectangle_T &b) {
+        return intersects(b, origin, dir, 0, maxDist);
+      }, cb);
+    }
+
+
+    std::vector<unsigned> query(const Rectangle_T &box) const {
+      std::vector<unsigned> result;
+      query(box, [&result] (unsigned i) {result.push_back(i);});
+      return result;
+    }
+
+
+    std::vector<unsigned> query(const Segment_T &seg) const {
+      std::vector<unsigned> result;
+      query(seg, [&result] (unsigned i) {result.push_back(i);});
+      return result;
+    }
+
+
+    /**
+     * Find the @param k items nearest to @param p.  @param dist must return
+     * the exact distance from @param p to the item with the given index and
+     * never be less than the distance to the item's bounds.  Results are
+     * returned as (distance, index) pairs, nearest first.
+     */
+    template <typename DIST>
+    std::vector<std::pair<T, unsigned> >
+    nearest(const Vector_T &p, unsigned k, DIST dist) const {
+      typedef std::pair<T, unsigned> entry_t;
+      std::vector<entry_t> result;
+      if (nodes.empty() || !k) return result;
+
+      // Best first search over nodes ordered by distance to their bounds
+      std::priority_queue<entry_t, std::vector<entry_t>,
+                          std::greater<entry_t> > queue;
+      std::priority_queue<entry_t> best; // Max heap of the current k best
+
+      queue.push(entry_t(distance(nodes[0].bounds, p), 0));
+
+      while (!queue.empty()) {
+        entry_t top = queue.top();
+        queue.pop();
+
+        if (best.size() == k && best.top().first <= top.first) break;
+
+        const Node &node = nodes[top.second];
+
+        if (node.isLeaf()) {
+          for (unsigned i = 0; i < node.count; i++) {
+            unsigned item = items[node.offset + i];
+            T d = dist(item);
+
+            if (best.size() < k) best.push(entry_t(d, item));
+            else if (d < best.top().first) {
+              best.pop();
+              best.push(entry_t(d, item));
+            }
+          }
+
+        } else {
+          unsigned children[2] = {top.second + 1, node.offset};
+
+          for (unsigned i = 0; i < 2; i++) {
+            T d = distance(nodes[children[i]].bounds, p);
+            if (best.size() < k || d < best.top().first)
+              queue.push(entry_t(d, children[i]));
+          }
+        }
+      }
+
+      result.resize(best.size());
+      for (unsigned i = best.size(); i; i--) {
+        result[i - 1] = best.top();
+        best.pop();
+      }
+
+      return result;
+    }
+
+
+    /// Find the @param k segments from @param segs nearest to @param p
+    std::vector<std::pair<T, unsigned> >
+    nearest(const Vector_T &p, unsigned k,
+            const std::vector<Segment_T> &segs) const {
+      return nearest(p, k, [&] (unsigned i) {return segs[i].distance(p);});
+    }
+
+
+    static T distance(const Rectangle_T &box, const Vector_T &p) {
+      return box.contains(p) ? 0 : box.closestPoint(p).distance(p);
+    }
+
+
+    static bool intersects(const Rectangle_T &box, const Segment_T &seg) {
+      return intersects(box, seg.getStart(), seg.getEnd() - seg.getStart(),
+                        0, 1);
+    }
+
+
+    /// Slab test of the ray @param origin + t * @param dir, t in [t0, t1]
+    static bool intersects(const Rectangle_T &box, const Vector_T &origin,
+                           const Vector_T &dir, double t0, double t1) {
+      for (unsigned i = 0; i < DIM; i++) {
+        if (!dir[i]) {
+          if (origin[i] < box.rmin[i] || box.rmax[i] < origin[i])
+            return false;
+          continue;
+        }
+
+        double inv = 1.0 / (double)dir[i];
+        double tNear = ((double)box.rmin[i] - origin[i]) * inv;
+        double tFar = ((double)box.rmax[i] - origin[i]) * inv;
+        if (tFar < tNear) std::swap(tNear, tFar);
+
+        if (t0 < tNear) t0 = tNear;
+        if (tFar < t1) t1 = tFar;
+        if (t1 < t0) return false;
+      }
+
+      return true;
+    }
+
+
+  protected:
+    template <typename TEST, typename CB>
+    void traverse(TEST test, CB cb) const {
+      if (nodes.empty()) return;
+
+      unsigned stack[64];
+      std::vector<unsigned> overflow;
+      unsigned top = 0;
+      stack[top++] = 0;
+
+      while (top || !overflow.empty()) {
+        unsigned index;
+        if (overflow.empty()) index = stack[--top];
+        else {
+          index = overflow.back();
+          overflow.pop_back();
+        }
+
+        const Node &node = nodes[index];
+        if (!test(node.bounds)) continue;
+
+        if (node.isLeaf()) {
+          for (unsigned i = node.offset; i < node.offset + node.count; i++)
+            if (test(itemBounds[i])) cb(items[i]);
+
+        } else {
+          unsigned children[2] = {node.offset, index + 1};
+
+          for (unsigned i = 0; i < 2; i++)
+            if (top < 64) stack[top++] = children[i];
+            else overflow.push_back(children[i]);
+        }
+      }
+    }
+
+
+    static double area(const Rectangle_T &box) {
+      if (DIM == 1) return box.getDimension(0);
+
+      // Half the surface area, perimeter in 2D
+      double a = 0;
+      for (unsigned i = 0; i < DIM; i++) {
+        double face = 1;
+        for (unsigned j = 0; j < DIM; j++)
+          if (i != j) face *= box.getDimension(j);
+        a += face;
+      }
+
+      return a;
+    }
+
+
+    unsigned split(const std::vector<Rectangle_T> &boxes, unsigned begin,
+                   unsigned end) {
+      Rectangle_T cbounds;
+      for (unsigned i = begin; i < end; i++) cbounds.add(centroids[items[i]]);
+
+      unsigned axis = 0;
+      for (unsigned i = 1; i < DIM; i++)
+        if (cbounds.getDimension(axis) < cbounds.getDimension(i)) axis = i;
+
+      unsigned mid = (begin + end) / 2;
+      double extent = cbounds.getDimension(axis);
+
+      if (0 < extent) {
+        Rectangle_T binBounds[BINS];
+        unsigned binCounts[BINS] = {0};
+        double scale = BINS / extent;
+
+        auto binOf = [&] (unsigned item) {
+          unsigned b = (centroids[item][axis] - cbounds.rmin[axis]) * scale;
+          return b < BINS ? b : BINS - 1;
+        };
+
+        for (unsigned i = begin; i < end; i++) {
+          unsigned b = binOf(items[i]);
+          binCounts[b]++;
+          binBounds[b].add(boxes[items[i]]);
+        }
+
+        // Sweep from the right, then from the left, to cost each split
+        double rightCost[BINS];
+        Rectangle_T acc;
+        unsigned count = 0;
+
+        for (unsigned i = BINS - 1; i; i--) {
+          if (binCounts[i]) acc.add(binBounds[i]);
+          count += binCounts[i];
+          rightCost[i] = count ? area(acc) * count : 0;
+        }
+
+        double bestCost = std::numeric_limits<double>::max();
+        unsigned bestSplit = 0;
+        acc = Rectangle_T();
+        count = 0;
+
+        for (unsigned i = 0; i < BINS - 1; i++) {
+          if (binCounts[i]) acc.add(binBounds[i]);
+          count += binCounts[i];
+          if (!count || count == end - begin) continue;
+
+          double cost = area(acc) * count + rightCost[i + 1];
+          if (cost < bestCost) {
+            bestCost = cost;
+            bestSplit = i;
+          }
+        }
+
+        if (bestCost < std::numeric_limits<double>::max()) {
+          auto it = std::partition(
+            items.begin() + begin, items.begin() + end,
+            [&] (unsigned item) {return binOf(item) <= bestSplit;});
+
+          unsigned m = it - items.begin();
+          if (begin < m && m < end) return m;
+        }
+      }
+
+      // Fall back to a median split
+      std::nth_element(
+        items.begin() + begin, items.begin() + mid, items.begin() + end,
+        [&] (unsigned a, unsigned b) {
+          return centroids[a][axis] < centroids[b][axis];
+        });
+
+      return mid;
+    }
+
+
+    void build(const std::vector<Rectangle_T> &boxes, std::vector<Node> &out,
+               unsigned begin, unsigned end, unsigned leafSize,
+               unsigned threads) {
+      unsigned index = out.size();
+      out.push_back(Node());
+
+      Rectangle_T bounds;
+      for (unsigned i = begin; i < end; i++) bounds.add(boxes[items[i]]);
+      out[index].bounds = bounds;
+
+      if (end - begin <= leafSize) {
+        out[index].offset = begin;
+        out[index].count = end - begin;
+        return;
+      }
+
+      unsigned mid = split(boxes, begin, end);
+      out[index].count = 0;
+
+      // Subtrees cover disjoint item ranges so they can be built concurrently
+      if (1 < threads && 4096 < end - begin) {
+        std::vector<Node> right;
+        std::thread thread([&] {
+          build(boxes, right, mid, end, leafSize, threads / 2);
+        });
+
+        build(boxes, out, begin, mid, leafSize, threads - threads / 2);
+        thread.join();
+
+        unsigned base = out.size();
+        out[index].offset = base;
+        for (auto &node : right) {
+          if (!node.isLeaf()) node.offset += base;
+          out.push_back(node);
+        }
+
+      } else {
+        build(boxes, out, begin, mid, leafSize, 1);
+        out[index].offset = out.size();
+        build(boxes, out, mid, end, leafSize, 1);
+      }
+    }
+  };
+
+
+  typedef BVH<2, int> BVH2I;
+  typedef BVH<2, double> BVH2D;
+  typedef BVH<2, float> BVH2F;
+
+  typedef BVH<3, int> BVH3I;
+  typedef BVH<3, double> BVH3D;
+  typedef BVH<3, float> BVH3F;
+}
@@ -46,7 +46,8 @@ using namespace std;
 #define CBANG_LOG_PREFIX "CON" << getID() << ':'
 
 
-Conn::Conn(Event::Base &base) : Event::Connection(base) {}
+Conn::Conn(Event::Base &base) :
+  Event::Connection(base), flushEvent(base.newEvent([this] {flushOutput();})) {}
 Conn::~Conn() {}
 
 
@@ -74,6 +75,46 @@ void Conn::readChunks(
 }
 
 
+void Conn::uncork() {
+  if (!corked) THROW("Not corked");
+  if (!--corked && output.getLength()) flushEvent->activate();
+}
+
+
+void Conn::queueWrite(Event::Transfer::cb_t cb, const Event::Buffer &buf) {
+  LOG_DEBUG(4, CBANG_FUNC << "() length=" << buf.getLength() << " queued="
+            << output.getLength());
+
+  output.add(buf);
+  outputCBs.push_back(cb);
+
+  // Flush after the current event loop turn so that responses, chunks and
+  // continue lines written in the meantime go out in one gathered write
+  if (!corked) flushEvent->activate();
+}
+
+
+void Conn::flushOutput() {
+  if (corked || outputCBs.empty()) return;
+
+  LOG_DEBUG(4, CBANG_FUNC << "() length=" << output.getLength() << " writes="
+            << outputCBs.size());
+
+  Event::Buffer out;
+  out.add(output);
+
+  auto cbs = SmartPtr(new vector<Event::Transfer::cb_t>);
+  cbs->swap(outputCBs);
+
+  auto cb = [cbs] (bool success) {
+    for (auto &cb : *cbs)
+      if (cb) cb(success);
+  };
+
+  Event::Connection::write(cb, out);
+}
+
+
 void Conn::readChunk(
   const SmartPointer<Request> &req, uint32_t size, function<void (bool)> cb) {
   LOG_DEBUG(4, CBANG_FUNC << "() size=" << size);
@@ -159,6 +200,15 @@ void Conn::pop() {
 
 void Conn::close() {
   auto self = SmartPtr(this);
+
+  vector<Event::Transfer::cb_t> cbs;
+  cbs.swap(outputCBs);
+  output.clear();
+
   while (!requests.empty()) pop();
   Event::Connection::close();
+
+  // Fail unsent output last, the callbacks may call close() again
+  for (auto &cb: cbs)
+    if (cb) TRY_CATCH_ERROR(cb(false));
 }
@@ -39,6 +39,7 @@
 
 #include <limits>
 #include <list>
+#include <vector>
 #include <functional>
 
 
@@ -57,6 +58,12 @@ namespace cb {
       typedef std::list<SmartPointer<Request> > requests_t;
       requests_t requests;
 
+      // Output coalescing
+      unsigned corked = 0;
+      Event::Buffer output;
+      std::vector<Event::Transfer::cb_t> outputCBs;
+      SmartPointer<Event::Event> flushEvent;
+
     public:
       Conn(Event::Base &base);
       virtual ~Conn();
@@ -79,7 +86,19 @@ namespace cb {
       void readChunks(const SmartPointer<Request> &req,
                       std::function<void (bool)> cb);
 
+      /// Hold queued output until a matching uncork()
+      void cork() {corked++;}
+      void uncork();
+      bool isCorked() const {return corked;}
+
+      /// Queue output to be sent with other writes from this event loop turn
+      void queueWrite(Event::Transfer::cb_t cb, const Event::Buffer &buf);
+      void flushOutput();
+
     protected:
+      // All output goes through queueWrite() so it is sent in order
+      using Event::Connection::write;
+
       void readChunk(const SmartPointer<Request> &req, uint32_t size,
                      std::function<void (bool)> cb);
       void readChunkTrailer(const SmartPointer<Request> &req,
@@ -33,6 +33,7 @@
 #include "ConnIn.h"
 #include "Server.h"
 #include "Request.h"
+#include "RequestParser.h"
 
 #include <cbang/Catch.h>
 #include <cbang/event/Buffer.h>
@@ -40,6 +41,8 @@
 #include <cbang/ws/Websocket.h>
 #include <cbang/util/WeakCallback.h>
 
+#include <limits>
+
 using namespace cb::HTTP;
 using namespace cb;
 using namespace std;
@@ -49,7 +52,8 @@ using namespace std;
 
 
 ConnIn::ConnIn(Server &server) :
-  Conn(server.getBase()), server(server) {}
+  Conn(server.getBase()), server(server),
+  pipelineEvent(server.getBase().newEvent([this] {processPipelined();})) {}
 
 
 void ConnIn::writeRequest(
@@ -62,7 +66,16 @@ void ConnIn::writeRequest(
 
   if (getStats().isSet()) getStats()->event(req->getResponseCode().toString());
 
-  auto cb2 = [this, req, continueProcessing, cb] (bool success) {
+  // A pipelined request already buffered is processed without waiting for
+  // this write so that its response can be sent in the same write.  Input
+  // starts with the next header only once this request's body was read.
+  bool pipeline = false;
+  if (continueProcessing && req->isPersistent() && atHeader)
+    try {
+      pipeline = parseHeader();
+    } catch (const Exception &e) {} // Reported after this response is sent
+
+  auto cb2 = [this, req, continueProcessing, pipeline, cb] (bool success) {
     LOG_DEBUG(6, "Response " << (success ? "successful" : "failed")
               << " continueProcessing=" << continueProcessing
               << " persistent=" << req->isPersistent()
@@ -72,7 +85,7 @@ void ConnIn::writeRequest(
 
     // Handle write failure
     if (!success) return close();
-    if (!continueProcessing) return;
+    if (!continueProcessing || pipeline) return;
 
     if (getNumRequests()) pop();
 
@@ -84,53 +97,73 @@ void ConnIn::writeRequest(
     else readHeader();
   };
 
-  write(WeakCall(this, cb2), buffer);
+  queueWrite(WeakCall(this, cb2), buffer);
+
+  if (pipeline) {
+    pop();
+    cork();
+    pipelineEvent->activate();
+  }
+}
+
+
+void ConnIn::processPipelined() {
+  uncork();
+  if (isConnected()) processHeader();
 }
 
 
 void ConnIn::readHeader() {
   LOG_DEBUG(4, CBANG_FUNC << "()");
 
-  auto cb = [this] (bool success) {
-    if (maxHeaderSize && maxHeaderSize <= input.getLength())
-      error(HTTP_BAD_REQUEST, "Header too large");
+  atHeader = true;
+
+  try {
+    if (parseHeader()) return processHeader();
+  } catch (const Exception &e) {
+    return error(HTTP_BAD_REQUEST, e.getMessage());
+  }
 
-    else if (!success) close();
-    else processHeader();
+  auto cb = [this] (bool success) {
+    if (success) readHeader();
+    else close();
   };
 
-  // Read until end of header
-  read(WeakCall(this, cb), input, getMaxHeaderSize(), "\r\n\r\n");
+  // The parser consumed all input, wait for at least one more line.  One
+  // byte past the limit lets the parser report the header as too large.
+  unsigned length = maxHeaderSize ?
+    maxHeaderSize - parser.getSize() + 1 : numeric_limits<int>::max();
+  read(WeakCall(this, cb), input, length, "\n");
+}
+
+
+bool ConnIn::parseHeader() {
+  // Only bytes not yet seen by the parser are examined
+  parser.setMaxSize(maxHeaderSize);
+  return parser.parse(input);
 }
 
 
 void ConnIn::processHeader() {
   LOG_DEBUG(4, CBANG_FUNC << "()");
 
-  // Read first line
   Method method;
   URI uri;
   Version version;
-  try {
-    string line;
-    input.readLine(line, maxHeaderSize);
-    vector<string> parts;
-    String::tokenize(line, parts, " ");
+  auto hdrs = parser.getHeaders();
 
-    if (parts.size() != 3)
-      THROW("Invalid request line: " << String::escapeC(line));
-
-    method = Method::parse(parts[0]);
-    uri = parts[1];
-    version = Request::parseHTTPVersion(parts[2]);
+  try {
+    method = Method::parse(parser.getMethod());
+    uri = parser.getURI();
+    version = Request::parseHTTPVersion(parser.getVersion());
 
   } catch (const Exception &e) {
+    parser.reset();
     return error(HTTP_BAD_REQUEST, e.getMessage());
   }
 
-  // Read header block
-  auto hdrs = SmartPtr(new Headers);
-  if (!hdrs->parse(input)) return error(HTTP_BAD_REQUEST, "Incomplete headers");
+  parser.reset();
+  atHeader = false;
 
   // Create new request (Don't create circular dependency)
   auto req = server.createRequest({this, method, uri, version, hdrs});
@@ -153,7 +186,7 @@ void ConnIn::processHeader() {
           else error(HTTP_BAD_REQUEST, "Failed to send continue");
         };
 
-        write(WeakCall(this, cb), line);
+        queueWrite(WeakCall(this, cb), line);
         return;
 
       } else return error(HTTP_EXPECTATION_FAILED, "Cannot continue");
@@ -223,6 +256,7 @@ void ConnIn::processRequest(const SmartPointer<Request> &req) {
 
 
 void ConnIn::processIfNext(const SmartPointer<Request> &req) {
+  atHeader = true; // The request body, if any, has been read
   if (getNumRequests() && getRequest() == req) processRequest(req);
   // TODO Should read the next request in parallel if persistent connection
 }
@@ -34,12 +34,18 @@
 
 #include "Conn.h"
 #include "Status.h"
+#include "RequestParser.h"
 
 
 namespace cb {
   namespace HTTP {
     class ConnIn : public Conn {
       Server &server;
+      SmartPointer<Event::Event> pipelineEvent;
+
+      // Parses the next request header as its bytes arrive
+      RequestParser parser;
+      bool atHeader = true; // Input starts with a request header
 
     public:
       ConnIn(Server &server);
@@ -57,6 +63,8 @@ namespace cb {
       void onConnect(bool success) override {readHeader();}
 
     protected:
+      void processPipelined();
+      bool parseHeader();
       void processHeader();
       void checkChunked(const SmartPointer<Request> &req);
       void processRequest(const SmartPointer<Request> &req);
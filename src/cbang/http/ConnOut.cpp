@@ -71,7 +71,7 @@ void ConnOut::writeRequest(
     if (continueProcessing) readHeader(req);
   };
 
-  write(WeakCall(this, cb2), buffer);
+  queueWrite(WeakCall(this, cb2), buffer);
 }
 
 
@@ -37,6 +37,7 @@
 #include <cbang/String.h>
 #include <cbang/Errors.h>
 #include <cbang/event/Buffer.h>
+#include <cbang/json/Codec.h>
 
 using namespace cb::HTTP;
 using namespace std;
@@ -67,6 +68,18 @@ const string &Headers::get(
 }
 
 
+void Headers::add(const string &key, const string &value) {
+  // See RFC 2616 Section 4.2 "Message Headers"
+  auto it = HeadersImpl::find(key);
+  if (it != end()) {
+    auto &h = it.value();
+    if (!String::trim(h).empty()) h += ", ";
+    h += value;
+
+  } else insert(key, value);
+}
+
+
 void Headers::remove(const string &key) {erase(key);}
 
 
@@ -91,6 +104,13 @@ bool Headers::isJSONContentType() const {
 }
 
 
+bool Headers::isBinaryJSONContentType() const {
+  JSON::Encoding encoding;
+  return JSON::Codec::parseContentType(getContentType(), encoding) &&
+    encoding != JSON::Encoding::ENCODING_JSON;
+}
+
+
 void Headers::setContentType(const string &contentType) {
   insert("Content-Type", contentType);
 }
@@ -135,17 +155,7 @@ bool Headers::parse(Event::Buffer &buf, unsigned maxSize) {
     if (semi == string::npos) THROW("Invalid header line: " << line);
 
     string key = line.substr(0, semi);
-    string value = String::trim(line.substr(semi + 1));
-
-    // See RFC 2616 Section 4.2 "Message Headers"
-    auto it = HeadersImpl::find(key);
-    if (it != end()) {
-      auto &h = it.value();
-      if (!String::trim(h).empty()) h += ", ";
-      h += value;
-
-    } else insert(key, value);
-
+    add(key, String::trim(line.substr(semi + 1)));
     last = key;
   }
 
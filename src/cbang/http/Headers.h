@@ -57,12 +57,15 @@ namespace cb {
         const std::string &key, const std::string &defaultValue) const;
       void set(const std::string &key, const std::string &value)
         {insert(key, value);}
+      void add(const std::string &key, const std::string &value);
       void remove(const std::string &key);
       bool keyContains(const std::string &key, const std::string &value) const;
 
       bool hasContentType() const {return !getContentType().empty();}
       std::string getContentType() const;
       bool isJSONContentType() const;
+      /// @return true for CBOR and MessagePack
+      bool isBinaryJSONContentType() const;
       void setContentType(const std::string &contentType);
       void guessContentType(const std::string &ext);
       bool needsClose() const;
@@ -44,6 +44,7 @@
 #include <cbang/openssl/SSL.h>
 #include <cbang/log/Logger.h>
 #include <cbang/json/JSON.h>
+#include <cbang/json/Codec.h>
 #include <cbang/time/Time.h>
 #include <cbang/util/Regex.h>
 #include <cbang/comp/CompressionFilter.h>
@@ -333,6 +334,11 @@ bool Request::isJSONContentType() const {
 }
 
 
+bool Request::isBinaryJSONContentType() const {
+  return outputHeaders.isSet() && outputHeaders->isBinaryJSONContentType();
+}
+
+
 void Request::setContentType(const string &contentType) {
   getOutputHeaders().setContentType(contentType);
 }
@@ -459,18 +465,32 @@ string Request::getInput()  const {return inputBuffer.toString();}
 string Request::getOutput() const {return outputBuffer.toString();}
 
 
+JSON::Encoding Request::getJSONEncoding() const {
+  if (!isIncoming() || inputHeaders.isNull())
+    return JSON::Encoding::ENCODING_JSON;
+  return JSON::Codec::negotiate(inputHeaders->find("Accept"));
+}
+
+
 SmartPointer<JSON::Value> Request::getInputJSON() const {
   Event::Buffer buf = inputBuffer;
   if (!buf.getLength()) return 0;
   Event::BufferStream<> stream(buf);
-  return JSON::Reader(stream).parse();
+
+  JSON::Encoding encoding = JSON::Encoding::ENCODING_JSON;
+  if (inputHeaders.isSet() && inputHeaders->hasContentType())
+    JSON::Codec::parseContentType(inputHeaders->getContentType(), encoding);
+
+  return JSON::Codec::parse(encoding, stream);
 }
 
 
 const SmartPointer<JSON::Value> &Request::getJSONMessage() {
   if (msg.isNull()) {
     const Headers &hdrs = getInputHeaders();
-    if (hdrs.hasContentType() && hdrs.isJSONContentType()) msg = getInputJSON();
+
+    if (hdrs.isJSONContentType() || hdrs.isBinaryJSONContentType())
+      msg = getInputJSON();
   }
 
   return msg;
@@ -516,7 +536,8 @@ void Request::sendJSONError(Status code, const string &msg) {
 
 
 void Request::sendError(Status code, const string &msg) {
-  if (isJSONContentType()) return sendJSONError(code, msg);
+  if (isJSONContentType() || isBinaryJSONContentType())
+    return sendJSONError(code, msg);
 
   outSet("Content-Type", "text/plain");
   outSet("Connection", "close");
@@ -536,7 +557,7 @@ void Request::sendError(Status code) {
 
 
 void Request::sendError(Status code, const Exception &e) {
-  if (isJSONContentType()) {
+  if (isJSONContentType() || isBinaryJSONContentType()) {
     reply(code, [&] (JSON::Sink &sink) {
       sink.beginDict();
       sink.beginInsert("error");
@@ -561,16 +582,17 @@ void Request::sendError(const exception &e) {
 void Request::send(function<void (JSON::Sink &sink)> cb) {
   outputBuffer.clear();
 
+  JSON::Encoding encoding = getJSONEncoding();
   Event::Buffer buffer;
   Event::BufferStream<> stream(buffer);
-  JSON::Writer writer(stream, 0, true);
+  auto writer = JSON::Codec::createWriter(encoding, stream);
 
-  cb(writer);
+  cb(*writer);
 
-  writer.close();
+  writer->close();
   stream.flush();
 
-  setContentType("application/json");
+  setContentType(JSON::Codec::getContentType(encoding));
   send(buffer);
 }
 
@@ -592,6 +614,13 @@ void Request::reply(Status::enum_t code, write_cb_t cb) {
   if (replying) THROW("Request already replying");
 
   responseCode = code ? code : (Status::enum_t)HTTP_INTERNAL_SERVER_ERROR;
+
+  if (replyCB) {
+    auto onReply = replyCB;
+    replyCB = 0;
+    onReply();
+  }
+
   write(cb);
   replying = true;
 }
@@ -654,7 +683,7 @@ void Request::sendChunk(function<void (JSON::Sink &sink)> cb) {
 }
 
 
-void Request::sendChunk(const Event::Buffer &buf) {
+void Request::sendChunk(const Event::Buffer &buf, function<void (bool)> cb) {
   if (!chunked) THROW("Not chunked");
 
   LOG_DEBUG(4, "Sending " << buf.getLength() << " byte chunk");
@@ -662,14 +691,17 @@ void Request::sendChunk(const Event::Buffer &buf) {
   // Check for final empty chunk.  Must be before add() below
   if (!buf.getLength()) chunked = false;
 
-  if (connection.isNull()) return; // Ignore write
+  if (connection.isNull()) { // Ignore write
+    if (cb) cb(false);
+    return;
+  }
 
   Event::Buffer out;
   out.add(String::printf("%x\r\n", buf.getLength()));
   out.add(buf);
   out.add("\r\n");
 
-  connection->writeRequest(this, out, !chunked);
+  connection->writeRequest(this, out, !chunked, cb);
 }
 
 
@@ -783,8 +815,9 @@ void Request::writeResponse(Event::Buffer &buf) {
       outSet("Content-Length", String(outputBuffer.getLength()));
   }
 
-  // Don't reply with empty JSON
-  if (outputBuffer.isEmpty() && isJSONContentType())
+  // Don't reply with empty JSON, chunked data follows the headers
+  if (outputBuffer.isEmpty() && !chunked &&
+      (isJSONContentType() || isBinaryJSONContentType()))
     outRemove("Content-Type");
 
   // Add Content-Type
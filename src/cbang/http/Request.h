@@ -42,6 +42,7 @@
 #include <cbang/net/SockAddr.h>
 #include <cbang/json/Value.h>
 #include <cbang/json/Writer.h>
+#include <cbang/json/Encoding.h>
 #include <cbang/comp/Compression.h>
 #include <cbang/debug/Demangle.h>
 
@@ -86,6 +87,7 @@ namespace cb {
       JSON::ValuePtr msg;
 
       std::function<void ()> completeCB;
+      std::function<void ()> replyCB;
 
     public:
       Request(const RequestParams &params);
@@ -192,6 +194,7 @@ namespace cb {
       bool hasContentType() const;
       std::string getContentType() const;
       bool isJSONContentType() const;
+      bool isBinaryJSONContentType() const;
       void setContentType(const std::string &contentType);
       void guessContentType();
 
@@ -211,6 +214,8 @@ namespace cb {
       std::string getInput() const;
       std::string getOutput() const;
 
+      /// @return the JSON encoding negotiated from the Accept header
+      JSON::Encoding getJSONEncoding() const;
       SmartPointer<JSON::Value> getInputJSON() const;
       void setJSONMessage(const SmartPointer<JSON::Value> &msg)
         {this->msg = msg;}
@@ -219,6 +224,11 @@ namespace cb {
       void setOnComplete(std::function<void ()> cb) {this->completeCB = cb;}
       std::function<void ()> getOnComplete() {return completeCB;}
 
+      // Called once, just before the reply is written, while the response
+      // code, headers and output buffer can still be inspected.
+      void setOnReply(std::function<void ()> cb) {this->replyCB = cb;}
+      std::function<void ()> getOnReply() {return replyCB;}
+
       SmartPointer<std::istream> getInputStream() const;
       SmartPointer<std::ostream>
       getOutputStream(Compression compression = COMPRESSION_NONE);
@@ -251,7 +261,8 @@ namespace cb {
 
       void startChunked(Status code = HTTP_OK);
       void sendChunk(std::function<void (JSON::Sink &sink)> cb);
-      void sendChunk(const Event::Buffer &buf);
+      void sendChunk(const Event::Buffer &buf,
+                     std::function<void (bool)> cb = 0);
       void sendChunk(const char *data, unsigned length);
       void endChunked();
 
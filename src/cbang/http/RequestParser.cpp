@@ -0,0 +1,297 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "RequestParser.h"
+
+#include <cbang/Exception.h>
+#include <cbang/event/Buffer.h>
+
+#include <cctype>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <event2/util.h>   // For iovec
+#include <event2/buffer.h> // For evbuffer_iovec on Windows
+
+using namespace std;
+using namespace cb;
+using namespace cb::HTTP;
+
+
+namespace {
+  enum {
+    TOKEN_CHAR = 1 << 0, // RFC 7230 tchar
+    URI_CHAR   = 1 << 1, // Visible ASCII and obs-text
+    VALUE_CHAR = 1 << 2, // VCHAR, SP, HTAB and obs-text
+  };
+
+
+  struct CharTable {
+    uint8_t table[256];
+
+    CharTable() {
+      for (unsigned c = 0; c < 256; c++) {
+        uint8_t flags = 0;
+
+        if ((0x21 <= c && c < 0x7f) || 0x80 <= c) flags |= URI_CHAR;
+        if (flags & URI_CHAR || c == ' ' || c == '\t') flags |= VALUE_CHAR;
+
+        if (isalnum(c) || (c && strchr("!#$%&'*+-.^_`|~", c)))
+          flags |= TOKEN_CHAR;
+
+        table[c] = flags;
+      }
+    }
+
+    bool is(char c, uint8_t flags) const {return table[(uint8_t)c] & flags;}
+  };
+
+
+  const CharTable chars;
+
+
+  const char *scan(const char *p, const char *end, uint8_t flags) {
+    while (p < end && chars.is(*p, flags)) p++;
+    return p;
+  }
+
+
+#ifdef __SSE2__
+  // Skip 16 bytes at a time while none are control characters, SP or DEL.
+  // Bytes 0x80-0xff are negative as signed chars and so never match.
+  // @param allowSpace also accepts SP and HTAB, as in header values.
+  const char *scanVisible(const char *p, const char *end, bool allowSpace) {
+    const __m128i positive = _mm_set1_epi8(-1);
+    const __m128i limit = _mm_set1_epi8(allowSpace ? 0x20 : 0x21);
+    const __m128i tab = _mm_set1_epi8(allowSpace ? '\t' : 0x7f);
+    const __m128i del = _mm_set1_epi8(0x7f);
+
+    while (16 <= end - p) {
+      __m128i x = _mm_loadu_si128((const __m128i *)p);
+      __m128i ctrl = _mm_and_si128(_mm_cmpgt_epi8(x, positive),
+                                   _mm_cmplt_epi8(x, limit));
+      ctrl = _mm_andnot_si128(_mm_cmpeq_epi8(x, tab), ctrl);
+      int mask = _mm_movemask_epi8(_mm_or_si128(ctrl, _mm_cmpeq_epi8(x, del)));
+      if (mask) return p + __builtin_ctz(mask);
+      p += 16;
+    }
+
+    return p;
+  }
+#endif // __SSE2__
+
+
+  const char *scanURI(const char *p, const char *end) {
+#ifdef __SSE2__
+    p = scanVisible(p, end, false);
+#endif
+    return scan(p, end, URI_CHAR);
+  }
+
+
+  const char *scanValue(const char *p, const char *end) {
+#ifdef __SSE2__
+    p = scanVisible(p, end, true);
+#endif
+    return scan(p, end, VALUE_CHAR);
+  }
+
+
+  void expectLF(char c, const char *what) {
+    if (c != '\n') THROW("Expected LF after " << what);
+  }
+}
+
+
+RequestParser::RequestParser(unsigned maxSize) : maxSize(maxSize) {reset();}
+
+
+void RequestParser::reset() {
+  size = 0;
+  state = METHOD;
+  method.clear();
+  uri.clear();
+  version.clear();
+  name.clear();
+  value.clear();
+  headers = new Headers;
+  error.clear();
+}
+
+
+unsigned RequestParser::parse(const char *data, unsigned length) {
+  if (state == FAILED) THROW(error);
+
+  try {
+    return step(data, length);
+
+  } catch (const Exception &e) {
+    state = FAILED;
+    error = e.getMessage();
+    throw;
+  }
+}
+
+
+unsigned RequestParser::step(const char *data, unsigned length) {
+  const char *p = data;
+  const char *end = data + length;
+
+  while (p < end && state != DONE) {
+    const char *start = p;
+
+    switch (state) {
+    case METHOD:
+      // Ignore empty lines before the request line, see RFC 7230 3.5
+      if (method.empty() && (*p == '\r' || *p == '\n')) {p++; break;}
+
+      p = scan(p, end, TOKEN_CHAR);
+      method.append(start, p - start);
+      if (p == end) break;
+      if (*p != ' ' || method.empty()) THROW("Invalid request method");
+      p++;
+      state = URI;
+      break;
+
+    case URI:
+      p = scanURI(p, end);
+      uri.append(start, p - start);
+      if (p == end) break;
+      if (*p != ' ' || uri.empty()) THROW("Invalid request URI");
+      p++;
+      state = VERSION;
+      break;
+
+    case VERSION:
+      p = scan(p, end, URI_CHAR);
+      version.append(start, p - start);
+      if (p == end) break;
+      if (version.empty() || (*p != '\r' && *p != '\n'))
+        THROW("Invalid request line");
+      // Bare LF line endings are accepted, see RFC 7230 3.5
+      state = *p++ == '\r' ? LINE_END : FIELD_START;
+      break;
+
+    case LINE_END:
+      expectLF(*p++, "request line");
+      state = FIELD_START;
+      break;
+
+    case FIELD_START:
+      if (*p == ' ' || *p == '\t') {
+        // Obsolete line folding, replace with a single space
+        if (name.empty()) THROW("Invalid header continuation line");
+        if (!value.empty()) value += ' ';
+        state = VALUE_START;
+        break;
+      }
+
+      if (!name.empty()) addField();
+
+      if (*p == '\r') {
+        p++;
+        state = HEADER_END;
+
+      } else if (*p == '\n') {
+        p++;
+        state = DONE;
+
+      } else state = FIELD_NAME;
+      break;
+
+    case FIELD_NAME:
+      p = scan(p, end, TOKEN_CHAR);
+      name.append(start, p - start);
+      if (p == end) break;
+      if (*p != ':' || name.empty()) THROW("Invalid header name");
+      p++;
+      state = VALUE_START;
+      break;
+
+    case VALUE_START:
+      while (p < end && (*p == ' ' || *p == '\t')) p++;
+      if (p < end) state = VALUE;
+      break;
+
+    case VALUE:
+      p = scanValue(p, end);
+      value.append(start, p - start);
+      if (p == end) break;
+      if (*p != '\r' && *p != '\n')
+        THROW("Invalid character in header '" << name << "'");
+      state = *p++ == '\r' ? FIELD_END : FIELD_START;
+      break;
+
+    case FIELD_END:
+      expectLF(*p++, "header line");
+      state = FIELD_START;
+      break;
+
+    case HEADER_END:
+      expectLF(*p++, "header");
+      state = DONE;
+      break;
+
+    case DONE: case FAILED: break;
+    }
+  }
+
+  unsigned bytes = p - data;
+  size += bytes;
+  if (maxSize && maxSize < size) THROW("Header too large");
+
+  return bytes;
+}
+
+
+bool RequestParser::parse(Event::Buffer &buf) {
+  while (!isDone() && buf.getLength()) {
+    iovec space;
+    buf.peek(buf.getLength(), space);
+    buf.drain(parse((const char *)space.iov_base, space.iov_len));
+  }
+
+  return isDone();
+}
+
+
+void RequestParser::addField() {
+  size_t len = value.find_last_not_of(" \t");
+  value.resize(len == string::npos ? 0 : len + 1);
+
+  headers->add(name, value);
+  name.clear();
+  value.clear();
+}
@@ -0,0 +1,111 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Headers.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+
+
+namespace cb {
+  namespace Event {class Buffer;}
+
+  namespace HTTP {
+    /**
+     * Incremental single pass HTTP/1.x request header parser.
+     *
+     * Input may be fed in arbitrary pieces.  Each byte is examined once,
+     * runs of valid characters are found with a character class table, 16
+     * bytes at a time with SSE2 where available, and appended to the current
+     * field in bulk.  Lines may end in CRLF or a bare LF.  Throws on
+     * malformed input, and again on every later call until reset().
+     */
+    class RequestParser {
+    public:
+      typedef enum {
+        METHOD,
+        URI,
+        VERSION,
+        LINE_END,
+        FIELD_START,
+        FIELD_NAME,
+        VALUE_START,
+        VALUE,
+        FIELD_END,
+        HEADER_END,
+        DONE,
+        FAILED,
+      } state_t;
+
+    protected:
+      unsigned maxSize;
+      unsigned size = 0;
+      state_t state = METHOD;
+
+      std::string method;
+      std::string uri;
+      std::string version;
+      std::string name;
+      std::string value;
+      SmartPointer<Headers> headers;
+      std::string error;
+
+    public:
+      RequestParser(unsigned maxSize = 0);
+
+      state_t getState() const {return state;}
+      bool isDone() const {return state == DONE;}
+      unsigned getSize() const {return size;}
+      unsigned getMaxSize() const {return maxSize;}
+      void setMaxSize(unsigned maxSize) {this->maxSize = maxSize;}
+
+      const std::string &getMethod() const {return method;}
+      const std::string &getURI() const {return uri;}
+      const std::string &getVersion() const {return version;}
+      const SmartPointer<Headers> &getHeaders() const {return headers;}
+
+      void reset();
+
+      /// @return the number of bytes consumed, stops at the end of the header
+      unsigned parse(const char *data, unsigned length);
+      /// Consume header bytes from @param buf, @return true when done
+      bool parse(Event::Buffer &buf);
+
+    protected:
+      unsigned step(const char *data, unsigned length);
+      void addField();
+    };
+  }
+}
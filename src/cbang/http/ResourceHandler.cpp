@@ -32,10 +32,13 @@
 
 #include "ResourceHandler.h"
 #include "Request.h"
+#include "ContentTypes.h"
 
 #include <cbang/String.h>
 #include <cbang/util/ResourceManager.h>
 
+#include <vector>
+
 using namespace std;
 using namespace cb;
 using namespace cb::HTTP;
@@ -53,7 +56,47 @@ bool ResourceHandler::operator()(Request &req) {
 
   if (!res || res->isDirectory()) return false;
 
-  req.reply(HTTP_OK, res->getData(), res->getLength());
+  // Prefer the built-in table so types match those guessed from the URI
+  string type = ContentTypes::guess(res->getName(), "");
+  if (type.empty() && res->getContentType()) type = res->getContentType();
+  if (!type.empty()) req.setContentType(type);
+
+  const char *etag = res->getETag();
+  if (etag) {
+    req.outSet("ETag", etag);
+
+    if (req.inHas("If-None-Match")) {
+      vector<string> tags;
+      String::tokenize(req.inGet("If-None-Match"), tags, ", \t");
+
+      for (auto &tag : tags)
+        if (tag == etag || tag == "*") {
+          req.reply(HTTP_NOT_MODIFIED);
+          return true;
+        }
+    }
+  }
+
+  bool gzip = false;
+  if (res->getGZipData()) {
+    req.outSet("Vary", "Accept-Encoding");
+    gzip = req.getRequestedCompression() == Compression::COMPRESSION_GZIP;
+    if (gzip) req.outSetContentEncoding(Compression::COMPRESSION_GZIP);
+  }
+
+  const char *data = gzip ? res->getGZipData() : res->getData();
+  unsigned length = gzip ? res->getGZipLength() : res->getLength();
+
+  // Resource data is static or owned by the bundle, reference it rather than
+  // copy.  Bundle data must stay mapped until the response has been sent.
+  Event::Buffer buf;
+  if (bundle.isSet()) {
+    auto bundle = this->bundle;
+    buf.addRef(data, length, [bundle] {});
+
+  } else buf.addRef(data, length);
+
+  req.reply(HTTP_OK, buf);
 
   return true;
 }
@@ -34,7 +34,7 @@
 
 #include "RequestHandler.h"
 
-#include <cbang/util/Resource.h>
+#include <cbang/util/ResourceBundle.h>
 
 
 namespace cb {
@@ -43,10 +43,14 @@ namespace cb {
 
     class ResourceHandler : public RequestHandler {
       const Resource &root;
+      SmartPointer<ResourceBundle> bundle;
 
     public:
       ResourceHandler(const Resource &root) : root(root) {}
       ResourceHandler(const std::string &path);
+      /// Responses hold a reference to @param bundle until they are sent
+      ResourceHandler(const SmartPointer<ResourceBundle> &bundle) :
+        root(*bundle), bundle(bundle) {}
 
       // From RequestHandler
       bool operator()(Request &req) override;
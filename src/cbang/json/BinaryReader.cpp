@@ -0,0 +1,117 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "BinaryReader.h"
+#include "Builder.h"
+
+#include <cbang/SStream.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+ValuePtr BinaryReader::parse() {
+  Builder builder;
+  parse(builder);
+  return builder.getRoot();
+}
+
+
+uint8_t BinaryReader::get() {
+  int c = stream.get();
+  if (c == char_traits<char>::eof()) error("Unexpected end of input");
+  offset++;
+  return (uint8_t)c;
+}
+
+
+uint8_t BinaryReader::peek() {
+  int c = stream.peek();
+  if (c == char_traits<char>::eof()) error("Unexpected end of input");
+  return (uint8_t)c;
+}
+
+
+uint64_t BinaryReader::getBE(unsigned bytes) {
+  uint8_t data[8];
+  stream.read((char *)data, bytes);
+  if ((unsigned)stream.gcount() != bytes) error("Unexpected end of input");
+  offset += bytes;
+
+  uint64_t value = 0;
+  for (unsigned i = 0; i < bytes; i++) value = value << 8 | data[i];
+  return value;
+}
+
+
+float BinaryReader::getFloat() {
+  uint32_t bits = getBE(4);
+  float value;
+  memcpy(&value, &bits, 4);
+  return value;
+}
+
+
+double BinaryReader::getDouble() {
+  uint64_t bits = getBE(8);
+  double value;
+  memcpy(&value, &bits, 8);
+  return value;
+}
+
+
+string BinaryReader::getString(uint64_t length) {
+  string s;
+
+  // Read in blocks so a corrupt length cannot cause a huge allocation
+  while (s.length() < length) {
+    size_t size = s.length();
+    size_t block = min<uint64_t>(length - size, 1 << 16);
+
+    s.resize(size + block);
+    stream.read(&s[size], block);
+    offset += stream.gcount();
+
+    if ((size_t)stream.gcount() != block) error("Unexpected end of input");
+  }
+
+  return s;
+}
+
+
+void BinaryReader::error(const string &msg) const {
+  throw ParseError(SSTR(msg << " at offset " << offset),
+                   FileLocation(src.getName()));
+}
@@ -0,0 +1,72 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Value.h"
+
+#include <cbang/io/InputSource.h>
+
+#include <string>
+
+
+namespace cb {
+  namespace JSON {
+    class Sink;
+
+    /// Base for binary encoding readers
+    class BinaryReader {
+    protected:
+      InputSource src;
+      std::istream &stream;
+      uint64_t offset = 0;
+
+    public:
+      BinaryReader(const InputSource &src) : src(src), stream(src) {}
+      virtual ~BinaryReader() {}
+
+      uint64_t getOffset() const {return offset;}
+
+      virtual void parse(Sink &sink, unsigned depth = 0) = 0;
+      ValuePtr parse();
+
+      uint8_t get();
+      uint8_t peek();
+      uint64_t getBE(unsigned bytes);
+      float getFloat();
+      double getDouble();
+      std::string getString(uint64_t length);
+
+      void error(const std::string &msg) const;
+    };
+  }
+}
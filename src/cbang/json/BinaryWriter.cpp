@@ -0,0 +1,85 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "BinaryWriter.h"
+
+#include <cbang/Catch.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace cb::JSON;
+
+
+BinaryWriter::~BinaryWriter() {TRY_CATCH_ERROR(close());}
+
+
+void BinaryWriter::close() {
+  NullSink::close();
+  flush();
+  stream.flush();
+}
+
+
+void BinaryWriter::reset() {
+  NullSink::reset();
+  buffer.clear();
+}
+
+
+void BinaryWriter::putBE(uint64_t value, unsigned bytes) {
+  char data[8];
+  for (unsigned i = 0; i < bytes; i++)
+    data[i] = (char)(value >> (8 * (bytes - i - 1)));
+  put(data, bytes);
+}
+
+
+void BinaryWriter::putFloat(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, 4);
+  putBE(bits, 4);
+}
+
+
+void BinaryWriter::putDouble(double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, 8);
+  putBE(bits, 8);
+}
+
+
+void BinaryWriter::flush() {
+  if (getDepth() || buffer.empty()) return;
+  stream.write(buffer.data(), buffer.size());
+  buffer.clear();
+}
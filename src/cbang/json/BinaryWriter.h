@@ -0,0 +1,69 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "NullSink.h"
+
+#include <string>
+#include <ostream>
+
+
+namespace cb {
+  namespace JSON {
+    /// Base for binary encoding Sinks.  Output is collected in a buffer and
+    /// written to the stream once each top-level value is complete.
+    class BinaryWriter : public NullSink {
+    protected:
+      std::ostream &stream;
+      std::string buffer;
+
+    public:
+      BinaryWriter(std::ostream &stream, bool allowDuplicates = false) :
+        NullSink(allowDuplicates), stream(stream) {}
+      ~BinaryWriter();
+
+      // From NullSink
+      void close() override;
+      void reset() override;
+
+    protected:
+      void put(uint8_t c) {buffer.push_back((char)c);}
+      void put(const void *data, unsigned length)
+      {buffer.append((const char *)data, length);}
+      void putBE(uint64_t value, unsigned bytes);
+      void putFloat(float value);
+      void putDouble(double value);
+      void flush();
+    };
+  }
+}
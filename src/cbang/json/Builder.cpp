@@ -38,7 +38,8 @@ using namespace cb;
 using namespace cb::JSON;
 
 
-Builder::Builder(const ValuePtr &root) : root(root) {}
+Builder::Builder(const ValuePtr &root, const Factory *factory) :
+  factory(factory ? factory : this), root(root) {}
 
 
 ValuePtr Builder::build(function<void (Sink &sink)> cb) {
@@ -62,16 +63,16 @@ void Builder::reset() {
 }
 
 
-void Builder::writeNull()                {add(createNull());}
-void Builder::writeBoolean(bool value)   {add(createBoolean(value));}
-void Builder::write(double value)        {add(create(value));}
-void Builder::write(uint64_t value)      {add(create(value));}
-void Builder::write(int64_t value)       {add(create(value));}
-void Builder::write(const string &value) {add(create(value));}
+void Builder::writeNull()                {add(factory->createNull());}
+void Builder::writeBoolean(bool value) {add(factory->createBoolean(value));}
+void Builder::write(double value)        {add(factory->create(value));}
+void Builder::write(uint64_t value)      {add(factory->create(value));}
+void Builder::write(int64_t value)       {add(factory->create(value));}
+void Builder::write(const string &value) {add(factory->create(value));}
 
 
 bool Builder::inList() const {return !stack.empty() && stack.back()->isList();}
-void Builder::beginList(bool simple) {add(createList());}
+void Builder::beginList(bool simple) {add(factory->createList());}
 
 
 void Builder::beginAppend() {
@@ -89,7 +90,7 @@ void Builder::endList() {
 
 
 bool Builder::inDict() const {return !stack.empty() && stack.back()->isDict();}
-void Builder::beginDict(bool simple) {add(createDict());}
+void Builder::beginDict(bool simple) {add(factory->createDict());}
 
 
 bool Builder::has(const string &key) const {
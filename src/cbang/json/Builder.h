@@ -43,6 +43,7 @@
 namespace cb {
   namespace JSON {
     class Builder : public Factory, public Sink {
+      const Factory *factory;
       std::vector<ValuePtr> stack;
       ValuePtr root;
       bool appendNext = false;
@@ -50,12 +51,16 @@ namespace cb {
       std::string nextKey;
 
     public:
-      Builder(const ValuePtr &root = 0);
+      Builder(const ValuePtr &root = 0, const Factory *factory = 0);
 
       static ValuePtr build(std::function<void (Sink &sink)> cb);
 
       ValuePtr getRoot() const {return root;}
 
+      const Factory &getFactory() const {return *factory;}
+      void setFactory(const Factory *factory)
+      {this->factory = factory ? factory : this;}
+
       // From Sink
       unsigned getDepth() const override {return stack.size();}
       void close() override;
@@ -0,0 +1,203 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "CBORReader.h"
+#include "Sink.h"
+
+#include <cbang/String.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  const uint8_t INDEFINITE = 31;
+  const uint8_t BREAK = 0xff;
+
+
+  double halfToDouble(uint16_t half) {
+    int exp = (half >> 10) & 0x1f;
+    int mant = half & 0x3ff;
+    double value;
+
+    if (!exp) value = ldexp(mant, -24);
+    else if (exp != 31) value = ldexp(mant + 1024, exp - 25);
+    else value = mant ? NAN : INFINITY;
+
+    return (half & 0x8000) ? -value : value;
+  }
+}
+
+
+ValuePtr CBORReader::parse(const InputSource &src) {
+  return CBORReader(src).parse();
+}
+
+
+void CBORReader::parse(const InputSource &src, Sink &sink) {
+  CBORReader(src).parse(sink);
+}
+
+
+void CBORReader::parse(Sink &sink, unsigned depth) {
+  if (1000 < ++depth) error("Maximum CBOR parse depth reached");
+
+  uint8_t c = get();
+  uint8_t major = c >> 5;
+  uint8_t info = c & 31;
+
+  switch (major) {
+  case 0: return sink.write(getArgument(info));
+
+  case 1: {
+    uint64_t arg = getArgument(info);
+    if (arg <= (uint64_t)numeric_limits<int64_t>::max())
+      return sink.write(-(int64_t)arg - 1);
+    return sink.write(-1.0 - (double)arg);
+  }
+
+  case 2: case 3: return sink.write(parseString(major, info));
+  case 4: return parseList(sink, info, depth);
+  case 5: return parseDict(sink, info, depth);
+  case 6: getArgument(info); return parse(sink, depth); // Skip tag
+  default: return parseSimple(sink, info);
+  }
+}
+
+
+uint64_t CBORReader::getArgument(uint8_t info) {
+  if (info < 24) return info;
+
+  switch (info) {
+  case 24: return getBE(1);
+  case 25: return getBE(2);
+  case 26: return getBE(4);
+  case 27: return getBE(8);
+  }
+
+  error(SSTR("Invalid CBOR additional info " << (unsigned)info));
+  return 0;
+}
+
+
+string CBORReader::parseString(uint8_t major, uint8_t info) {
+  if (info != INDEFINITE) return getString(getArgument(info));
+
+  // Concatenate chunks
+  string s;
+
+  while (peek() != BREAK) {
+    uint8_t c = get();
+    if (c >> 5 != major || (c & 31) == INDEFINITE)
+      error("Invalid CBOR string chunk");
+    s += getString(getArgument(c & 31));
+  }
+
+  get(); // Break
+  return s;
+}
+
+
+string CBORReader::parseKey() {
+  uint8_t c = get();
+  uint8_t major = c >> 5;
+  uint8_t info = c & 31;
+
+  switch (major) {
+  case 0: return String(getArgument(info));
+  case 1: return String(-(int64_t)getArgument(info) - 1);
+  case 2: case 3: return parseString(major, info);
+  default: error("Unsupported CBOR map key type");
+  }
+
+  return string();
+}
+
+
+void CBORReader::parseList(Sink &sink, uint8_t info, unsigned depth) {
+  sink.beginList();
+
+  if (info == INDEFINITE) {
+    while (peek() != BREAK) {
+      sink.beginAppend();
+      parse(sink, depth);
+    }
+
+    get(); // Break
+
+  } else
+    for (uint64_t count = getArgument(info); count; count--) {
+      sink.beginAppend();
+      parse(sink, depth);
+    }
+
+  sink.endList();
+}
+
+
+void CBORReader::parseDict(Sink &sink, uint8_t info, unsigned depth) {
+  sink.beginDict();
+
+  if (info == INDEFINITE) {
+    while (peek() != BREAK) {
+      sink.beginInsert(parseKey());
+      parse(sink, depth);
+    }
+
+    get(); // Break
+
+  } else
+    for (uint64_t count = getArgument(info); count; count--) {
+      sink.beginInsert(parseKey());
+      parse(sink, depth);
+    }
+
+  sink.endDict();
+}
+
+
+void CBORReader::parseSimple(Sink &sink, uint8_t info) {
+  switch (info) {
+  case 20: return sink.writeBoolean(false);
+  case 21: return sink.writeBoolean(true);
+  case 22: case 23: return sink.writeNull(); // null, undefined
+  case 25: return sink.write(halfToDouble(getBE(2)));
+  case 26: return sink.write((double)getFloat());
+  case 27: return sink.write(getDouble());
+  case INDEFINITE: error("Unexpected CBOR break");
+  default: error(SSTR("Unsupported CBOR simple value " << (unsigned)info));
+  }
+}
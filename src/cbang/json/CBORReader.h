@@ -0,0 +1,63 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "BinaryReader.h"
+
+
+namespace cb {
+  namespace JSON {
+    /// Reads CBOR (RFC 8949) into a Sink.  Byte strings are passed on as
+    /// strings, tags are skipped and numeric map keys are converted to
+    /// strings.
+    class CBORReader : public BinaryReader {
+    public:
+      CBORReader(const InputSource &src) : BinaryReader(src) {}
+
+      static ValuePtr parse(const InputSource &src);
+      static void parse(const InputSource &src, Sink &sink);
+
+      // From BinaryReader
+      using BinaryReader::parse;
+      void parse(Sink &sink, unsigned depth = 0) override;
+
+    protected:
+      uint64_t getArgument(uint8_t info);
+      std::string parseString(uint8_t major, uint8_t info);
+      std::string parseKey();
+      void parseList(Sink &sink, uint8_t info, unsigned depth);
+      void parseDict(Sink &sink, uint8_t info, unsigned depth);
+      void parseSimple(Sink &sink, uint8_t info);
+    };
+  }
+}
@@ -0,0 +1,135 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "CBORWriter.h"
+
+using namespace std;
+using namespace cb::JSON;
+
+
+void CBORWriter::writeNull() {
+  NullSink::writeNull();
+  put(0xf6);
+  flush();
+}
+
+
+void CBORWriter::writeBoolean(bool value) {
+  NullSink::writeBoolean(value);
+  put(value ? 0xf5 : 0xf4);
+  flush();
+}
+
+
+void CBORWriter::write(double value) {
+  NullSink::write(value);
+
+  // Use single precision when it is exact
+  float f = (float)value;
+  if ((double)f == value || value != value) {
+    put(0xfa);
+    putFloat(f);
+
+  } else {
+    put(0xfb);
+    putDouble(value);
+  }
+
+  flush();
+}
+
+
+void CBORWriter::write(uint64_t value) {
+  NullSink::write(value);
+  putHead(0, value);
+  flush();
+}
+
+
+void CBORWriter::write(int64_t value) {
+  NullSink::write(value);
+  if (value < 0) putHead(1, -(value + 1));
+  else putHead(0, value);
+  flush();
+}
+
+
+void CBORWriter::write(const string &value) {
+  NullSink::write(value);
+  putHead(3, value.length());
+  put(value.data(), value.length());
+  flush();
+}
+
+
+void CBORWriter::beginList(bool simple) {
+  NullSink::beginList(simple);
+  put(0x9f);
+}
+
+
+void CBORWriter::endList() {
+  NullSink::endList();
+  put(0xff);
+  flush();
+}
+
+
+void CBORWriter::beginDict(bool simple) {
+  NullSink::beginDict(simple);
+  put(0xbf);
+}
+
+
+void CBORWriter::beginInsert(const string &key) {
+  NullSink::beginInsert(key);
+  putHead(3, key.length());
+  put(key.data(), key.length());
+}
+
+
+void CBORWriter::endDict() {
+  NullSink::endDict();
+  put(0xff);
+  flush();
+}
+
+
+void CBORWriter::putHead(uint8_t major, uint64_t value) {
+  major <<= 5;
+
+  if (value < 24) put(major | value);
+  else if (value <= 0xff) {put(major | 24); putBE(value, 1);}
+  else if (value <= 0xffff) {put(major | 25); putBE(value, 2);}
+  else if (value <= 0xffffffff) {put(major | 26); putBE(value, 4);}
+  else {put(major | 27); putBE(value, 8);}
+}
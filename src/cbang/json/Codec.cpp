@@ -0,0 +1,151 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Codec.h"
+#include "Writer.h"
+#include "Reader.h"
+#include "Builder.h"
+#include "CBORWriter.h"
+#include "CBORReader.h"
+#include "MsgPackWriter.h"
+#include "MsgPackReader.h"
+
+#include <cbang/String.h>
+
+#include <vector>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+Encoding Codec::negotiate(const string &accept) {
+  Encoding best = Encoding::ENCODING_JSON;
+  double bestQ = 0;
+
+  vector<string> ranges;
+  String::tokenize(accept, ranges, ",");
+
+  for (auto &range: ranges) {
+    vector<string> params;
+    String::tokenize(range, params, ";");
+    if (params.empty()) continue;
+
+    Encoding encoding;
+    if (!parseContentType(params[0], encoding)) continue;
+
+    double q = 1;
+    for (unsigned i = 1; i < params.size(); i++) {
+      string param = String::trim(params[i]);
+      if (String::startsWith(param, "q="))
+        q = String::parseDouble(param.substr(2));
+    }
+
+    // q=0 means not acceptable, JSON wins ties
+    if (q <= 0) continue;
+    if (bestQ < q || (bestQ == q && encoding == Encoding::ENCODING_JSON)) {
+      best = encoding;
+      bestQ = q;
+    }
+  }
+
+  return best;
+}
+
+
+bool Codec::parseContentType(const string &type, Encoding &encoding) {
+  string t = String::toLower(String::trim(type.substr(0, type.find(';'))));
+
+  if (t == "application/json") encoding = Encoding::ENCODING_JSON;
+  else if (t == "application/cbor") encoding = Encoding::ENCODING_CBOR;
+  else if (t == "application/msgpack" || t == "application/x-msgpack" ||
+           t == "application/vnd.msgpack")
+    encoding = Encoding::ENCODING_MSGPACK;
+  else return false;
+
+  return true;
+}
+
+
+const char *Codec::getContentType(Encoding encoding) {
+  switch (encoding) {
+  case Encoding::ENCODING_CBOR:    return "application/cbor";
+  case Encoding::ENCODING_MSGPACK: return "application/msgpack";
+  default:                         return "application/json";
+  }
+}
+
+
+bool Codec::parseProtocol(const string &protocol, Encoding &encoding) {
+  string p = String::toLower(String::trim(protocol));
+
+  if (p == "json") encoding = Encoding::ENCODING_JSON;
+  else if (p == "cbor") encoding = Encoding::ENCODING_CBOR;
+  else if (p == "msgpack") encoding = Encoding::ENCODING_MSGPACK;
+  else return false;
+
+  return true;
+}
+
+
+const char *Codec::getProtocol(Encoding encoding) {
+  switch (encoding) {
+  case Encoding::ENCODING_CBOR:    return "cbor";
+  case Encoding::ENCODING_MSGPACK: return "msgpack";
+  default:                         return "json";
+  }
+}
+
+
+SmartPointer<Sink> Codec::createWriter(Encoding encoding, ostream &stream) {
+  switch (encoding) {
+  case Encoding::ENCODING_CBOR:    return new CBORWriter(stream);
+  case Encoding::ENCODING_MSGPACK: return new MsgPackWriter(stream);
+  default:                         return new Writer(stream, 0, true);
+  }
+}
+
+
+void Codec::parse(Encoding encoding, const InputSource &src, Sink &sink) {
+  switch (encoding) {
+  case Encoding::ENCODING_CBOR:    return CBORReader(src).parse(sink);
+  case Encoding::ENCODING_MSGPACK: return MsgPackReader(src).parse(sink);
+  default:                         return Reader(src).parse(sink);
+  }
+}
+
+
+ValuePtr Codec::parse(Encoding encoding, const InputSource &src) {
+  Builder builder;
+  parse(encoding, src, builder);
+  return builder.getRoot();
+}
@@ -0,0 +1,74 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Encoding.h"
+#include "Value.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/io/InputSource.h>
+
+#include <string>
+#include <ostream>
+
+
+namespace cb {
+  namespace JSON {
+    class Sink;
+
+    /// Selects readers and writers for the text and binary JSON encodings
+    class Codec {
+    public:
+      /// @return the encoding preferred by an HTTP Accept header.  Binary
+      /// encodings are only chosen when explicitly listed with a higher q
+      /// than JSON.
+      static Encoding negotiate(const std::string &accept);
+
+      /// @return true if @param type is a JSON, CBOR or MessagePack MIME type
+      static bool parseContentType(const std::string &type,
+                                   Encoding &encoding);
+      static const char *getContentType(Encoding encoding);
+
+      /// Websocket subprotocol names
+      static bool parseProtocol(const std::string &protocol,
+                                Encoding &encoding);
+      static const char *getProtocol(Encoding encoding);
+
+      static SmartPointer<Sink> createWriter(Encoding encoding,
+                                             std::ostream &stream);
+      static void parse(Encoding encoding, const InputSource &src,
+                        Sink &sink);
+      static ValuePtr parse(Encoding encoding, const InputSource &src);
+    };
+  }
+}
@@ -0,0 +1,417 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Document.h"
+#include "Reader.h"
+#include "Path.h"
+
+#include <cbang/String.h>
+#include <cbang/Errors.h>
+#include <cbang/os/SystemUtilities.h>
+
+#include <limits>
+#include <cctype>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  bool isNumberChar(char c) {
+    return isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' ||
+      c == 'E';
+  }
+}
+
+
+/******************************************************************************/
+const Document::Entry &Document::Node::getEntry() const {
+  if (!isSet()) CBANG_KEY_ERROR("JSON Document node not set");
+  return doc->tape[index];
+}
+
+
+string Document::Node::getRaw() const {
+  const Entry &e = getEntry();
+  return doc->text.substr(e.start, e.end - e.start);
+}
+
+
+bool Document::Node::getBoolean() const {
+  assertType(ValueType::JSON_BOOLEAN);
+  return tolower(doc->text[getEntry().start]) == 't';
+}
+
+
+double Document::Node::getNumber() const {
+  assertType(ValueType::JSON_NUMBER);
+  return String::parseDouble(getRaw(), true);
+}
+
+
+int64_t Document::Node::getS64() const {
+  assertType(ValueType::JSON_NUMBER);
+  return String::parseS64(getRaw(), true);
+}
+
+
+uint64_t Document::Node::getU64() const {
+  assertType(ValueType::JSON_NUMBER);
+  return String::parseU64(getRaw(), true);
+}
+
+
+string Document::Node::getString() const {
+  assertType(ValueType::JSON_STRING);
+  return doc->getString(getEntry());
+}
+
+
+unsigned Document::Node::size() const {
+  if (!isList() && !isDict()) CBANG_TYPE_ERROR("Not a List or Dict");
+  return getEntry().count;
+}
+
+
+Document::Node Document::Node::get(unsigned i) const {
+  if (size() <= i) CBANG_KEY_ERROR("Index " << i << " out of range");
+
+  auto it = begin();
+  while (i--) ++it;
+  return *it;
+}
+
+
+string Document::Node::getKey(unsigned i) const {
+  assertType(ValueType::JSON_DICT);
+  if (size() <= i) CBANG_KEY_ERROR("Index " << i << " out of range");
+
+  auto it = begin();
+  while (i--) ++it;
+  return it.key();
+}
+
+
+Document::Node Document::Node::find(const string &key) const {
+  assertType(ValueType::JSON_DICT);
+
+  // The last duplicate key wins, as when building a Dict
+  Node result;
+
+  for (auto it = begin(); it != end(); ++it) {
+    const Entry &e = doc->tape[it.getIndex()]; // The key
+
+    if (e.escaped) {
+      if (doc->getString(e) == key) result = it.value();
+
+    } else if (e.end - e.start == key.length() + 2 &&
+               !doc->text.compare(e.start + 1, key.length(), key))
+      result = it.value();
+  }
+
+  return result;
+}
+
+
+Document::Node Document::Node::get(const string &key) const {
+  Node node = find(key);
+  if (!node.isSet()) CBANG_KEY_ERROR("Key '" << key << "' not found");
+  return node;
+}
+
+
+Document::Node Document::Node::select(const Path &path) const {
+  Node node = *this;
+
+  for (unsigned i = 0; i < path.size(); i++) {
+    Node next;
+
+    if (node.isList()) {
+      uint32_t index;
+      if (String::parse(path[i], index, true) && index < node.size())
+        next = node.get(index);
+
+    } else if (node.isDict()) next = node.find(path[i]);
+
+    if (!next.isSet())
+      CBANG_KEY_ERROR("At JSON path: " << path.toString(0, i + 1));
+
+    node = next;
+  }
+
+  return node;
+}
+
+
+Document::Node Document::Node::select(const string &path) const {
+  return select(Path(path));
+}
+
+
+bool Document::Node::exists(const string &path) const {
+  try {
+    select(path);
+    return true;
+  } catch (const KeyError &e) {}
+
+  return false;
+}
+
+
+Document::Iterator Document::Node::begin() const {
+  if (!isList() && !isDict()) CBANG_TYPE_ERROR("Not a List or Dict");
+  return Iterator(doc, index + 1, isDict());
+}
+
+
+Document::Iterator Document::Node::end() const {
+  if (!isList() && !isDict()) CBANG_TYPE_ERROR("Not a List or Dict");
+  return Iterator(doc, getEntry().next, isDict());
+}
+
+
+ValuePtr Document::Node::toValue() const {return doc->parse(getEntry());}
+
+
+void Document::Node::assertType(ValueType type) const {
+  if (getType() != type) CBANG_TYPE_ERROR("Not a " << type);
+}
+
+
+/******************************************************************************/
+Document::Iterator &Document::Iterator::operator++() {
+  index = doc->tape[index + dict].next;
+  return *this;
+}
+
+
+string Document::Iterator::key() const {
+  if (!dict) CBANG_TYPE_ERROR("Not a Dict");
+  return doc->getString(doc->tape[index]);
+}
+
+
+/******************************************************************************/
+Document::Document(const string &text, const string &name) :
+  name(name), text(text) {parse();}
+
+
+Document::Document(const InputSource &src) : name(src.getName()) {
+  text = SystemUtilities::read(src);
+  parse();
+}
+
+
+string Document::getString(const Entry &e) const {
+  if (!e.escaped) return text.substr(e.start + 1, e.end - e.start - 2);
+  return Reader(InputSource(text.data() + e.start, e.end - e.start, name))
+    .parseString();
+}
+
+
+ValuePtr Document::parse(const Entry &e) const {
+  return Reader::parse(
+    InputSource(text.data() + e.start, e.end - e.start, name));
+}
+
+
+void Document::parse() {
+  if (numeric_limits<uint32_t>::max() <= text.length())
+    error("JSON document too large");
+
+  tape.reserve(text.length() / 8);
+
+  pos = 0;
+  skipSpace();
+  parseValue(0);
+}
+
+
+void Document::parseValue(unsigned depth) {
+  if (1000 < ++depth) error("Maximum JSON parse depth reached");
+
+  switch (peek()) {
+  case '"': return parseString();
+  case '[': return parseList(depth);
+  case '{': return parseDict(depth);
+
+  case '-': case '.':
+  case '0': case '1': case '2': case '3': case '4':
+  case '5': case '6': case '7': case '8': case '9': {
+    uint32_t i = push(ValueType::JSON_NUMBER);
+    while (pos < text.length() && isNumberChar(text[pos])) pos++;
+    tape[i].end = pos;
+    tape[i].next = tape.size();
+    return;
+  }
+
+  default: {
+    uint32_t start = pos;
+    while (pos < text.length() && isalpha(text[pos])) pos++;
+    string keyword = String::toLower(text.substr(start, pos - start));
+    pos = start;
+
+    ValueType type;
+    if (keyword == "null" || keyword == "none") type = ValueType::JSON_NULL;
+    else if (keyword == "true" || keyword == "false")
+      type = ValueType::JSON_BOOLEAN;
+    else error("Expected one of 'NnTtFf-.0123456789\"[{'");
+
+    uint32_t i = push(type);
+    pos += keyword.length();
+    tape[i].end = pos;
+    tape[i].next = tape.size();
+  }
+  }
+}
+
+
+void Document::parseString() {
+  uint32_t i = push(ValueType::JSON_STRING);
+  pos++; // Opening quote
+
+  while (true) {
+    size_t end = text.find_first_of("\"\\\n", pos);
+    if (end == string::npos) {
+      pos = text.length();
+      error("Unterminated string");
+    }
+
+    pos = end;
+
+    if (text[pos] == '\n') error("Unescaped new line in JSON string");
+    if (text[pos] == '"') break;
+
+    tape[i].escaped = true;
+    pos += 2;
+  }
+
+  pos++; // Closing quote
+  tape[i].end = pos;
+  tape[i].next = tape.size();
+}
+
+
+void Document::parseList(unsigned depth) {
+  uint32_t i = push(ValueType::JSON_LIST);
+  match('[');
+
+  while (true) {
+    skipSpace();
+    if (peek() == ']') break;
+
+    parseValue(depth);
+    tape[i].count++;
+
+    skipSpace();
+    if (peek() == ']') break;
+    match(',');
+  }
+
+  pos++;
+  tape[i].end = pos;
+  tape[i].next = tape.size();
+}
+
+
+void Document::parseDict(unsigned depth) {
+  uint32_t i = push(ValueType::JSON_DICT);
+  match('{');
+
+  while (true) {
+    skipSpace();
+    if (peek() == '}') break;
+
+    if (peek() != '"') error("Expected '\"'");
+    parseString();
+    skipSpace();
+    match(':');
+    skipSpace();
+    parseValue(depth);
+    tape[i].count++;
+
+    skipSpace();
+    if (peek() == '}') break;
+    match(',');
+  }
+
+  pos++;
+  tape[i].end = pos;
+  tape[i].next = tape.size();
+}
+
+
+uint32_t Document::push(ValueType type) {
+  tape.push_back({pos, pos, 0, 0, (uint8_t)type, false});
+  return tape.size() - 1;
+}
+
+
+void Document::skipSpace() {
+  while (pos < text.length())
+    switch (text[pos]) {
+    case '\n': case '\r': case '\t': case ' ': pos++; break;
+
+    case '#':
+      while (pos < text.length() && text[pos] != '\n') pos++;
+      break;
+
+    default: return;
+    }
+}
+
+
+char Document::peek() {
+  if (text.length() <= pos) error("Unexpected end of expression");
+  return text[pos];
+}
+
+
+void Document::match(char c) {
+  if (peek() != c)
+    error(SSTR("Expected '" << c << "' but found '"
+               << String::escapeC(string(1, text[pos])) << '\''));
+  pos++;
+}
+
+
+void Document::error(const string &msg) const {
+  unsigned line = 0;
+  unsigned column = 0;
+
+  for (uint32_t i = 0; i < pos && i < text.length(); i++)
+    if (text[i] == '\n') {line++; column = 0;}
+    else if (text[i] != '\r') column++;
+
+  throw ParseError(msg, FileLocation(name, line, column));
+}
@@ -0,0 +1,175 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Value.h"
+#include "ValueType.h"
+
+#include <cbang/io/InputSource.h>
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  namespace JSON {
+    class Path;
+
+    /**
+     * Read-only JSON document which is indexed in one pass but only turned
+     * into Values on demand.
+     *
+     * Parsing records the position of every value in a flat tape.  Lookups,
+     * Path selection and iteration walk the tape without allocating.
+     * Scalars are decoded when read and Node::toValue() materializes a
+     * subtree with the regular Reader, so they follow the non-strict Reader
+     * rules.  Structural errors are reported by the constructor, errors in
+     * individual scalars only when they are accessed.
+     */
+    class Document {
+    public:
+      struct Entry {
+        uint32_t start;
+        uint32_t end;
+        uint32_t next;  // Index of the entry after this value and children
+        uint32_t count; // Number of list items or dict entries
+        uint8_t type;
+        bool escaped;   // String contains escape sequences
+      };
+
+      class Iterator;
+
+      class Node {
+        const Document *doc;
+        uint32_t index;
+
+      public:
+        Node(const Document *doc = 0, uint32_t index = ~0) :
+          doc(doc), index(index) {}
+
+        bool isSet() const {return doc && index != (uint32_t)~0;}
+        uint32_t getIndex() const {return index;}
+        const Entry &getEntry() const;
+
+        ValueType getType() const {return (ValueType::enum_t)getEntry().type;}
+        bool isNull() const {return getType() == ValueType::JSON_NULL;}
+        bool isBoolean() const {return getType() == ValueType::JSON_BOOLEAN;}
+        bool isNumber() const {return getType() == ValueType::JSON_NUMBER;}
+        bool isString() const {return getType() == ValueType::JSON_STRING;}
+        bool isList() const {return getType() == ValueType::JSON_LIST;}
+        bool isDict() const {return getType() == ValueType::JSON_DICT;}
+
+        /// @return the JSON text of this value
+        std::string getRaw() const;
+
+        bool getBoolean() const;
+        double getNumber() const;
+        int64_t getS64() const;
+        uint64_t getU64() const;
+        std::string getString() const;
+
+        unsigned size() const;
+        Node get(unsigned i) const;
+        std::string getKey(unsigned i) const;
+        Node find(const std::string &key) const;
+        bool has(const std::string &key) const {return find(key).isSet();}
+        Node get(const std::string &key) const;
+
+        Node select(const Path &path) const;
+        Node select(const std::string &path) const;
+        bool exists(const std::string &path) const;
+
+        Iterator begin() const;
+        Iterator end() const;
+
+        ValuePtr toValue() const;
+
+      protected:
+        void assertType(ValueType type) const;
+      };
+
+
+      class Iterator {
+        const Document *doc;
+        uint32_t index;
+        bool dict;
+
+      public:
+        Iterator(const Document *doc, uint32_t index, bool dict) :
+          doc(doc), index(index), dict(dict) {}
+
+        bool operator==(const Iterator &o) const {return index == o.index;}
+        bool operator!=(const Iterator &o) const {return index != o.index;}
+
+        uint32_t getIndex() const {return index;}
+        Iterator &operator++();
+
+        /// Valid when iterating a dict
+        std::string key() const;
+        Node value() const {return Node(doc, index + dict);}
+        Node operator*() const {return value();}
+      };
+
+    protected:
+      std::string name;
+      std::string text;
+      std::vector<Entry> tape;
+      uint32_t pos = 0;
+
+    public:
+      Document(const std::string &text, const std::string &name = "<memory>");
+      Document(const InputSource &src);
+
+      const std::string &getText() const {return text;}
+      const std::vector<Entry> &getTape() const {return tape;}
+
+      Node getRoot() const {return Node(this, 0);}
+      ValuePtr toValue() const {return getRoot().toValue();}
+
+      std::string getString(const Entry &e) const;
+      ValuePtr parse(const Entry &e) const;
+
+    protected:
+      void parse();
+      void parseValue(unsigned depth);
+      void parseString();
+      void parseList(unsigned depth);
+      void parseDict(unsigned depth);
+      uint32_t push(ValueType type);
+      void skipSpace();
+      char peek();
+      void match(char c);
+      void error(const std::string &msg) const;
+    };
+  }
+}
@@ -0,0 +1,128 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "InternFactory.h"
+#include "Number.h"
+#include "String.h"
+
+#include <cbang/thread/Mutex.h>
+#include <cbang/thread/SmartLock.h>
+
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  const int64_t  minSmall   = -128;
+  const int64_t  maxSmall   = 1024;
+  const unsigned maxSymbols = 1 << 16;
+
+
+  struct SmallInts {
+    vector<ValuePtr> s64;
+    vector<ValuePtr> u64;
+
+    SmallInts() {
+      for (int64_t i = minSmall; i < maxSmall; i++) s64.push_back(new S64(i));
+      for (int64_t i = 0; i < maxSmall; i++) u64.push_back(new U64(i));
+    }
+  };
+
+
+  const SmallInts &getSmallInts() {
+    static SmallInts ints;
+    return ints;
+  }
+
+
+  class SymbolTable : public Mutex {
+    unordered_map<string, ValuePtr> symbols;
+
+  public:
+    unsigned size() const {
+      SmartLock lock(this);
+      return symbols.size();
+    }
+
+
+    ValuePtr intern(const string &s) {
+      SmartLock lock(this);
+
+      auto it = symbols.find(s);
+      if (it != symbols.end()) return it->second;
+
+      // Once full, new strings are no longer shared
+      ValuePtr value = new JSON::String(s);
+      if (symbols.size() < maxSymbols) symbols.emplace(s, value);
+
+      return value;
+    }
+  };
+
+
+  SymbolTable &getSymbolTable() {
+    static SymbolTable table;
+    return table;
+  }
+}
+
+
+const InternFactory &InternFactory::instance() {
+  static InternFactory factory;
+  return factory;
+}
+
+
+unsigned InternFactory::getSymbolCount() {return getSymbolTable().size();}
+
+
+ValuePtr InternFactory::create(int64_t value) const {
+  if (minSmall <= value && value < maxSmall)
+    return getSmallInts().s64[value - minSmall];
+  return Factory::create(value);
+}
+
+
+ValuePtr InternFactory::create(uint64_t value) const {
+  if (value < (uint64_t)maxSmall) return getSmallInts().u64[value];
+  return Factory::create(value);
+}
+
+
+ValuePtr InternFactory::create(const string &value) const {
+  if (value.length() <= maxLength) return getSymbolTable().intern(value);
+  return Factory::create(value);
+}
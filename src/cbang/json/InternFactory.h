@@ -0,0 +1,66 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Factory.h"
+
+#include <string>
+
+
+namespace cb {
+  namespace JSON {
+    /***
+     * Shares immutable scalars between Values.  Small integers come from
+     * preallocated tables and strings up to @param maxLength bytes from a
+     * process wide symbol table.  Values created here may be referenced by
+     * many trees at once and must not be modified in place.
+     */
+    class InternFactory : public Factory {
+      unsigned maxLength;
+
+    public:
+      InternFactory(unsigned maxLength = 15) : maxLength(maxLength) {}
+
+      static const InternFactory &instance();
+      static unsigned getSymbolCount();
+
+      unsigned getMaxLength() const {return maxLength;}
+
+      // From Factory
+      ValuePtr create(int64_t value) const override;
+      ValuePtr create(uint64_t value) const override;
+      ValuePtr create(const std::string &value) const override;
+      using Factory::create;
+    };
+  }
+}
@@ -47,5 +47,9 @@
 #include "BufferWriter.h"
 #include "Integer.h"
 #include "Factory.h"
+#include "InternFactory.h"
 #include "Serializable.h"
 #include "Observable.h"
+#include "Patch.h"
+#include "Codec.h"
+#include "Document.h"
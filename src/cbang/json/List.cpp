@@ -74,6 +74,14 @@ void List::append(const ValuePtr &value) {
 }
 
 
+void List::insert(unsigned i, const ValuePtr &value) {
+  if (value.isNull()) THROW("Value cannot be NULL");
+  if (size() < i) KEY_ERROR("Index " << (int)i << " out of range " << size());
+  if (value->isList() || value->isDict()) simple = false;
+  ListImpl::insert(ListImpl::begin() + i, value);
+}
+
+
 void List::erase(unsigned i) {
   check(i);
   ListImpl::erase(ListImpl::begin() + i);
@@ -66,6 +66,7 @@ namespace cb {
       const ValuePtr &get(unsigned i) const override;
 
       void append(const ValuePtr &value) override;
+      void insert(unsigned i, const ValuePtr &value) override;
       void set(unsigned i, const ValuePtr &value) override;
       void clear() override {ListImpl::clear();}
       void erase(unsigned i) override;
@@ -0,0 +1,146 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "MsgPackReader.h"
+#include "Sink.h"
+
+#include <cbang/String.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+ValuePtr MsgPackReader::parse(const InputSource &src) {
+  return MsgPackReader(src).parse();
+}
+
+
+void MsgPackReader::parse(const InputSource &src, Sink &sink) {
+  MsgPackReader(src).parse(sink);
+}
+
+
+void MsgPackReader::parse(Sink &sink, unsigned depth) {
+  if (1000 < ++depth) error("Maximum MessagePack parse depth reached");
+
+  uint8_t c = get();
+
+  if (c < 0x80) return sink.write((uint64_t)c);             // positive fixint
+  if (0xe0 <= c) return sink.write((int64_t)(int8_t)c);     // negative fixint
+  if ((c & 0xe0) == 0xa0) return sink.write(getString(c & 0x1f)); // fixstr
+  if ((c & 0xf0) == 0x90) return parseList(sink, c & 0x0f, depth);
+  if ((c & 0xf0) == 0x80) return parseDict(sink, c & 0x0f, depth);
+
+  switch (c) {
+  case 0xc0: return sink.writeNull();
+  case 0xc2: return sink.writeBoolean(false);
+  case 0xc3: return sink.writeBoolean(true);
+
+  case 0xc4: case 0xd9: return sink.write(getString(getBE(1))); // bin/str 8
+  case 0xc5: case 0xda: return sink.write(getString(getBE(2))); // bin/str 16
+  case 0xc6: case 0xdb: return sink.write(getString(getBE(4))); // bin/str 32
+
+  case 0xca: return sink.write((double)getFloat());
+  case 0xcb: return sink.write(getDouble());
+
+  case 0xcc: return sink.write((uint64_t)getBE(1));
+  case 0xcd: return sink.write((uint64_t)getBE(2));
+  case 0xce: return sink.write((uint64_t)getBE(4));
+  case 0xcf: return sink.write((uint64_t)getBE(8));
+
+  case 0xd0: return sink.write((int64_t)(int8_t)getBE(1));
+  case 0xd1: return sink.write((int64_t)(int16_t)getBE(2));
+  case 0xd2: return sink.write((int64_t)(int32_t)getBE(4));
+  case 0xd3: return sink.write((int64_t)getBE(8));
+
+  case 0xdc: return parseList(sink, getBE(2), depth);
+  case 0xdd: return parseList(sink, getBE(4), depth);
+  case 0xde: return parseDict(sink, getBE(2), depth);
+  case 0xdf: return parseDict(sink, getBE(4), depth);
+
+  default:
+    error(SSTR("Unsupported MessagePack type 0x" << std::hex << (unsigned)c));
+  }
+}
+
+
+string MsgPackReader::parseKey() {
+  uint8_t c = get();
+
+  if (c < 0x80) return String((uint64_t)c);
+  if (0xe0 <= c) return String((int64_t)(int8_t)c);
+  if ((c & 0xe0) == 0xa0) return getString(c & 0x1f);
+
+  switch (c) {
+  case 0xc4: case 0xd9: return getString(getBE(1));
+  case 0xc5: case 0xda: return getString(getBE(2));
+  case 0xc6: case 0xdb: return getString(getBE(4));
+
+  case 0xcc: return String((uint64_t)getBE(1));
+  case 0xcd: return String((uint64_t)getBE(2));
+  case 0xce: return String((uint64_t)getBE(4));
+  case 0xcf: return String((uint64_t)getBE(8));
+
+  case 0xd0: return String((int64_t)(int8_t)getBE(1));
+  case 0xd1: return String((int64_t)(int16_t)getBE(2));
+  case 0xd2: return String((int64_t)(int32_t)getBE(4));
+  case 0xd3: return String((int64_t)getBE(8));
+  }
+
+  error("Unsupported MessagePack map key type");
+  return string();
+}
+
+
+void MsgPackReader::parseList(Sink &sink, uint32_t count, unsigned depth) {
+  sink.beginList();
+
+  for (; count; count--) {
+    sink.beginAppend();
+    parse(sink, depth);
+  }
+
+  sink.endList();
+}
+
+
+void MsgPackReader::parseDict(Sink &sink, uint32_t count, unsigned depth) {
+  sink.beginDict();
+
+  for (; count; count--) {
+    sink.beginInsert(parseKey());
+    parse(sink, depth);
+  }
+
+  sink.endDict();
+}
@@ -0,0 +1,198 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "MsgPackWriter.h"
+
+#include <cstdint>
+
+using namespace std;
+using namespace cb::JSON;
+
+
+namespace {
+  const unsigned MAX_HEADER = 5;
+}
+
+
+void MsgPackWriter::reset() {
+  BinaryWriter::reset();
+  containers.clear();
+}
+
+
+void MsgPackWriter::writeNull() {
+  NullSink::writeNull();
+  put(0xc0);
+  flush();
+}
+
+
+void MsgPackWriter::writeBoolean(bool value) {
+  NullSink::writeBoolean(value);
+  put(value ? 0xc3 : 0xc2);
+  flush();
+}
+
+
+void MsgPackWriter::write(double value) {
+  NullSink::write(value);
+
+  // Use single precision when it is exact
+  float f = (float)value;
+  if ((double)f == value || value != value) {
+    put(0xca);
+    putFloat(f);
+
+  } else {
+    put(0xcb);
+    putDouble(value);
+  }
+
+  flush();
+}
+
+
+void MsgPackWriter::write(uint64_t value) {
+  NullSink::write(value);
+
+  if (value < 0x80) put(value);
+  else if (value <= 0xff) {put(0xcc); putBE(value, 1);}
+  else if (value <= 0xffff) {put(0xcd); putBE(value, 2);}
+  else if (value <= 0xffffffff) {put(0xce); putBE(value, 4);}
+  else {put(0xcf); putBE(value, 8);}
+
+  flush();
+}
+
+
+void MsgPackWriter::write(int64_t value) {
+  if (0 <= value) return write((uint64_t)value);
+
+  NullSink::write(value);
+
+  if (-32 <= value) put((uint8_t)value);
+  else if (INT8_MIN  <= value) {put(0xd0); putBE(value, 1);}
+  else if (INT16_MIN <= value) {put(0xd1); putBE(value, 2);}
+  else if (INT32_MIN <= value) {put(0xd2); putBE(value, 4);}
+  else {put(0xd3); putBE(value, 8);}
+
+  flush();
+}
+
+
+void MsgPackWriter::write(const string &value) {
+  NullSink::write(value);
+  putString(value);
+  flush();
+}
+
+
+void MsgPackWriter::beginList(bool simple) {
+  NullSink::beginList(simple);
+  beginContainer();
+}
+
+
+void MsgPackWriter::beginAppend() {
+  NullSink::beginAppend();
+  containers.back().count++;
+}
+
+
+void MsgPackWriter::endList() {
+  NullSink::endList();
+  endContainer(false);
+}
+
+
+void MsgPackWriter::beginDict(bool simple) {
+  NullSink::beginDict(simple);
+  beginContainer();
+}
+
+
+void MsgPackWriter::beginInsert(const string &key) {
+  NullSink::beginInsert(key);
+  containers.back().count++;
+  putString(key);
+}
+
+
+void MsgPackWriter::endDict() {
+  NullSink::endDict();
+  endContainer(true);
+}
+
+
+void MsgPackWriter::putString(const string &s) {
+  size_t length = s.length();
+
+  if (length < 32) put(0xa0 | length);
+  else if (length <= 0xff) {put(0xd9); putBE(length, 1);}
+  else if (length <= 0xffff) {put(0xda); putBE(length, 2);}
+  else {put(0xdb); putBE(length, 4);}
+
+  put(s.data(), length);
+}
+
+
+void MsgPackWriter::beginContainer() {
+  // Reserve space for the largest header
+  containers.push_back({buffer.size(), 0});
+  buffer.append(MAX_HEADER, 0);
+}
+
+
+void MsgPackWriter::endContainer(bool dict) {
+  Container c = containers.back();
+  containers.pop_back();
+
+  char header[MAX_HEADER];
+  unsigned length;
+
+  if (c.count < 16) {
+    header[0] = (dict ? 0x80 : 0x90) | c.count;
+    length = 1;
+
+  } else {
+    unsigned bytes = c.count <= 0xffff ? 2 : 4;
+    header[0] = (char)((dict ? 0xde : 0xdc) + (bytes == 4));
+    for (unsigned i = 0; i < bytes; i++)
+      header[1 + i] = (char)(c.count >> (8 * (bytes - i - 1)));
+    length = 1 + bytes;
+  }
+
+  // Replace the reserved space, shifting the contents if necessary
+  buffer.replace(c.offset, MAX_HEADER, header, length);
+
+  flush();
+}
@@ -0,0 +1,83 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "BinaryWriter.h"
+
+#include <vector>
+
+
+namespace cb {
+  namespace JSON {
+    /**
+     * Writes MessagePack.  MessagePack needs element counts before the
+     * elements, so each list or dict header is patched to its smallest form
+     * once the container is closed.  Integers and floats keep their types.
+     */
+    class MsgPackWriter : public BinaryWriter {
+      struct Container {
+        size_t offset;
+        uint32_t count;
+      };
+
+      std::vector<Container> containers;
+
+    public:
+      MsgPackWriter(std::ostream &stream, bool allowDuplicates = false) :
+        BinaryWriter(stream, allowDuplicates) {}
+
+      // From BinaryWriter
+      void reset() override;
+
+      // From Sink
+      void writeNull() override;
+      void writeBoolean(bool value) override;
+      void write(double value) override;
+      void write(uint64_t value) override;
+      void write(int64_t value) override;
+      void write(const std::string &value) override;
+      using Sink::write;
+      void beginList(bool simple = false) override;
+      void beginAppend() override;
+      void endList() override;
+      void beginDict(bool simple = false) override;
+      void beginInsert(const std::string &key) override;
+      void endDict() override;
+
+    protected:
+      void putString(const std::string &s);
+      void beginContainer();
+      void endContainer(bool dict);
+    };
+  }
+}
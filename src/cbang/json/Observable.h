@@ -34,6 +34,7 @@
 
 #include "Dict.h"
 #include "List.h"
+#include "PatchTracker.h"
 
 #include <functional>
 
@@ -94,6 +95,18 @@ namespace cb {
       }
 
 
+      void insert(unsigned i, const ValuePtr &_value) override {
+        ValuePtr value = convert(_value);
+        T::insert(i, value);
+
+        for (unsigned j = i + 1; j < T::size(); j++)
+          _incParentRef(T::get(j));
+
+        _setParentRef(value, i);
+        _notify(i, value);
+      }
+
+
       void set(unsigned i, const ValuePtr &_value) override {
         // Block operation if value is equal
         auto value = T::get(i);
@@ -222,6 +235,39 @@ namespace cb {
     };
 
 
+    /***
+     * Coalesces changes into a single JSON Patch (RFC 6902).  The first
+     * change after a flush calls scheduleFlush().  Override it to defer
+     * flush(), e.g. to the next event loop turn with Event::activate().
+     */
+    template <typename T>
+    class CoalescedObservable : public Observable<T> {
+      PatchTracker tracker;
+
+    public:
+      CoalescedObservable() : tracker(*this) {}
+
+      virtual void notifyPatch(const ValuePtr &patch) = 0;
+      virtual void scheduleFlush() {}
+
+      const ValuePtr &getSnapshot() const {return tracker.getSnapshot();}
+
+
+      void flush() {
+        auto patch = tracker.flush(*this);
+        if (patch->size()) notifyPatch(patch);
+      }
+
+
+      // From ObservableBase
+      void notify(const std::list<ValuePtr> &change) override {
+        bool scheduled = tracker.hasChanges();
+        tracker.add(change);
+        if (!scheduled) scheduleFlush();
+      }
+    };
+
+
     typedef Observable<Dict> ObservableDict;
     typedef Observable<List> ObservableList;
   }
@@ -0,0 +1,341 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Patch.h"
+#include "Builder.h"
+#include "Dict.h"
+#include "List.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+string Patch::escape(const string &token) {
+  string s;
+
+  for (auto c: token)
+    if (c == '~') s += "~0";
+    else if (c == '/') s += "~1";
+    else s += c;
+
+  return s;
+}
+
+
+string Patch::unescape(const string &token) {
+  string s;
+
+  for (unsigned i = 0; i < token.length(); i++)
+    if (token[i] == '~') {
+      char c = i + 1 < token.length() ? token[++i] : 0;
+      if (c != '0' && c != '1')
+        THROW("Invalid escape in JSON Pointer token '" << token << "'");
+      s += c == '0' ? '~' : '/';
+
+    } else s += token[i];
+
+  return s;
+}
+
+
+Patch::pointer_t Patch::parsePointer(const string &pointer) {
+  pointer_t tokens;
+
+  if (pointer.empty()) return tokens;
+  if (pointer[0] != '/')
+    THROW("JSON Pointer must be empty or start with '/': " << pointer);
+
+  for (size_t start = 1;;) {
+    size_t end = pointer.find('/', start);
+    if (end == string::npos) end = pointer.length();
+    tokens.push_back(unescape(pointer.substr(start, end - start)));
+    if (end == pointer.length()) break;
+    start = end + 1;
+  }
+
+  return tokens;
+}
+
+
+string Patch::toPointer(const pointer_t &tokens) {
+  string s;
+  for (auto &token: tokens) s += "/" + escape(token);
+  return s;
+}
+
+
+ValuePtr Patch::clone(const Value &value) {
+  Builder builder;
+  value.write(builder);
+  return builder.getRoot();
+}
+
+
+void Patch::diff(const Value &from, const Value &to, const string &path,
+                 Value &ops) {
+  if (&from == &to) return;
+
+  if (from.isDict() && to.isDict()) {
+    for (auto e: from.entries())
+      if (!to.has(e.key()))
+        ops.append(makeOp("remove", path + "/" + escape(e.key())));
+
+    for (auto e: to.entries()) {
+      string p = path + "/" + escape(e.key());
+      auto it = from.find(e.key());
+
+      if (it) diff(**it, *e.value(), p, ops);
+      else ops.append(makeOp("add", p, clone(*e.value())));
+    }
+
+    return;
+  }
+
+  if (from.isList() && to.isList()) {
+    unsigned n = min(from.size(), to.size());
+
+    for (unsigned i = 0; i < n; i++)
+      diff(*from.get(i), *to.get(i), path + "/" + String(i), ops);
+
+    for (unsigned i = n; i < to.size(); i++)
+      ops.append(makeOp("add", path + "/" + String(i), clone(*to.get(i))));
+
+    // Remove from the end so earlier indices stay valid
+    for (unsigned i = from.size(); n < i; i--)
+      ops.append(makeOp("remove", path + "/" + String(i - 1)));
+
+    return;
+  }
+
+  if (from != to) ops.append(makeOp("replace", path, clone(to)));
+}
+
+
+ValuePtr Patch::diff(const Value &from, const Value &to) {
+  ValuePtr ops = new List;
+  diff(from, to, "", *ops);
+  return ops;
+}
+
+
+ValuePtr Patch::apply(const ValuePtr &target, const Value &patch) {
+  // Work on a copy so that a failing operation leaves target untouched
+  ValuePtr root = target->copy(true);
+
+  for (auto &op: patch) {
+    string name = op->getString("op");
+    auto path = parsePointer(op->getString("path"));
+
+    // Values are copied so the result does not share nodes with the patch
+    if (name == "add") root = add(root, path, op->get("value")->copy(true));
+    else if (name == "remove") root = remove(root, path);
+
+    else if (name == "replace") {
+      auto value = op->get("value")->copy(true);
+      if (path.empty()) {root = value; continue;}
+
+      auto parent = resolve(root, path, path.size() - 1);
+      auto &key = path.back();
+
+      if (parent->isList())
+        parent->set(parseIndex(key, parent->size(), false), value);
+
+      else if (parent->isDict()) {
+        if (!parent->has(key))
+          CBANG_KEY_ERROR("JSON Pointer " << toPointer(path) << " not found");
+        parent->insert(key, value);
+
+      } else resolve(root, path, path.size()); // Throws
+
+    } else if (name == "move" || name == "copy") {
+      auto from = parsePointer(op->getString("from"));
+      auto value = resolve(root, from, from.size());
+
+      if (name == "move") {
+        if (from.size() < path.size() &&
+            equal(from.begin(), from.end(), path.begin()))
+          THROW("Cannot move " << toPointer(from) << " into itself");
+        root = remove(root, from);
+
+      } else value = value->copy(true);
+
+      root = add(root, path, value);
+
+    } else if (name == "test") {
+      if (*resolve(root, path, path.size()) != *op->get("value"))
+        THROW("JSON Patch test failed at " << toPointer(path));
+
+    } else THROW("Unsupported JSON Patch op '" << name << "'");
+  }
+
+  return root;
+}
+
+
+ValuePtr Patch::mergeDiff(const Value &from, const Value &to) {
+  if (!from.isDict() || !to.isDict()) return clone(to);
+
+  ValuePtr patch = new Dict;
+
+  for (auto e: from.entries())
+    if (!to.has(e.key())) patch->insertNull(e.key());
+
+  for (auto e: to.entries()) {
+    auto &key = e.key();
+    auto &value = *e.value();
+    auto it = from.find(key);
+
+    if (!it) patch->insert(key, clone(value));
+
+    else if ((*it)->isDict() && value.isDict()) {
+      auto sub = mergeDiff(**it, value);
+      if (sub->size()) patch->insert(key, sub);
+
+    } else if (**it != value) patch->insert(key, clone(value));
+  }
+
+  return patch;
+}
+
+
+ValuePtr Patch::mergeApply(const ValuePtr &target, const ValuePtr &patch) {
+  if (!patch->isDict()) return patch;
+
+  ValuePtr result =
+    target.isSet() && target->isDict() ? target : ValuePtr(new Dict);
+
+  for (auto e: patch->entries()) {
+    if (e.value()->isNull()) result->erase(e.key());
+
+    else {
+      auto it = result->find(e.key());
+      result->insert(e.key(), mergeApply(it ? *it : 0, e.value()));
+    }
+  }
+
+  return result;
+}
+
+
+ValuePtr Patch::makeOp(const string &name, const string &path,
+                       const ValuePtr &value) {
+  ValuePtr op = new Dict;
+
+  op->insert("op", name);
+  op->insert("path", path);
+  if (value.isSet()) op->insert("value", value);
+
+  return op;
+}
+
+
+ValuePtr Patch::resolve(const ValuePtr &root, const pointer_t &tokens,
+                        unsigned count) {
+  ValuePtr value = root;
+
+  for (unsigned i = 0; i < count; i++) {
+    auto &token = tokens[i];
+
+    if (value->isList()) value = value->get(parseIndex(token, value->size()));
+
+    else {
+      auto it = value->isDict() ? value->find(token) : Iterator();
+
+      if (!it) {
+        pointer_t prefix(tokens.begin(), tokens.begin() + i + 1);
+        CBANG_KEY_ERROR("JSON Pointer " << toPointer(prefix) << " not found");
+      }
+
+      value = *it;
+    }
+  }
+
+  return value;
+}
+
+
+unsigned Patch::parseIndex(const string &token, unsigned size, bool allowEnd) {
+  bool valid = !token.empty() && (token[0] != '0' || token.length() == 1);
+  for (auto c: token) if (!isdigit(c)) valid = false;
+  if (!valid)
+    CBANG_KEY_ERROR("Invalid JSON Pointer list index '" << token << "'");
+
+  unsigned i = String::parseU32(token);
+  if (size < i || (i == size && !allowEnd))
+    CBANG_KEY_ERROR("JSON Pointer index " << i << " out of range " << size);
+
+  return i;
+}
+
+
+ValuePtr Patch::add(const ValuePtr &root, const pointer_t &tokens,
+                    const ValuePtr &value) {
+  if (tokens.empty()) return value;
+
+  auto parent = resolve(root, tokens, tokens.size() - 1);
+  auto &key = tokens.back();
+
+  if (parent->isDict()) parent->insert(key, value);
+  else if (parent->isList()) {
+    if (key == "-") parent->append(value);
+    else parent->insert(parseIndex(key, parent->size(), true), value);
+
+  } else CBANG_KEY_ERROR("Cannot add to " << parent->getType() << " at "
+                         << toPointer(tokens));
+
+  return root;
+}
+
+
+ValuePtr Patch::remove(const ValuePtr &root, const pointer_t &tokens) {
+  if (tokens.empty()) THROW("Cannot remove the JSON Patch root");
+
+  auto parent = resolve(root, tokens, tokens.size() - 1);
+  auto &key = tokens.back();
+
+  if (parent->isList()) parent->erase(parseIndex(key, parent->size()));
+
+  else {
+    if (!parent->isDict() || !parent->has(key))
+      CBANG_KEY_ERROR("JSON Pointer " << toPointer(tokens) << " not found");
+    parent->erase(key);
+  }
+
+  return root;
+}
@@ -0,0 +1,86 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Value.h"
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  namespace JSON {
+    /// JSON Patch (RFC 6902), JSON Pointer (RFC 6901) and JSON Merge Patch
+    /// (RFC 7386) over Value trees.
+    class Patch {
+    public:
+      typedef std::vector<std::string> pointer_t;
+
+      static std::string escape(const std::string &token);
+      static std::string unescape(const std::string &token);
+      static pointer_t parsePointer(const std::string &pointer);
+      static std::string toPointer(const pointer_t &tokens);
+
+      /// Deep copy into plain Dicts and Lists
+      static ValuePtr clone(const Value &value);
+
+      /// Append to @param ops the operations which turn @param from into
+      /// @param to.  Lists are compared by index.
+      static void diff(const Value &from, const Value &to,
+                       const std::string &path, Value &ops);
+      static ValuePtr diff(const Value &from, const Value &to);
+
+      /// Apply @param patch to a copy of @param target and return it.
+      /// @param target is never modified, so on error nothing is applied.
+      static ValuePtr apply(const ValuePtr &target, const Value &patch);
+
+      /// Null members in @param to cannot be expressed by a merge patch and
+      /// are treated as deletions.
+      static ValuePtr mergeDiff(const Value &from, const Value &to);
+      static ValuePtr mergeApply(const ValuePtr &target,
+                                 const ValuePtr &patch);
+
+      static ValuePtr makeOp(const std::string &name, const std::string &path,
+                             const ValuePtr &value = 0);
+
+    protected:
+      static ValuePtr resolve(const ValuePtr &root, const pointer_t &tokens,
+                              unsigned count);
+      static unsigned parseIndex(const std::string &token, unsigned size,
+                                 bool allowEnd = false);
+      static ValuePtr add(const ValuePtr &root, const pointer_t &tokens,
+                          const ValuePtr &value);
+      static ValuePtr remove(const ValuePtr &root, const pointer_t &tokens);
+    };
+  }
+}
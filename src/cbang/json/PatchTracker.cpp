@@ -0,0 +1,110 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "PatchTracker.h"
+#include "Patch.h"
+#include "List.h"
+
+#include <iterator>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+PatchTracker::PatchTracker(const Value &value) :
+  snapshot(Patch::clone(value)) {}
+
+
+void PatchTracker::add(const list<ValuePtr> &change) {
+  changed = true;
+
+  // The last element is the new value, the rest is the path
+  Node *node = &root;
+  auto end = prev(change.end());
+
+  for (auto it = change.begin(); it != end && !node->all; it++) {
+    if (!(*it)->isString()) break; // List index
+
+    auto &child = node->children[(*it)->getString()];
+    if (child.isNull()) child = new Node;
+    node = child.get();
+  }
+
+  node->all = true;
+  node->children.clear();
+}
+
+
+ValuePtr PatchTracker::flush(const Value &current) {
+  ValuePtr ops = new List;
+
+  if (changed) flush(root, current, snapshot, "", *ops);
+
+  root    = Node();
+  changed = false;
+
+  return ops;
+}
+
+
+void PatchTracker::flush(const Node &node, const Value &current,
+                         ValuePtr &snapshot, const string &path, Value &ops) {
+  if (node.all || !current.isDict() || !snapshot->isDict()) {
+    Patch::diff(*snapshot, current, path, ops);
+    snapshot = Patch::clone(current);
+    return;
+  }
+
+  for (auto &p: node.children) {
+    auto &key = p.first;
+    string childPath = path + "/" + Patch::escape(key);
+    auto curIt = current.find(key);
+    auto snapIt = snapshot->find(key);
+
+    if (!curIt) {
+      if (snapIt) {
+        ops.append(Patch::makeOp("remove", childPath));
+        snapshot->erase(key);
+      }
+
+    } else if (!snapIt) {
+      ops.append(Patch::makeOp("add", childPath, Patch::clone(**curIt)));
+      snapshot->insert(key, Patch::clone(**curIt));
+
+    } else {
+      ValuePtr child = *snapIt;
+      flush(*p.second, **curIt, child, childPath, ops);
+      if (child.get() != (*snapIt).get()) snapshot->insert(key, child);
+    }
+  }
+}
@@ -0,0 +1,76 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Value.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <list>
+#include <map>
+#include <string>
+
+
+namespace cb {
+  namespace JSON {
+    /***
+     * Records the paths reported by Observable change notifications and
+     * turns them into one JSON Patch against a snapshot of the last
+     * flushed state.  Only changed subtrees are compared and copied.
+     * Changes inside a List mark the whole List since indices shift.
+     */
+    class PatchTracker {
+      struct Node {
+        bool all = false;
+        std::map<std::string, SmartPointer<Node>> children;
+      };
+
+      Node root;
+      ValuePtr snapshot;
+      bool changed = false;
+
+    public:
+      PatchTracker(const Value &value);
+
+      bool hasChanges() const {return changed;}
+      const ValuePtr &getSnapshot() const {return snapshot;}
+
+      void add(const std::list<ValuePtr> &change);
+      ValuePtr flush(const Value &current);
+
+    protected:
+      void flush(const Node &node, const Value &current, ValuePtr &snapshot,
+                 const std::string &path, Value &ops);
+    };
+  }
+}
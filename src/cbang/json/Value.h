@@ -141,6 +141,8 @@ namespace cb {
       {CBANG_TYPE_ERROR("Not a List");}
       virtual void append(const ValuePtr &value)
       {CBANG_TYPE_ERROR("Not a List");}
+      virtual void insert(unsigned i, const ValuePtr &value)
+      {CBANG_TYPE_ERROR("Not a List");}
       void appendFrom(const Value &value);
       virtual void clear() {CBANG_TYPE_ERROR("Not a List or Dict");}
       virtual void erase(unsigned i) {CBANG_TYPE_ERROR("Not a List");}
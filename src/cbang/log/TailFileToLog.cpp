@@ -32,53 +32,191 @@
 
 #include "TailFileToLog.h"
 
+#include <cbang/Catch.h>
 #include <cbang/os/SystemUtilities.h>
 #include <cbang/os/SysError.h>
 #include <cbang/event/Base.h>
+#include <cbang/event/FileWatcher.h>
 
 #include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define O_CLOEXEC 0
+#else
+#include <unistd.h>
+#endif
 
 using namespace std;
 using namespace cb;
 
+typedef Event::FileWatcher FW;
+
 
 TailFileToLog::TailFileToLog(
   Event::Base &base, const string &filename,
   const string &prefix, const char *logDomain, unsigned logLevel) :
-  event(base.newEvent([this] {update();})), filename(filename), prefix(prefix),
-  logDomain(logDomain), logLevel(logLevel) {event->add(0.25);}
+  filename(filename), prefix(prefix), logDomain(logDomain),
+  logLevel(logLevel), buffer(readSize) {
+
+  if (FW::isSupported())
+    try {
+      string dir = SystemUtilities::dirname(filename);
+      string name = SystemUtilities::basename(filename);
+
+      // Shared with the Base, which closes it if it goes first
+      watcher = SmartPtr(&base.getFileWatcher());
+
+      // Catches the file appearing or being replaced
+      dirWatch = watcher->add(
+        dir, FW::FW_CREATE | FW::FW_MOVED_TO,
+        [this, name] (unsigned events, const string &_name) {
+          if (_name == name || (events & FW::FW_OVERFLOW))
+            event->activate();
+        });
+
+    } CATCH_DEBUG(3);
+
+  if (dirWatch) {
+    event = base.newEvent([this] {update();}, 0);
+    event->activate();
+
+  } else {
+    // Poll
+    event = base.newEvent([this] {update();});
+    event->add(0.25);
+  }
+}
+
+
+TailFileToLog::~TailFileToLog() {
+  close();
+  if (dirWatch) watcher->remove(dirWatch);
+}
+
+
+bool TailFileToLog::open() {
+  fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  struct stat buf;
+  inode = fstat(fd, &buf) ? 0 : buf.st_ino;
+  offset = 0;
+
+  if (dirWatch)
+    try {
+      fileWatch = watcher->add(
+        filename, FW::FW_MODIFY, [this] (unsigned, const string &) {
+          event->activate();
+        });
+    } CATCH_ERROR;
+
+  return true;
+}
+
+
+void TailFileToLog::close() {
+  if (fileWatch) watcher->remove(fileWatch);
+  fileWatch = 0;
+
+  if (fd < 0) return;
+  ::close(fd);
+  fd = -1;
+}
+
+
+bool TailFileToLog::replaced() const {
+  struct stat buf;
+  return !::stat(filename.c_str(), &buf) && (uint64_t)buf.st_ino != inode;
+}
 
 
 void TailFileToLog::update() {
-  if (stream.isNull() && SystemUtilities::exists(filename))
-    stream = SystemUtilities::iopen(filename.c_str());
+  if (fd < 0 && !open()) return;
 
-  if (stream.isNull()) return;
+  for (unsigned i = 0; i < maxReads; i++) {
+    auto ret = ::read(fd, buffer.data(), readSize);
 
-  for (unsigned i = 0; i < 1e6; i++) {
-    if (!stream->good()) {
-      LOG_ERROR("Bad stream: " << SysError());
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      LOG_ERROR("Failed to read '" << filename << "': " << SysError());
+      close();
       event->del();
       return;
     }
 
-    int c = stream->get();
+    if (!ret) {
+      struct stat buf;
+
+      if (!fstat(fd, &buf) && (uint64_t)buf.st_size < offset) {
+        LOG_DEBUG(3, "'" << filename << "' truncated");
+        lseek(fd, 0, SEEK_SET);
+        offset = 0;
+        partial.clear();
+        continue;
+      }
+
+      // The old file has been drained, switch to its replacement
+      if (replaced()) {
+        LOG_DEBUG(3, "'" << filename << "' replaced");
+        close();
+        if (!open()) return;
+        partial.clear();
+        continue;
+      }
 
-    if (c == istream::traits_type::eof()) {
-      stream->clear();
-      stream->seekg(0, ios::cur); // Reset stream
       return;
     }
 
-    bytes++;
+    offset += ret;
+    bytes += ret;
+    process(buffer.data(), ret);
+  }
+
+  // Yield to other events then continue
+  if (dirWatch) event->activate();
+}
+
+
+void TailFileToLog::process(const char *data, unsigned length) {
+  const char *end = data + length;
+  string lines;
+
+  while (data < end) {
+    auto eol = (const char *)memchr(data, '\n', end - data);
+    const char *stop = eol ? eol : end;
+
+    // Split long lines so that partial never holds more than maxLine
+    while (maxLine < partial.size() + (stop - data)) {
+      unsigned n = maxLine - partial.size();
+      lines += partial;
+      lines.append(data, n);
+      lines += '\n';
+      partial.clear();
+      data += n;
+    }
 
-    if (c == '\r') continue;
-    if (c != '\n') buffer[fill++] = c;
+    if (!eol) {
+      partial.append(data, end - data);
+      break;
+    }
 
-    if (fill == bufferSize || c == '\n') {
-      buffer[fill] = 0;
-      fill = 0;
-      LOG(logDomain, logLevel, prefix + buffer);
+    if (partial.empty()) lines.append(data, eol + 1 - data);
+    else {
+      lines += partial;
+      lines.append(data, eol + 1 - data);
+      partial.clear();
     }
+
+    data = eol + 1;
   }
+
+  // One stream per batch, the LogDevice prefixes each line and drops '\r's
+  if (!lines.empty() && LOG_ENABLED(logDomain, logLevel))
+    Logger::instance().createStream(logDomain, logLevel, prefix)
+      ->write(lines.data(), lines.size());
 }
@@ -38,34 +38,57 @@
 #include <cbang/event/Event.h>
 
 #include <string>
-#include <iostream>
+#include <vector>
+#include <cstdint>
 
 
 namespace cb {
+  namespace Event {class FileWatcher;}
+
+  /***
+   * Copies lines appended to a file to the log.  Where the platform
+   * supports it, reads are driven by file change notifications from the
+   * Event::Base's shared FileWatcher, otherwise the file is polled.  The
+   * file may not exist yet and may be truncated or replaced, as is done by
+   * log rotation.
+   */
   class TailFileToLog {
+    SmartPointer<Event::FileWatcher> watcher;
     Event::EventPtr event;
-    SmartPointer<std::istream> stream;
+    unsigned dirWatch = 0;
+    unsigned fileWatch = 0;
 
     const std::string filename;
     const std::string prefix;
     const char *logDomain;
     unsigned logLevel;
 
-    static const unsigned bufferSize = 4096;
-    char buffer[bufferSize + 1]; // Room for null terminator
-    unsigned fill = 0;
+    int fd = -1;
+    uint64_t inode = 0;
+    uint64_t offset = 0;
 
-    unsigned bytes = 0;
+    static const unsigned readSize = 64 * 1024;
+    static const unsigned maxReads = 16; // Per update
+    static const unsigned maxLine = 4096; // Longer lines are split
+    std::vector<char> buffer;
+    std::string partial;
+
+    uint64_t bytes = 0;
 
   public:
     TailFileToLog(Event::Base &base, const std::string &filename,
                   const std::string &prefix = std::string(),
                   const char *logDomain = CBANG_LOG_DOMAIN,
                   unsigned logLevel = CBANG_LOG_INFO_LEVEL(1));
+    ~TailFileToLog();
 
-    unsigned getBytesCopied() const {return bytes;}
+    uint64_t getBytesCopied() const {return bytes;}
 
   protected:
+    bool open();
+    void close();
+    bool replaced() const;
     void update();
+    void process(const char *data, unsigned length);
   };
 }
@@ -0,0 +1,282 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ParallelDirectoryWalker.h"
+#include "SystemInfo.h"
+
+#include <cbang/log/Logger.h>
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include "Directory.h"
+#include "SystemUtilities.h"
+
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  unsigned threadCount(unsigned threads) {
+    if (threads) return threads;
+    unsigned count = SystemInfo::instance().getCPUCount();
+    return count ? count : 1;
+  }
+
+
+  string joinPath(const string &dir, const char *name) {
+    if (!dir.empty() && dir[dir.length() - 1] == '/') return dir + name;
+    return dir + "/" + name;
+  }
+}
+
+
+ParallelDirectoryWalker::ParallelDirectoryWalker(
+  const string &pattern, unsigned maxDepth, bool listDirs, unsigned threads) :
+  ThreadPool(threadCount(threads)), matcher(pattern), maxDepth(maxDepth),
+  listDirs(listDirs) {}
+
+
+void ParallelDirectoryWalker::walk(const string &root, callback_t cb) {
+  callback = cb;
+  error.release();
+  active = 0;
+  queue.clear();
+
+  string path = root;
+  while (1 < path.length() && path[path.length() - 1] == '/')
+    path.resize(path.length() - 1);
+  queue.push_back(make_pair(path, 1));
+
+  start();
+  wait();
+  callback = 0;
+
+  if (error.isSet()) throw *error;
+}
+
+
+vector<string> ParallelDirectoryWalker::walk(const string &root) {
+  vector<string> paths;
+
+  walk(root, [&paths] (const entries_t &entries) {
+    for (auto &e: entries) paths.push_back(e.path);
+  });
+
+  sort(paths.begin(), paths.end());
+
+  return paths;
+}
+
+
+void ParallelDirectoryWalker::push(const vector<string> &dirs,
+                                   unsigned depth) {
+  if (dirs.empty()) return;
+
+  SmartLock lock(&condition);
+  for (auto &dir: dirs) queue.push_back(make_pair(dir, depth));
+  condition.broadcast();
+}
+
+
+#ifdef _WIN32
+void ParallelDirectoryWalker::scan(const string &dir, unsigned depth,
+                                   entries_t &batch) {
+  vector<string> subdirs;
+
+  for (Directory d(dir); d; d.next()) {
+    string name = d.getFilename();
+    if (name == "." || name == "..") continue;
+
+    string path = joinPath(dir, name.c_str());
+    bool isDir = d.isSubdirectory();
+
+    if (isDir && depth < maxDepth) subdirs.push_back(path);
+
+    if (matcher.match(name) && (!isDir || listDirs)) {
+      batch.push_back(Entry(path, depth, isDir));
+
+      if (stat && !isDir) {
+        Entry &e = batch.back();
+        e.hasStat = true;
+        e.size = SystemUtilities::getFileSize(path);
+        e.mtime = SystemUtilities::getModificationTime(path);
+      }
+
+      if (batchSize <= batch.size()) flush(batch);
+    }
+  }
+
+  push(subdirs, depth + 1);
+}
+
+
+#else
+void ParallelDirectoryWalker::scan(const string &dir, unsigned depth,
+                                   entries_t &batch) {
+  // On Linux readdir() is a thin wrapper over buffered getdents64() and
+  // d_type comes from the kernel, so there is no per-entry syscall here.
+  // An unreadable root is an error, unreadable subdirectories are skipped
+  int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    if (depth == 1)
+      THROW("Failed to open directory '" << dir << "': " << strerror(errno));
+
+    LOG_WARNING("Failed to open directory '" << dir << "': "
+                << strerror(errno));
+    return;
+  }
+
+  DIR *d = fdopendir(fd);
+  if (!d) {
+    int err = errno;
+    close(fd);
+
+    if (depth == 1)
+      THROW("Failed to read directory '" << dir << "': " << strerror(err));
+
+    LOG_WARNING("Failed to read directory '" << dir << "': " << strerror(err));
+    return;
+  }
+
+  vector<string> subdirs;
+  struct dirent *ent;
+
+  while ((ent = readdir(d))) {
+    const char *name = ent->d_name;
+    if (name[0] == '.' &&
+        (!name[1] || (name[1] == '.' && !name[2]))) continue;
+
+    size_t length = strlen(name);
+    bool matched = matcher.match(name, length);
+    bool isDir = ent->d_type == DT_DIR;
+    bool haveStat = false;
+    struct stat buf;
+
+    // Lookups are relative to the open directory, not the full path
+    if (ent->d_type == DT_UNKNOWN || (matched && stat)) {
+      if (fstatat(fd, name, &buf, AT_SYMLINK_NOFOLLOW)) continue;
+      haveStat = true;
+      isDir = S_ISDIR(buf.st_mode);
+    }
+
+    if (isDir && depth < maxDepth) subdirs.push_back(joinPath(dir, name));
+
+    if (matched && (!isDir || listDirs)) {
+      batch.push_back(Entry(joinPath(dir, name), depth, isDir));
+
+      if (haveStat) {
+        Entry &e = batch.back();
+        e.hasStat = true;
+        e.size = buf.st_size;
+        e.mtime = buf.st_mtime;
+      }
+
+      if (batchSize <= batch.size()) flush(batch);
+    }
+  }
+
+  closedir(d);
+
+  push(subdirs, depth + 1);
+}
+#endif
+
+
+void ParallelDirectoryWalker::flush(entries_t &batch) {
+  if (batch.empty()) return;
+
+  SmartLock lock(&callbackLock);
+  if (callback) callback(batch);
+  batch.clear();
+}
+
+
+void ParallelDirectoryWalker::fail(const Exception &e, entries_t &batch) {
+  SmartLock lock(&condition);
+  if (error.isNull()) error = new Exception(e);
+  queue.clear();
+  batch.clear();
+}
+
+
+void ParallelDirectoryWalker::run() {
+  entries_t batch;
+
+  while (true) {
+    string dir;
+    unsigned depth;
+
+    {
+      SmartLock lock(&condition);
+
+      // Other active threads may still add work
+      while (queue.empty() && active) condition.wait();
+
+      if (queue.empty()) {
+        condition.broadcast();
+        break;
+      }
+
+      dir = queue.front().first;
+      depth = queue.front().second;
+      queue.pop_front();
+      active++;
+    }
+
+    try {
+      scan(dir, depth, batch);
+      flush(batch);
+
+    } catch (const Exception &e) {
+      fail(e, batch);
+
+    } catch (const std::exception &e) {
+      fail(Exception(e.what()), batch);
+
+    } catch (...) {
+      fail(Exception("Unknown exception"), batch);
+    }
+
+    SmartLock lock(&condition);
+    if (!--active && queue.empty()) condition.broadcast();
+  }
+}
@@ -0,0 +1,129 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/thread/ThreadPool.h>
+#include <cbang/thread/Condition.h>
+#include <cbang/thread/SmartLock.h>
+#include <cbang/util/GlobMatcher.h>
+#include <cbang/Exception.h>
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+
+
+namespace cb {
+  /***
+   * Walks a directory tree with a pool of threads, each scanning one
+   * directory at a time.  File types come from the directory entries
+   * themselves so no stat() is issued unless requested with setStat() or
+   * the file system does not report types.  Symbolic links are reported
+   * but never followed.
+   *
+   * Matching entries are delivered in batches, from the worker threads, to
+   * the callback passed to walk().  Calls to the callback are serialized.
+   * Entry order is not defined.
+   */
+  class ParallelDirectoryWalker : public ThreadPool {
+  public:
+    struct Entry {
+      std::string path;
+      unsigned depth;
+      bool isDir;
+      bool hasStat;
+      uint64_t size;
+      uint64_t mtime;
+
+      Entry(const std::string &path, unsigned depth, bool isDir) :
+        path(path), depth(depth), isDir(isDir), hasStat(false), size(0),
+        mtime(0) {}
+    };
+
+    typedef std::vector<Entry> entries_t;
+    typedef std::function<void (const entries_t &entries)> callback_t;
+
+  protected:
+    GlobMatcher matcher;
+    unsigned maxDepth;
+    bool listDirs;
+    bool stat = false;
+    unsigned batchSize = 1024;
+
+    Condition condition;
+    std::deque<std::pair<std::string, unsigned>> queue;
+    unsigned active = 0;
+    SmartPointer<Exception> error;
+
+    Mutex callbackLock;
+    callback_t callback;
+
+  public:
+    /**
+     * A maxDepth of ~0 will search indefinitely deep.
+     * A maxDepth of 0 or 1 will only search the root.
+     *
+     * @param pattern A glob matched against file names.
+     * @param maxDepth The maximum directory depth.
+     * @param listDirs Also report directories which match @param pattern.
+     * @param threads The number of threads or zero for one per CPU.
+     */
+    ParallelDirectoryWalker(const std::string &pattern = "*",
+                            unsigned maxDepth = ~0, bool listDirs = false,
+                            unsigned threads = 0);
+
+    bool getStat() const {return stat;}
+    /// Fill in Entry size and mtime.
+    void setStat(bool stat) {this->stat = stat;}
+
+    unsigned getBatchSize() const {return batchSize;}
+    void setBatchSize(unsigned batchSize) {this->batchSize = batchSize;}
+
+    /// Block until the tree under @param root has been walked.  Throws if
+    /// @param root cannot be read or a callback throws.
+    void walk(const std::string &root, callback_t cb);
+    /// @return The paths of all matching entries under @param root, sorted.
+    std::vector<std::string> walk(const std::string &root);
+
+  protected:
+    void push(const std::vector<std::string> &dirs, unsigned depth);
+    void scan(const std::string &dir, unsigned depth, entries_t &batch);
+    void flush(entries_t &batch);
+    void fail(const Exception &e, entries_t &batch);
+
+    // From ThreadPool
+    void run() override;
+  };
+}
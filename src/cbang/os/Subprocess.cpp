@@ -53,9 +53,20 @@
 #include <csignal>
 
 #include <unistd.h>
+#include <spawn.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <fcntl.h>
+
+// posix_spawn_file_actions_addchdir_np() arrived in glibc 2.29 and
+// posix_spawn_file_actions_addclosefrom_np() in 2.34
+#if defined(__GLIBC__) && (2 < __GLIBC__ || 29 <= __GLIBC_MINOR__)
+#define CBANG_HAVE_POSIX_SPAWN
+#endif
+#if defined(__GLIBC__) && (2 < __GLIBC__ || 34 <= __GLIBC_MINOR__)
+#define CBANG_HAVE_SPAWN_CLOSEFROM
+#endif
 #endif // _WIN32
 
 using namespace cb;
@@ -84,6 +95,58 @@ namespace {
     if (target != -1 && !pipe.getChildEnd().moveFD(target))
       perror("Moving file descriptor");
   }
+
+
+  // The lowest descriptor CLOSE_FDS closes, sparing extra pipes' child ends
+  int firstClosable(vector<Pipe> &pipes) {
+    int fd = 3;
+    for (unsigned i = 3; i < pipes.size(); i++)
+      fd = std::max(fd, (int)pipes[i].getChildEnd().getHandle() + 1);
+    return fd;
+  }
+
+
+  void closeFrom(int fd) {
+#ifdef SYS_close_range
+    if (!syscall(SYS_close_range, fd, ~0U, 0)) return;
+#endif
+
+    for (int max = sysconf(_SC_OPEN_MAX); fd < max; fd++) close(fd);
+  }
+
+
+#ifdef CBANG_HAVE_POSIX_SPAWN
+  bool canSpawn(unsigned flags) {
+    if (flags & (Subprocess::USE_FORK | Subprocess::USE_VFORK)) return false;
+
+#ifndef CBANG_HAVE_SPAWN_CLOSEFROM
+    if (flags & Subprocess::CLOSE_FDS) return false;
+#endif
+
+    return true;
+  }
+
+
+  void check(int err) {
+    if (err) THROW("Failed to configure subprocess spawn: " << SysError(err));
+  }
+
+
+  struct SpawnConfig {
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+
+    SpawnConfig() {
+      check(posix_spawn_file_actions_init(&actions));
+      check(posix_spawnattr_init(&attr));
+    }
+
+    ~SpawnConfig() {
+      posix_spawn_file_actions_destroy(&actions);
+      posix_spawnattr_destroy(&attr);
+    }
+  };
+#endif // CBANG_HAVE_POSIX_SPAWN
 #endif
 }
 
@@ -293,73 +356,15 @@ void Subprocess::exec(const vector<string> &_args, unsigned flags,
       args.push_back((char *)arg.c_str());
     args.push_back(0); // Sentinal
 
-#ifdef __APPLE__
-    // vfork deprecated in macos 12.0, previously discouraged
-    p->pid = fork();
-#else
-    if (flags & USE_VFORK) p->pid = vfork();
-    else p->pid = fork();
+#ifdef CBANG_HAVE_POSIX_SPAWN
+    if (canSpawn(flags)) spawn(_args, args, flags, priority);
+    else
 #endif
-
-    if (!p->pid) { // Child
-      vector<Pipe> pipes = this->pipes; // Make a copy for vfork case
-
-      // Process group
-      if (flags & CREATE_PROCESS_GROUP) setpgid(0, 0);
-
-      // Configure pipes
-      if (flags & REDIR_STDIN)  inChildProc(pipes[0], 0);
-      if (flags & REDIR_STDOUT) inChildProc(pipes[1], 1);
-
-      if (flags & MERGE_STDOUT_AND_STDERR)
-        if (dup2(1, 2) != 2) perror("Copying stdout to stderr");
-
-      if (flags & REDIR_STDERR) inChildProc(pipes[2], 2);
-
-      if ((flags & NULL_STDOUT) || (flags & NULL_STDERR)) {
-        int fd = open("/dev/null", O_WRONLY);
-
-        if (fd != -1) {
-          if (flags & NULL_STDOUT) dup2(fd, 1);
-          if (flags & NULL_STDERR) dup2(fd, 2);
-          close(fd);
-
-        } else {
-          if (flags & NULL_STDOUT) close(1);
-          if (flags & NULL_STDERR) close(2);
-        }
-      }
-
-      for (unsigned i = 3; i < pipes.size(); i++)
-        inChildProc(pipes[i]);
-
-      // Priority
-      SystemUtilities::setPriority(priority);
-
-      // Working directory
-      if (wd != "") SystemUtilities::chdir(wd);
-
-      // Setup environment
-      if (flags & CLEAR_ENVIRONMENT) SystemUtilities::clearenv();
-
-      for (auto &p: *this)
-        SystemUtilities::setenv(p.first, p.second);
-
-      SysError::clear();
-
-      if (flags & SHELL) execvp(args[0], &args[0]);
-      else execv(args[0], &args[0]);
-
-      // Execution failed
-      string errorStr = "Failed to execute: " + String::join(_args);
-      perror(errorStr.c_str());
-      exit(-1);
-
-    } else if (p->pid == -1)
-      THROW("Failed to spawn subprocess: " << SysError());
+      forkExec(_args, args, flags, priority);
 #endif // _WIN32
 
   } catch (...) {
+    returnCode = -1; // Never started, so did not exit OK
     closeHandles();
     throw;
   }
@@ -401,6 +406,161 @@ void Subprocess::exec(const string &command, unsigned flags,
 }
 
 
+#ifndef _WIN32
+void Subprocess::forkExec(const vector<string> &_args, vector<char *> &args,
+                          unsigned flags, ProcessPriority priority) {
+#ifdef __APPLE__
+  // vfork deprecated in macos 12.0, previously discouraged
+  p->pid = fork();
+#else
+  if (flags & USE_VFORK) p->pid = vfork();
+  else p->pid = fork();
+#endif
+
+  if (!p->pid) { // Child
+    vector<Pipe> pipes = this->pipes; // Make a copy for vfork case
+
+    // Process group
+    if (flags & CREATE_PROCESS_GROUP) setpgid(0, 0);
+
+    // Configure pipes
+    if (flags & REDIR_STDIN)  inChildProc(pipes[0], 0);
+    if (flags & REDIR_STDOUT) inChildProc(pipes[1], 1);
+
+    if (flags & MERGE_STDOUT_AND_STDERR)
+      if (dup2(1, 2) != 2) perror("Copying stdout to stderr");
+
+    if (flags & REDIR_STDERR) inChildProc(pipes[2], 2);
+
+    if ((flags & NULL_STDOUT) || (flags & NULL_STDERR)) {
+      int fd = open("/dev/null", O_WRONLY);
+
+      if (fd != -1) {
+        if (flags & NULL_STDOUT) dup2(fd, 1);
+        if (flags & NULL_STDERR) dup2(fd, 2);
+        close(fd);
+
+      } else {
+        if (flags & NULL_STDOUT) close(1);
+        if (flags & NULL_STDERR) close(2);
+      }
+    }
+
+    for (unsigned i = 3; i < pipes.size(); i++)
+      inChildProc(pipes[i]);
+
+    if (flags & CLOSE_FDS) closeFrom(firstClosable(pipes));
+
+    // Priority
+    SystemUtilities::setPriority(priority);
+
+    // Working directory
+    if (wd != "") SystemUtilities::chdir(wd);
+
+    // Setup environment
+    if (flags & CLEAR_ENVIRONMENT) SystemUtilities::clearenv();
+
+    for (auto &p: *this)
+      SystemUtilities::setenv(p.first, p.second);
+
+    SysError::clear();
+
+    if (flags & SHELL) execvp(args[0], &args[0]);
+    else execv(args[0], &args[0]);
+
+    // Execution failed
+    string errorStr = "Failed to execute: " + String::join(_args);
+    perror(errorStr.c_str());
+    exit(-1);
+
+  } else if (p->pid == -1)
+    THROW("Failed to spawn subprocess: " << SysError());
+}
+
+
+#ifdef CBANG_HAVE_POSIX_SPAWN
+// posix_spawn() does not copy the parent's page tables, so unlike fork() its
+// cost does not grow with the parent's memory.  The child is set up by file
+// actions and attributes instead of code run after fork().
+void Subprocess::spawn(const vector<string> &_args, vector<char *> &args,
+                       unsigned flags, ProcessPriority priority) {
+  SpawnConfig config;
+  auto actions = &config.actions;
+
+  // Close the parent ends and move the child ends into place
+  for (auto &pipe: pipes)
+    if (pipe.getParentEnd().isOpen())
+      check(posix_spawn_file_actions_addclose(actions, pipe.getParentEnd()));
+
+  auto redirect = [&] (Pipe &pipe, int target) {
+    int fd = pipe.getChildEnd();
+    check(posix_spawn_file_actions_adddup2(actions, fd, target));
+    if (fd != target) check(posix_spawn_file_actions_addclose(actions, fd));
+  };
+
+  if (flags & REDIR_STDIN)  redirect(pipes[0], 0);
+  if (flags & REDIR_STDOUT) redirect(pipes[1], 1);
+
+  if (flags & MERGE_STDOUT_AND_STDERR)
+    check(posix_spawn_file_actions_adddup2(actions, 1, 2));
+
+  if (flags & REDIR_STDERR) redirect(pipes[2], 2);
+
+  if (flags & NULL_STDOUT)
+    check(posix_spawn_file_actions_addopen(
+            actions, 1, "/dev/null", O_WRONLY, 0));
+  if (flags & NULL_STDERR)
+    check(posix_spawn_file_actions_addopen(
+            actions, 2, "/dev/null", O_WRONLY, 0));
+
+#ifdef CBANG_HAVE_SPAWN_CLOSEFROM
+  if (flags & CLOSE_FDS)
+    check(posix_spawn_file_actions_addclosefrom_np(
+            actions, firstClosable(pipes)));
+#endif
+
+  if (!wd.empty())
+    check(posix_spawn_file_actions_addchdir_np(actions, wd.c_str()));
+
+  // Process group
+  if (flags & CREATE_PROCESS_GROUP) {
+    check(posix_spawnattr_setflags(&config.attr, POSIX_SPAWN_SETPGROUP));
+    check(posix_spawnattr_setpgroup(&config.attr, 0));
+  }
+
+  // Environment
+  vector<string> env;
+  if (!(flags & CLEAR_ENVIRONMENT))
+    for (char **var = environ; *var; var++) {
+      const char *equal = strchr(*var, '=');
+      string name = equal ? string(*var, equal - *var) : string(*var);
+      if (StringMap::find(name) == StringMap::end()) env.push_back(*var);
+    }
+
+  for (auto &p: *this) env.push_back(p.first + "=" + p.second);
+
+  vector<char *> envp;
+  for (auto &var: env) envp.push_back((char *)var.c_str());
+  envp.push_back(0); // Sentinal
+
+  pid_t pid;
+  int err = (flags & SHELL ? posix_spawnp : posix_spawn)(
+    &pid, args[0], actions, &config.attr, &args[0], &envp[0]);
+  if (err)
+    THROW("Failed to execute: " << String::join(_args) << ": "
+          << SysError(err));
+
+  p->pid = pid;
+
+  // Set from the parent, the child briefly runs at the inherited priority
+  try {
+    SystemUtilities::setPriority(priority, pid);
+  } CATCH_WARNING;
+}
+#endif // CBANG_HAVE_POSIX_SPAWN
+#endif // _WIN32
+
+
 void Subprocess::interrupt() {
   if (!running) THROW("Process not running!");
 
@@ -423,7 +583,7 @@ bool Subprocess::kill(bool nonblocking) {
   if (!h || !TerminateProcess(h, -1)) return false;
 
 #else
-  if (!(signalGroup ? ::killpg : ::kill)((pid_t)getPID(), SIGKILL))
+  if ((signalGroup ? ::killpg : ::kill)((pid_t)getPID(), SIGKILL))
     return false;
 #endif
 
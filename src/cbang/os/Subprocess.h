@@ -59,6 +59,8 @@ namespace cb {
       W32_WAIT_FOR_INPUT_IDLE = 1 << 10,
       MAX_PIPE_SIZE           = 1 << 11,
       USE_VFORK               = 1 << 12,
+      USE_FORK                = 1 << 13,
+      CLOSE_FDS               = 1 << 14,
     };
 
     enum {
@@ -118,6 +120,12 @@ namespace cb {
     static unsigned priorityToClass(ProcessPriority priority);
 
   protected:
+    void forkExec(const std::vector<std::string> &_args,
+                  std::vector<char *> &args, unsigned flags,
+                  ProcessPriority priority);
+    void spawn(const std::vector<std::string> &_args,
+               std::vector<char *> &args, unsigned flags,
+               ProcessPriority priority);
     void closeProcessHandles();
     void closePipes();
     void closeHandles();
@@ -56,6 +56,8 @@
 #include <boost/filesystem/operations.hpp>
 #include <cbang/boost/EndInclude.h>
 
+#include <cstdlib>
+
 
 using namespace cb;
 using namespace std;
@@ -81,6 +83,17 @@ SystemInfo &SystemInfo::instance() {
 }
 
 
+double SystemInfo::getLoadAverage() const {
+#ifdef _WIN32
+  return -1;
+
+#else
+  double load;
+  return getloadavg(&load, 1) == 1 ? load : -1;
+#endif
+}
+
+
 uint64_t SystemInfo::getFreeDiskSpace(const string &path) {
   fs::space_info si;
 
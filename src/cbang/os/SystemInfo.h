@@ -63,6 +63,12 @@ namespace cb {
     virtual uint32_t getCPUCount() const = 0;
     virtual uint32_t getPerformanceCPUCount() const {return 0;}
 
+    // CPUs this process may use, limited by any cgroup CPU quota
+    virtual double getCPUQuota() const {return getCPUCount();}
+
+    // One minute load average, negative if not available
+    virtual double getLoadAverage() const;
+
     virtual uint64_t getMemoryInfo(memory_info_t type) const = 0;
     uint64_t getTotalMemory()    const {return getMemoryInfo(MEM_INFO_TOTAL);}
     uint64_t getFreeMemory()     const {return getMemoryInfo(MEM_INFO_FREE);}
@@ -57,6 +57,33 @@ namespace {
     if (!value) value = SystemUtilities::getenv(String::toUpper(name));
     return String::trim(string(value ? value : ""));
   }
+
+
+  // Returns the quota in CPUs, or zero if there is none
+  double get_cgroup_quota() {
+    // cgroup v2: "<quota> <period>" or "max <period>"
+    const char *v2 = "/sys/fs/cgroup/cpu.max";
+    if (SystemUtilities::exists(v2)) {
+      auto f = SystemUtilities::iopen(v2);
+      string quota;
+      double period = 0;
+      *f >> quota >> period;
+      if (quota == "max" || period <= 0) return 0;
+      return String::parseDouble(quota) / period;
+    }
+
+    // cgroup v1: a quota of -1 means unlimited
+    const char *v1 = "/sys/fs/cgroup/cpu/cpu.cfs_quota_us";
+    const char *v1Period = "/sys/fs/cgroup/cpu/cpu.cfs_period_us";
+    if (SystemUtilities::exists(v1) && SystemUtilities::exists(v1Period)) {
+      double quota = 0, period = 0;
+      *SystemUtilities::iopen(v1) >> quota;
+      *SystemUtilities::iopen(v1Period) >> period;
+      if (0 < quota && 0 < period) return quota / period;
+    }
+
+    return 0;
+  }
 }
 
 
@@ -66,6 +93,18 @@ uint32_t LinSystemInfo::getCPUCount() const {
 }
 
 
+double LinSystemInfo::getCPUQuota() const {
+  double cpus = getCPUCount();
+
+  try {
+    double quota = get_cgroup_quota();
+    if (0 < quota && quota < cpus) return quota;
+  } CATCH_DEBUG(1);
+
+  return cpus;
+}
+
+
 uint64_t LinSystemInfo::getMemoryInfo(memory_info_t type) const {
   const char *search;
   switch (type) {
@@ -0,0 +1,179 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "GlobMatcher.h"
+
+#include <cbang/Exception.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace cb;
+
+
+bool GlobMatcher::Token::match(char x) const {
+  switch (type) {
+  case TOKEN_CHAR: return x == c;
+  case TOKEN_ONE: return true;
+
+  case TOKEN_SET:
+    for (auto &r: ranges)
+      if (r.first <= (unsigned char)x && (unsigned char)x <= r.second)
+        return !negate;
+    return negate;
+
+  default: return false;
+  }
+}
+
+
+GlobMatcher::GlobMatcher(const string &pattern) : pattern(pattern) {
+  compile();
+}
+
+
+bool GlobMatcher::match(const char *s, size_t length) const {
+  size_t n = literal.length();
+
+  switch (kind) {
+  case GLOB_ANY: return true;
+  case GLOB_LITERAL:
+    return length == n && !memcmp(s, literal.data(), n);
+  case GLOB_PREFIX:
+    return n <= length && !memcmp(s, literal.data(), n);
+  case GLOB_SUFFIX:
+    return n <= length && !memcmp(s + length - n, literal.data(), n);
+  case GLOB_CONTAINS:
+    return string::npos != string(s, length).find(literal);
+  default: return matchTokens(s, length);
+  }
+}
+
+
+void GlobMatcher::compile() {
+  const char *s = pattern.c_str();
+
+  while (*s) {
+    switch (*s) {
+    case '*':
+      // Collapse runs of '*'
+      if (tokens.empty() || tokens.back().type != TOKEN_STAR)
+        tokens.push_back(Token(TOKEN_STAR));
+      s++;
+      break;
+
+    case '?': tokens.push_back(Token(TOKEN_ONE)); s++; break;
+
+    case '\\':
+      if (s[1]) s++;
+      tokens.push_back(Token(TOKEN_CHAR, *s++));
+      break;
+
+    case '[': {
+      Token token(TOKEN_SET);
+      const char *p = s + 1;
+
+      if (*p == '!' || *p == '^') {token.negate = true; p++;}
+
+      // A ']' directly after the opening bracket is literal
+      bool first = true;
+      while (*p && (first || *p != ']')) {
+        unsigned char lo = *p++;
+        unsigned char hi = lo;
+
+        if (*p == '-' && p[1] && p[1] != ']') {hi = p[1]; p += 2;}
+        if (hi < lo) THROW("Invalid range in glob '" << pattern << "'");
+
+        token.ranges.push_back(make_pair(lo, hi));
+        first = false;
+      }
+
+      // Unterminated sets match a literal '['
+      if (*p != ']') {tokens.push_back(Token(TOKEN_CHAR, *s++)); break;}
+
+      tokens.push_back(token);
+      s = p + 1;
+      break;
+    }
+
+    default: tokens.push_back(Token(TOKEN_CHAR, *s++)); break;
+    }
+  }
+
+  // Classify the pattern by the position of its stars
+  bool leading  = !tokens.empty() && tokens.front().type == TOKEN_STAR;
+  bool trailing = 1 < tokens.size() && tokens.back().type == TOKEN_STAR;
+  unsigned chars = 0;
+
+  for (auto &token: tokens)
+    if (token.type == TOKEN_CHAR) {literal += token.c; chars++;}
+
+  unsigned wild = tokens.size() - chars;
+
+  if (tokens.size() == 1 && leading) kind = GLOB_ANY;
+  else if (!wild) kind = GLOB_LITERAL;
+  else if (wild == 1 && trailing) kind = GLOB_PREFIX;
+  else if (wild == 1 && leading) kind = GLOB_SUFFIX;
+  else if (wild == 2 && leading && trailing) kind = GLOB_CONTAINS;
+  else kind = GLOB_GENERAL;
+
+  if (kind == GLOB_GENERAL) literal.clear();
+}
+
+
+bool GlobMatcher::matchTokens(const char *s, size_t length) const {
+  // Iterative matching which backtracks only to the most recent star
+  size_t t = 0;
+  size_t i = 0;
+  size_t starT = string::npos;
+  size_t starI = 0;
+
+  while (i < length) {
+    if (t < tokens.size() && tokens[t].type == TOKEN_STAR) {
+      starT = t++;
+      starI = i;
+
+    } else if (t < tokens.size() && tokens[t].match(s[i])) {
+      t++;
+      i++;
+
+    } else if (starT != string::npos) {
+      t = starT + 1;
+      i = ++starI;
+
+    } else return false;
+  }
+
+  while (t < tokens.size() && tokens[t].type == TOKEN_STAR) t++;
+
+  return t == tokens.size();
+}
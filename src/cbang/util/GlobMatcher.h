@@ -0,0 +1,85 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  /***
+   * Matches file names against a shell glob compiled once up front.
+   * Supports '*', '?', '[abc]', '[a-z]', '[!a-z]' and '\' escapes.
+   * Patterns which reduce to a literal, prefix, suffix or substring test
+   * avoid the general matcher.
+   */
+  class GlobMatcher {
+    enum kind_t {
+      GLOB_ANY,       // *
+      GLOB_LITERAL,   // abc
+      GLOB_PREFIX,    // abc*
+      GLOB_SUFFIX,    // *abc
+      GLOB_CONTAINS,  // *abc*
+      GLOB_GENERAL,
+    };
+
+    enum {TOKEN_CHAR, TOKEN_ONE, TOKEN_STAR, TOKEN_SET};
+
+    struct Token {
+      unsigned type;
+      char c;
+      bool negate;
+      std::vector<std::pair<unsigned char, unsigned char>> ranges;
+
+      Token(unsigned type, char c = 0) : type(type), c(c), negate(false) {}
+      bool match(char x) const;
+    };
+
+    std::string pattern;
+    kind_t kind;
+    std::string literal;
+    std::vector<Token> tokens;
+
+  public:
+    GlobMatcher(const std::string &pattern = "*");
+
+    const std::string &getPattern() const {return pattern;}
+
+    bool match(const char *s, size_t length) const;
+    bool match(const std::string &s) const {return match(s.data(), s.size());}
+
+  protected:
+    void compile();
+    bool matchTokens(const char *s, size_t length) const;
+  };
+}
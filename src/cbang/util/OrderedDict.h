@@ -33,74 +33,122 @@
 #pragma once
 
 #include <cbang/SmartPointer.h>
+#include <cbang/util/StringICmp.h>
 
-#include <map>
+#include <vector>
 #include <string>
+#include <functional>
+#include <cstdint>
+#include <utility>
+#include <cctype>
 
 
 namespace cb {
+  /// Hash and equality consistent with an OrderedDict KeyLess
+  template <typename Key, typename KeyLess> struct OrderedDictKey;
+
+
+  template <typename Key>
+  struct OrderedDictKey<Key, std::less<Key>> {
+    static size_t hash(const Key &key) {return std::hash<Key>()(key);}
+    static bool equal(const Key &a, const Key &b) {return a == b;}
+  };
+
+
+  template <>
+  struct OrderedDictKey<std::string, StringILess> {
+    static size_t hash(const std::string &key) {
+      uint64_t h = 14695981039346656037ULL; // FNV-1a
+
+      for (auto c: key) {
+        h ^= (uint8_t)std::tolower((unsigned char)c);
+        h *= 1099511628211ULL;
+      }
+
+      return h;
+    }
+
+
+    static bool equal(const std::string &a, const std::string &b) {
+      return !StringICmp()(a, b);
+    }
+  };
+
+
+  /**
+   * Entries are heap allocated once and kept in insertion order in a vector
+   * of pointers.  Erased entries leave a null slot until the null slots
+   * outnumber the live entries and are then compacted.  Small dicts are
+   * searched linearly, larger ones through an open addressing hash index.
+   *
+   * Entries never move, so references to values and iterators remain valid
+   * until their own entry is erased.
+   */
   template <typename Key, typename Value, typename KeyLess = std::less<Key>>
   class OrderedDict {
   private:
-    struct MapEntry;
-
-    using dict_t = std::map<Key, SmartPointer<struct MapEntry>, KeyLess>;
+    using KeyTraits = OrderedDictKey<Key, KeyLess>;
 
-    struct MapEntry {
+    struct Entry {
+      Key key;
       Value value;
-      MapEntry *prev = 0;
-      MapEntry *next = 0;
-      typename dict_t::iterator it;
+      size_t hash;
+      size_t pos; // Position in order
 
-      MapEntry(const Value &value) : value(value) {}
+      Entry(const Key &key, const Value &value, size_t hash) :
+        key(key), value(value), hash(hash) {}
     };
 
+    static constexpr unsigned linearMax = 8;
+
     struct Iterator;
 
     struct ConstIterator {
-      MapEntry *e;
+      const OrderedDict *d;
+      Entry *e;
 
-      ConstIterator(MapEntry *e = 0) : e(e) {}
-      ConstIterator(const ConstIterator &o) : e(o.e) {}
+      ConstIterator(const OrderedDict *d = 0, Entry *e = 0) : d(d), e(e) {}
+      ConstIterator(const ConstIterator &o) : d(o.d), e(o.e) {}
       ConstIterator(const Iterator &o);
 
-      ConstIterator &operator=(const ConstIterator &o) {e = o.e; return *this;}
+      ConstIterator &operator=(const ConstIterator &o)
+      {d = o.d; e = o.e; return *this;}
       bool operator==(const ConstIterator &o) const {return e == o.e;}
       bool operator!=(const ConstIterator &o) const {return e != o.e;}
 
 
       ConstIterator &operator++() {
-        if (e) e = e->next;
+        if (e) e = d->_next(e->pos + 1);
         return *this;
       }
 
 
       ConstIterator operator++(int) {
-        auto saveE = e;
-        if (e) e = e->next;
-        return ConstIterator(saveE);
+        auto save = *this;
+        ++*this;
+        return save;
       }
 
 
       ConstIterator &operator--() {
-        if (e) e = e->prev;
+        if (e) e = d->_prev(e->pos);
         return *this;
       }
 
 
       ConstIterator operator--(int) {
-        auto saveE = e;
-        if (e) e = e->prev;
-        return ConstIterator(saveE);
+        auto save = *this;
+        --*this;
+        return save;
       }
 
-      const Key   &key()        const {return  deref().it->first;}
+      const Key   &key()        const {return  deref().key;}
       const Value &value()      const {return  deref().value;}
       const Value *operator->() const {return &value();}
       const Value &operator*()  const {return  value();}
 
 
-      MapEntry &deref() const {
+      Entry &deref() const {
         if (!e) CBANG_THROW("Cannot dereference null iterator");
         return *e;
       }
@@ -129,19 +177,17 @@ namespace cb {
     };
 
 
-    dict_t dict;
-    MapEntry *head = 0;
-    MapEntry *tail = 0;
+    std::vector<Entry *> order;     // Insertion order, null if erased
+    std::vector<Entry *> hashIndex; // Open addressing, null if empty
+    size_t liveCount = 0;
 
   public:
-    using size_type = typename dict_t::size_type;
-
+    using size_type = size_t;
 
     OrderedDict() {}
     OrderedDict(const OrderedDict &o) {*this = o;}
-    OrderedDict(OrderedDict &&o) = default;
-
-    OrderedDict &operator=(OrderedDict &&o) = default;
+    OrderedDict(OrderedDict &&o) {*this = std::move(o);}
+    ~OrderedDict() {clear();}
 
 
     OrderedDict &operator=(const OrderedDict &o) {
@@ -154,95 +200,205 @@ namespace cb {
     }
 
 
-    void clear() {dict.clear(); head = tail = 0;}
-    bool empty() const {return dict.empty();}
-    size_type size() const {return dict.size();}
+    OrderedDict &operator=(OrderedDict &&o) {
+      if (this != &o) {
+        clear();
+        order.swap(o.order);
+        hashIndex.swap(o.hashIndex);
+        std::swap(liveCount, o.liveCount);
+      }
+
+      return *this;
+    }
+
+
+    void clear() {
+      for (auto e: order) delete e;
+      order.clear();
+      hashIndex.clear();
+      liveCount = 0;
+    }
+
+
+    bool empty() const {return !liveCount;}
+    size_type size() const {return liveCount;}
 
     using iterator       = EntriesIterator;
     using const_iterator = ConstEntriesIterator;
-    const_iterator begin() const {return const_iterator(head);}
-    const_iterator end()   const {return const_iterator(0);}
-    iterator       begin()       {return iterator(head);}
-    iterator       end()         {return iterator(0);}
+    const_iterator begin() const {return const_iterator(this, _next(0));}
+    const_iterator end()   const {return const_iterator(this);}
+    iterator       begin()       {return iterator(this, _next(0));}
+    iterator       end()         {return iterator(this);}
 
 
     const_iterator find(const Key &key) const {
-      auto it = dict.find(key);
-      return it == dict.end() ? end() : const_iterator(it->second.get());
+      return const_iterator(this, _find(key, KeyTraits::hash(key)));
     }
 
 
     iterator find(const Key &key) {
-      auto it = dict.find(key);
-      return it == dict.end() ? end() : iterator(it->second.get());
+      return iterator(this, _find(key, KeyTraits::hash(key)));
     }
 
 
     iterator insert(const Key &key, const Value &value, bool prepend = false) {
-      auto it = dict.find(key);
-      if (it == dict.end()) it = _insert(key, value, prepend);
-      else it->second->value = value;
-      return iterator(it->second.get());
+      size_t hash = KeyTraits::hash(key);
+      Entry *e = _find(key, hash);
+
+      if (!e) e = _insert(new Entry(key, value, hash), prepend);
+      else e->value = value;
+
+      return iterator(this, e);
     }
 
 
     Value &operator[](const Key &key) {
-      auto it = dict.find(key);
-      if (it == dict.end()) it = _insert(key);
-      return it->second->value;
+      size_t hash = KeyTraits::hash(key);
+      Entry *e = _find(key, hash);
+      if (!e) e = _insert(new Entry(key, Value(), hash), false);
+      return e->value;
     }
 
 
     iterator erase(const Key &key) {
-      auto it = dict.find(key);
-      if (it == dict.end()) return end();
-      return erase(iterator(it->second.get()));
+      Entry *e = _find(key, KeyTraits::hash(key));
+      return e ? iterator(this, _erase(e)) : end();
     }
 
 
     iterator erase(iterator it) {
-      auto e = it.e;
-      if (!e) CBANG_THROW("Cannot erase empty iterator");
-
-      auto next = e->next;
-      _erase(e);
-      return iterator(next);
+      if (!it.e) CBANG_THROW("Cannot erase empty iterator");
+      return iterator(this, _erase(it.e));
     }
 
 
   private:
-    const typename dict_t::iterator &_insert(
-      const Key &key, const Value &value = Value(), bool prepend = false) {
-      auto e = new MapEntry(value);
+    Entry *_next(size_t i) const {
+      for (; i < order.size(); i++) if (order[i]) return order[i];
+      return 0;
+    }
+
+
+    Entry *_prev(size_t i) const {
+      while (i--) if (order[i]) return order[i];
+      return 0;
+    }
+
+
+    Entry *_find(const Key &key, size_t hash) const {
+      if (hashIndex.empty()) {
+        for (auto e: order)
+          if (e && e->hash == hash && KeyTraits::equal(e->key, key))
+            return e;
+
+        return 0;
+      }
+
+      size_t mask = hashIndex.size() - 1;
+
+      for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        Entry *e = hashIndex[slot];
+        if (!e) return 0;
+        if (e->hash == hash && KeyTraits::equal(e->key, key)) return e;
+      }
+    }
+
+
+    void _index(Entry *e) {
+      size_t mask = hashIndex.size() - 1;
+      size_t slot = e->hash & mask;
+      while (hashIndex[slot]) slot = (slot + 1) & mask;
+      hashIndex[slot] = e;
+    }
+
+
+    void _unindex(Entry *e) {
+      size_t mask = hashIndex.size() - 1;
+      size_t slot = e->hash & mask;
+      while (hashIndex[slot] != e) slot = (slot + 1) & mask;
+
+      // Shift later entries of the probe run back so no tombstones are needed
+      for (size_t next = (slot + 1) & mask; hashIndex[next];
+           next = (next + 1) & mask) {
+        size_t home = hashIndex[next]->hash & mask;
+
+        // Move unless home lies cyclically in (slot, next]
+        if (slot <= next ? (home <= slot || next < home) :
+            (home <= slot && next < home)) {
+          hashIndex[slot] = hashIndex[next];
+          slot = next;
+        }
+      }
+
+      hashIndex[slot] = 0;
+    }
+
+
+    void _reindex() {
+      hashIndex.clear();
+      if (liveCount <= linearMax) return;
+
+      // Keep the load factor at or below 1/2 after rebuilding
+      size_t size = 16;
+      while (size < liveCount * 2) size *= 2;
+      hashIndex.resize(size, 0);
+
+      for (auto e: order) if (e) _index(e);
+    }
+
+
+    void _compact() {
+      size_t j = 0;
+
+      for (size_t i = 0; i < order.size(); i++)
+        if (order[i]) {
+          order[j] = order[i];
+          order[j]->pos = j;
+          j++;
+        }
+
+      order.resize(j);
+    }
+
+
+    Entry *_insert(Entry *e, bool prepend) {
+      liveCount++;
 
       if (prepend) {
-        e->next = head;
-        if (head) head->prev = e;
-        if (!tail) tail = e;
-        head = e;
+        order.insert(order.begin(), e);
+        for (size_t i = 0; i < order.size(); i++)
+          if (order[i]) order[i]->pos = i;
 
       } else {
-        e->prev = tail;
-        if (tail) tail->next = e;
-        if (!head) head = e;
-        tail = e;
+        e->pos = order.size();
+        order.push_back(e);
       }
 
-      return e->it = dict.insert(typename dict_t::value_type(key, e)).first;
+      if (hashIndex.empty() ? linearMax < liveCount :
+          hashIndex.size() * 3 < liveCount * 4) _reindex();
+      else if (!hashIndex.empty()) _index(e);
+
+      return e;
     }
 
 
-    void _erase(MapEntry *e) {
-      if (head == e) head = e->next;
-      if (tail == e) tail = e->prev;
-      if (e->prev) e->prev->next = e->next;
-      if (e->next) e->next->prev = e->prev;
+    Entry *_erase(Entry *e) {
+      if (!hashIndex.empty()) _unindex(e);
+
+      Entry *next = _next(e->pos + 1);
+      order[e->pos] = 0;
+      delete e;
+      liveCount--;
 
-      dict.erase(e->it);
+      size_t dead = order.size() - liveCount;
+      if (linearMax < dead && liveCount < dead) _compact();
+
+      return next;
     }
   };
 
+
   template <typename Key, typename Value, typename KeyLess>
   OrderedDict<Key, Value, KeyLess>::ConstIterator::ConstIterator(
-    const Iterator &o) : e(o.e) {}
+    const Iterator &o) : d(o.d), e(o.e) {}
 }
@@ -45,20 +45,24 @@ const Resource &Resource::get(const string &path) const {
 }
 
 
-const Resource *DirectoryResource::find(const string &path) const {
-  if (path.empty()) return 0;
-  if (path[0] == '/') return find(path.substr(1));
+const Resource *DirectoryResource::findChild(const string &name) const {
+  call_once(indexed, [this] {
+    for (unsigned i = 0; children && children[i]; i++)
+      index.insert(make_pair(string(children[i]->name), children[i]));
+  });
+
+  auto it = index.find(name);
+  return it == index.end() ? 0 : it->second;
+}
 
-  string::size_type pos = path.find('/');
-  string name;
-  if (pos == string::npos) name = path;
-  else name = path.substr(0, pos);
 
-  for (unsigned i = 0; children[i]; i++)
-    if (name == children[i]->name) {
-      if (pos == string::npos) return children[i];
-      return children[i]->find(path.substr(pos + 1));
-    }
+const Resource *DirectoryResource::find(const string &path) const {
+  auto start = path.find_first_not_of('/');
+  if (start == string::npos) return 0;
+
+  auto end = path.find('/', start);
+  const Resource *child = findChild(path.substr(start, end - start));
+  if (!child || end == string::npos) return child;
 
-  return 0;
+  return child->find(path.substr(end + 1));
 }
@@ -36,6 +36,8 @@
 
 #include <string>
 #include <ostream>
+#include <mutex>
+#include <unordered_map>
 
 
 namespace cb {
@@ -63,6 +65,12 @@ namespace cb {
     virtual std::string toString() const
     {CBANG_THROW(CBANG_FUNC << "() not supported by resource");}
 
+    // Precomputed file metadata, 0 if not available
+    virtual const char *getContentType() const {return 0;}
+    virtual const char *getETag() const {return 0;}
+    virtual const char *getGZipData() const {return 0;}
+    virtual unsigned getGZipLength() const {return 0;}
+
     const Resource &get(const std::string &path) const;
   };
 
@@ -71,24 +79,41 @@ namespace cb {
   public:
     const char *data;
     const unsigned length;
+    const char *type;
+    const char *etag;
+    const char *gzData;
+    const unsigned gzLength;
 
-    FileResource(const char *name, const char *data, unsigned length) :
-      Resource(name), data(data), length(length) {}
+    FileResource(const char *name, const char *data, unsigned length,
+                 const char *type = 0, const char *etag = 0,
+                 const char *gzData = 0, unsigned gzLength = 0) :
+      Resource(name), data(data), length(length), type(type), etag(etag),
+      gzData(gzData), gzLength(gzLength) {}
 
     // From Resource
     const char *getData() const override {return data;}
     unsigned getLength() const override {return length;}
     std::string toString() const override {return std::string(data, length);}
+    const char *getContentType() const override {return type;}
+    const char *getETag() const override {return etag;}
+    const char *getGZipData() const override {return gzData;}
+    unsigned getGZipLength() const override {return gzLength;}
   };
 
 
   class DirectoryResource : public Resource {
+    mutable std::once_flag indexed;
+    mutable std::unordered_map<std::string, const Resource *> index;
+
   public:
     const Resource **children;
 
     DirectoryResource(const char *name, const Resource **children) :
       Resource(name), children(children) {}
 
+    /// Look up an immediate child by name via a lazily built hash index
+    const Resource *findChild(const std::string &name) const;
+
     // From Resource
     bool isDirectory() const override {return true;}
     const Resource *find(const std::string &path) const override;
@@ -0,0 +1,295 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ResourceBundle.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/comp/Press.h>
+
+#include <cbang/boost/StartInclude.h>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cbang/boost/EndInclude.h>
+
+#include <list>
+#include <map>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const char *magic = "CBRB";
+
+
+  uint32_t readU32(const char *&ptr, const char *end) {
+    if (end - ptr < 4) THROW("Truncated resource bundle");
+
+    const uint8_t *p = (const uint8_t *)ptr;
+    ptr += 4;
+
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+  }
+
+
+  const char *readField(const char *&ptr, const char *end, unsigned &length) {
+    length = readU32(ptr, end);
+    if ((uint64_t)(end - ptr) <= length || ptr[length])
+      THROW("Invalid resource bundle field");
+
+    const char *field = ptr;
+    ptr += length + 1;
+
+    return field;
+  }
+
+
+  void writeU32(ostream &stream, uint32_t x) {
+    char buf[4] = {(char)x, (char)(x >> 8), (char)(x >> 16), (char)(x >> 24)};
+    stream.write(buf, 4);
+  }
+
+
+  void writeField(ostream &stream, const char *data, unsigned length) {
+    writeU32(stream, length);
+    if (length) stream.write(data, length);
+    stream.put(0);
+  }
+
+
+  void writeField(ostream &stream, const string &s) {
+    writeField(stream, s.data(), s.length());
+  }
+
+
+  typedef vector<pair<string, const Resource *>> files_t;
+
+  void collect(const Resource &res, const string &path, files_t &files) {
+    if (!res.isDirectory()) return files.push_back(make_pair(path, &res));
+
+    for (unsigned i = 0; res.getChild(i); i++) {
+      const Resource &child = *res.getChild(i);
+      string name = child.getName();
+      collect(child, path.empty() ? name : path + "/" + name, files);
+    }
+  }
+}
+
+
+struct ResourceBundle::private_t {
+  SmartPointer<boost::iostreams::mapped_file_source> file;
+
+  list<string> names;
+  list<vector<const Resource *>> children;
+  vector<SmartPointer<Resource>> resources;
+
+  typedef pair<DirectoryResource *, vector<const Resource *> *> dir_t;
+  map<string, dir_t> dirs;
+  unordered_map<string, const Resource *> index;
+  unsigned files = 0;
+
+
+  void add(const string &path, const Resource *res) {
+    if (!index.insert(make_pair(path, res)).second)
+      THROW("Duplicate resource bundle path '" << path << "'");
+  }
+
+
+  vector<const Resource *> &getDir(const string &path) {
+    auto it = dirs.find(path);
+    if (it != dirs.end()) return *it->second.second;
+
+    auto slash = path.rfind('/');
+    auto &parent =
+      getDir(slash == string::npos ? string() : path.substr(0, slash));
+
+    names.push_back(slash == string::npos ? path : path.substr(slash + 1));
+    children.push_back(vector<const Resource *>());
+
+    SmartPointer<DirectoryResource> dir =
+      new DirectoryResource(names.back().c_str(), 0);
+    resources.push_back(dir);
+    parent.push_back(dir.get());
+    dirs[path] = dir_t(dir.get(), &children.back());
+    add(path, dir.get());
+
+    return children.back();
+  }
+};
+
+
+ResourceBundle::ResourceBundle(const string &path) :
+  DirectoryResource("", 0), pri(new private_t) {
+  try {
+    pri->file = new boost::iostreams::mapped_file_source(path);
+  } catch (const std::exception &e) {
+    THROW("Failed to map resource bundle '" << path << "': " << e.what());
+  }
+
+  if (numeric_limits<uint32_t>::max() < pri->file->size())
+    THROW("Resource bundle '" << path << "' too large");
+
+  load(pri->file->data(), pri->file->size());
+}
+
+
+ResourceBundle::ResourceBundle(const char *data, unsigned length) :
+  DirectoryResource("", 0), pri(new private_t) {load(data, length);}
+
+
+ResourceBundle::~ResourceBundle() {}
+
+
+unsigned ResourceBundle::getFileCount() const {return pri->files;}
+
+
+string ResourceBundle::computeETag(const char *data, unsigned length) {
+  // 64-bit FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  for (unsigned i = 0; i < length; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 0x100000001b3ULL;
+  }
+
+  return String::printf("\"%016llx\"", (unsigned long long)hash);
+}
+
+
+void ResourceBundle::write(ostream &stream, const Resource &root, bool gzip) {
+  if (!root.isDirectory()) THROW("Resource bundle root must be a directory");
+
+  files_t files;
+  collect(root, "", files);
+  sort(files.begin(), files.end());
+
+  stream.write(magic, 4);
+  writeU32(stream, VERSION);
+  writeU32(stream, files.size());
+
+  for (auto &file : files) {
+    const Resource &res = *file.second;
+    const char *data = res.getData();
+    unsigned length = res.getLength();
+    const char *type = res.getContentType();
+    const char *etag = res.getETag();
+
+    writeField(stream, file.first);
+    writeField(stream, type ? type : "");
+    writeField(stream, etag ? string(etag) : computeETag(data, length));
+    writeField(stream, data, length);
+
+    if (res.getGZipData())
+      writeField(stream, res.getGZipData(), res.getGZipLength());
+
+    else {
+      string gz;
+      if (gzip)
+        gz = Press(Compression::COMPRESSION_GZIP)(string(data, length));
+
+      // Only keep variants which save at least 10%
+      if (gz.empty() || length * 0.9 < gz.length()) writeField(stream, "", 0);
+      else writeField(stream, gz);
+    }
+  }
+
+  if (!stream) THROW("Failed to write resource bundle");
+}
+
+
+const Resource *ResourceBundle::find(const string &path) const {
+  auto start = path.find_first_not_of('/');
+  if (start == string::npos) return 0;
+
+  auto it = pri->index.find(start ? path.substr(start) : path);
+  return it == pri->index.end() ? 0 : it->second;
+}
+
+
+void ResourceBundle::load(const char *data, unsigned length) {
+  const char *ptr = data;
+  const char *end = data + length;
+
+  if (length < 4 || string(data, 4) != magic) THROW("Not a resource bundle");
+  ptr += 4;
+
+  unsigned version = readU32(ptr, end);
+  if (version != VERSION)
+    THROW("Unsupported resource bundle version " << version);
+
+  unsigned count = readU32(ptr, end);
+
+  pri->children.push_back(vector<const Resource *>());
+  pri->dirs[""] = private_t::dir_t(this, &pri->children.back());
+
+  for (unsigned i = 0; i < count; i++) {
+    unsigned pathLen, typeLen, etagLen, dataLen, gzLen;
+    const char *path   = readField(ptr, end, pathLen);
+    const char *type   = readField(ptr, end, typeLen);
+    const char *etag   = readField(ptr, end, etagLen);
+    const char *fdata  = readField(ptr, end, dataLen);
+    const char *gzData = readField(ptr, end, gzLen);
+
+    string fullPath(path, pathLen);
+    if (fullPath.empty() || fullPath[0] == '/' || fullPath.back() == '/' ||
+        fullPath.find("//") != string::npos)
+      THROW("Invalid resource bundle path '" << fullPath << "'");
+
+    auto slash = fullPath.rfind('/');
+    auto &parent =
+      pri->getDir(slash == string::npos ? string() : fullPath.substr(0, slash));
+
+    // Names and data point directly into the bundle
+    const char *name = slash == string::npos ? path : path + slash + 1;
+    SmartPointer<Resource> res =
+      new FileResource(name, fdata, dataLen, typeLen ? type : 0,
+                       etagLen ? etag : 0, gzLen ? gzData : 0, gzLen);
+
+    pri->resources.push_back(res);
+    parent.push_back(res.get());
+    pri->add(fullPath, res.get());
+    pri->files++;
+  }
+
+  if (ptr != end) THROW("Trailing data in resource bundle");
+
+  // Terminate and attach child lists
+  for (auto &it : pri->dirs) {
+    auto &children = *it.second.second;
+    children.push_back(0);
+    it.second.first->children = children.data();
+  }
+}
@@ -0,0 +1,84 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Resource.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+#include <ostream>
+
+
+namespace cb {
+  /**
+   * A Resource tree loaded from a bundle file or memory block.  Bundles carry
+   * precomputed content types, ETags and gzip variants.  File data is
+   * referenced in place, never copied, so a bundle loaded from disk is simply
+   * memory mapped.  Full paths are indexed in a hash table so find() is a
+   * single lookup regardless of depth.
+   *
+   * Bundles are created with write() or the SCons ResourceBundle builder and
+   * may be updated on disk without relinking the program.
+   *
+   * Format, all integers little-endian 32-bit:
+   *
+   *   "CBRB" <version> <file count>
+   *   <path> <content type> <etag> <data> <gzip data>   (per file)
+   *
+   * Each field is a length followed by that many bytes and a NUL.
+   */
+  class ResourceBundle : public DirectoryResource {
+    struct private_t;
+    SmartPointer<private_t> pri;
+
+  public:
+    static const unsigned VERSION = 1;
+
+    ResourceBundle(const std::string &path);
+    ResourceBundle(const char *data, unsigned length);
+    ~ResourceBundle();
+
+    unsigned getFileCount() const;
+
+    static std::string computeETag(const char *data, unsigned length);
+    static void write(std::ostream &stream, const Resource &root,
+                      bool gzip = true);
+
+    // From Resource
+    const Resource *find(const std::string &path) const override;
+
+  protected:
+    void load(const char *data, unsigned length);
+  };
+}
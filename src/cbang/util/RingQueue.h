@@ -0,0 +1,100 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "NonCopyable.h"
+
+#include <utility>
+
+
+namespace cb {
+  /**
+   * FIFO queue stored in a ring buffer.  The first @param N elements live
+   * inline in the object, larger queues double the ring on the heap.  @param N
+   * must be a power of two.
+   */
+  template <typename T, unsigned N = 4>
+  class RingQueue : public NonCopyable {
+    static_assert(N && !(N & (N - 1)), "N must be a power of two");
+
+    T local[N];
+    T *ring = local;
+    unsigned capacity = N;
+    unsigned head = 0;
+    unsigned count = 0;
+
+  public:
+    RingQueue() {}
+    ~RingQueue() {if (ring != local) delete [] ring;}
+
+    bool empty() const {return !count;}
+    unsigned size() const {return count;}
+
+    T &front() {return ring[head];}
+    const T &front() const {return ring[head];}
+    T &back() {return ring[(head + count - 1) & (capacity - 1)];}
+    const T &back() const {return ring[(head + count - 1) & (capacity - 1)];}
+
+
+    void push(const T &value) {
+      if (count == capacity) grow();
+      ring[(head + count++) & (capacity - 1)] = value;
+    }
+
+
+    void pop() {
+      ring[head] = T(); // Release the element now
+      head = (head + 1) & (capacity - 1);
+      count--;
+    }
+
+
+    void clear() {while (!empty()) pop();}
+
+  protected:
+    void grow() {
+      T *newRing = new T[capacity * 2];
+
+      for (unsigned i = 0; i < count; i++) {
+        T &value = ring[(head + i) & (capacity - 1)];
+        newRing[i] = std::move(value);
+        value = T();
+      }
+
+      if (ring != local) delete [] ring;
+      ring = newRing;
+      capacity *= 2;
+      head = 0;
+    }
+  };
+}
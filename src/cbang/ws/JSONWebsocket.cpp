@@ -35,6 +35,7 @@
 #include <cbang/Catch.h>
 #include <cbang/log/Logger.h>
 #include <cbang/io/VectorStream.h>
+#include <cbang/json/Codec.h>
 
 
 using namespace cb;
@@ -45,15 +46,27 @@ using namespace std;
 #define CBANG_LOG_PREFIX "WS" << getID() << ':'
 
 
+JSON::Encoding JSONWebsocket::getEncoding() const {
+  JSON::Encoding encoding = JSON::Encoding::ENCODING_JSON;
+  JSON::Codec::parseProtocol(getProtocol(), encoding);
+  return encoding;
+}
+
+
 void JSONWebsocket::send(function<void (JSON::Sink &sink)> cb) {
+  JSON::Encoding encoding = getEncoding();
   VectorStream<> stream(msgBuf);
-  JSON::Writer writer(stream, 0, true);
+  auto writer = JSON::Codec::createWriter(encoding, stream);
 
-  cb(writer);
+  cb(*writer);
 
-  writer.close();
+  writer->close();
   stream.flush();
-  Websocket::send(msgBuf.data(), msgBuf.size());
+
+  if (encoding == JSON::Encoding::ENCODING_JSON)
+    Websocket::send(msgBuf.data(), msgBuf.size());
+  else sendBinary(msgBuf.data(), msgBuf.size());
+
   msgBuf.clear();
 }
 
@@ -64,8 +77,14 @@ void JSONWebsocket::send(const JSON::Value &value) {
 }
 
 
+bool JSONWebsocket::acceptProtocol(const string &protocol) {
+  JSON::Encoding encoding;
+  return JSON::Codec::parseProtocol(protocol, encoding);
+}
+
+
 void JSONWebsocket::onMessage(const char *data, uint64_t length) {
-  auto value = JSON::Reader::parse(InputSource(data, length));
+  auto value = JSON::Codec::parse(getEncoding(), InputSource(data, length));
   LOG_DEBUG(6, "Received: " << *value);
   onMessage(value);
 }
@@ -48,12 +48,16 @@ namespace cb {
     public:
       using Websocket::Websocket;
 
+      /// @return the encoding selected by the negotiated subprotocol
+      JSON::Encoding getEncoding() const;
+
       void send(std::function<void (JSON::Sink &sink)> cb);
       virtual void send(const JSON::Value &msg);
 
       virtual void onMessage(const JSON::ValuePtr &msg) = 0;
 
       // From Websocket
+      bool acceptProtocol(const std::string &protocol) override;
       void onMessage(const char *data, uint64_t length) override;
 
     protected:
@@ -68,6 +68,7 @@ SmartPointer<HTTP::Conn> Websocket::connect(
     auto error = req.getConnectionError();
 
     if (error == CONN_ERR_OK && code == HTTP_SWITCHING_PROTOCOLS) {
+      protocol = req.getInputHeaders().find("Sec-WebSocket-Protocol");
       LOG_DEBUG(4, "Opened new Websocket: " << getID());
       start();
 
@@ -89,6 +90,9 @@ SmartPointer<HTTP::Conn> Websocket::connect(
   req->outSet("Upgrade",               "websocket");
   req->outSet("Connection",            "upgrade");
 
+  if (!protocols.empty())
+    req->outSet("Sec-WebSocket-Protocol", String::join(protocols, ", "));
+
   auto con   = client.send(req);
   connection = con;
   return con; // Return the strong ref
@@ -96,21 +100,18 @@ SmartPointer<HTTP::Conn> Websocket::connect(
 
 
 void Websocket::send(const char *data, unsigned length) {
-  const unsigned frameSize = 0xffff;
-
-  for (unsigned i = 0; length; i += frameSize) {
-    unsigned bytes = frameSize < length ? frameSize : length;
-    length -= bytes;
-    writeFrame(i ? WS_OP_CONTINUE : WS_OP_TEXT, !length, data + i, bytes);
-  }
-
-  msgSent++;
+  sendMessage(WS_OP_TEXT, data, length);
 }
 
 
 void Websocket::send(const string &s) {send(s.data(), s.length());}
 
 
+void Websocket::sendBinary(const char *data, unsigned length) {
+  sendMessage(WS_OP_BINARY, data, length);
+}
+
+
 void Websocket::close(Status status, const string &msg) {
   LOG_DEBUG(4, CBANG_FUNC << '(' << status << ", " << msg << ')');
 
@@ -160,11 +161,22 @@ void Websocket::upgrade(HTTP::Request &req) {
     HTTP_NOT_IMPLEMENTED);
 #endif
 
+  // Select the first offered subprotocol we accept
+  vector<string> offered;
+  String::tokenize(req.inFind("Sec-WebSocket-Protocol"), offered, ", ");
+
+  for (auto &p: offered)
+    if (acceptProtocol(p)) {
+      protocol = p;
+      break;
+    }
+
   // Respond
   req.setVersion(Version(1, 1));
   req.outSet("Upgrade", "websocket");
   req.outSet("Connection", "upgrade");
   req.outSet("Sec-WebSocket-Accept", key);
+  if (!protocol.empty()) req.outSet("Sec-WebSocket-Protocol", protocol);
   req.reply(HTTP_SWITCHING_PROTOCOLS);
 
   connection = req.getConnection();
@@ -319,6 +331,20 @@ void Websocket::onPong(const string &payload) {
 }
 
 
+void Websocket::sendMessage(OpCode opcode, const char *data,
+                            unsigned length) {
+  const unsigned frameSize = 0xffff;
+
+  for (unsigned i = 0; length; i += frameSize) {
+    unsigned bytes = frameSize < length ? frameSize : length;
+    length -= bytes;
+    writeFrame(i ? (OpCode)WS_OP_CONTINUE : opcode, !length, data + i, bytes);
+  }
+
+  msgSent++;
+}
+
+
 void Websocket::writeFrame(
   OpCode opcode, bool finish, const void *data, uint64_t len) {
   LOG_DEBUG(4, CBANG_FUNC << '(' << opcode << ", " << finish << ", " << len
@@ -378,7 +404,7 @@ void Websocket::writeFrame(
     if (!success || opcode == WS_OP_CLOSE) shutdown();
   };
 
-  getConnection()->write(WeakCall(this, cb), out);
+  getConnection()->queueWrite(WeakCall(this, cb), out);
 }
 
 
@@ -62,6 +62,9 @@ namespace cb {
       bool wsFinish = false;
       std::vector<char> wsMsg;
 
+      std::vector<std::string> protocols;
+      std::string protocol;
+
       std::string pongPayload;
       SmartPointer<Event::Event> pingEvent;
       SmartPointer<Event::Event> pongEvent;
@@ -80,6 +83,14 @@ namespace cb {
       const SmartPointer<HTTP::Conn>::Weak &getConnection() const
       {return connection;}
 
+      /// Subprotocols offered by connect(), in order of preference
+      const std::vector<std::string> &getProtocols() const {return protocols;}
+      void setProtocols(const std::vector<std::string> &protocols)
+      {this->protocols = protocols;}
+
+      /// @return the negotiated subprotocol or an empty string
+      const std::string &getProtocol() const {return protocol;}
+
       unsigned getMaxMessageSize() const {return maxMessageSize;}
       void setMaxMessageSize(unsigned size) {maxMessageSize = size;}
 
@@ -91,6 +102,7 @@ namespace cb {
       void send(const char *data, unsigned length);
       void send(const std::string &s);
       void send(const char *s) {send(std::string(s));}
+      void sendBinary(const char *data, unsigned length);
 
       void close(Status status, const std::string &msg);
       void ping(const std::string &payload = "");
@@ -101,6 +113,8 @@ namespace cb {
       void readBody();
 
       // Callbacks
+      /// Called by upgrade() for each subprotocol the client offers
+      virtual bool acceptProtocol(const std::string &protocol) {return false;}
       virtual void onOpen() {}
       virtual void onMessage(const char *data, uint64_t length) = 0;
       virtual void onClose(Status status, const std::string &msg) {}
@@ -109,6 +123,7 @@ namespace cb {
       virtual void onPong(const std::string &payload);
 
     protected:
+      void sendMessage(OpCode opcode, const char *data, unsigned length);
       void writeFrame(
         OpCode opcode, bool finish, const void *data, uint64_t len);
       void pong();
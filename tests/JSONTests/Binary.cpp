@@ -0,0 +1,120 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+
+#include <cbang/json/Value.h>
+#include <cbang/json/Reader.h>
+#include <cbang/json/Codec.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  string hexDecode(const string &s) {
+    string data;
+    for (unsigned i = 0; i + 1 < s.length(); i += 2)
+      data.push_back((char)String::parseU8("0x" + s.substr(i, 2)));
+    return data;
+  }
+
+
+  void printTypes(const Value &value) {
+    switch (value.getType()) {
+    case ValueType::JSON_NUMBER: cout << (value.isInteger() ? 'i' : 'd'); break;
+    case ValueType::JSON_LIST:
+    case ValueType::JSON_DICT:
+      cout << (value.isList() ? '[' : '{');
+      for (auto v: value) printTypes(*v);
+      cout << (value.isList() ? ']' : '}');
+      break;
+    default: cout << value.getType().toString()[0]; break;
+    }
+  }
+}
+
+
+// Usage: Binary <cbor|msgpack> [hex]
+// Without hex, encodes JSON from stdin then decodes the result.
+//
+// Usage: Binary negotiate
+// Prints the encoding chosen for each Accept header line on stdin.
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    if (argc < 2) THROW("Missing encoding");
+
+    if (string(argv[1]) == "negotiate") {
+      string line;
+      while (getline(cin, line))
+        cout << "'" << line << "' -> " << Codec::negotiate(line) << '\n';
+      return 0;
+    }
+
+    Encoding encoding = Encoding::parse(String::toUpper(argv[1]));
+
+    string data;
+    if (argc == 3) data = hexDecode(argv[2]);
+    else {
+      ValuePtr input = Reader(cin).parse();
+
+      ostringstream str;
+      auto writer = Codec::createWriter(encoding, str);
+      input->write(*writer);
+      writer->close();
+      data = str.str();
+
+      cout << data.length() << " bytes: " << String::hexEncode(data) << '\n';
+    }
+
+    ValuePtr output = Codec::parse(encoding, InputSource(data));
+    cout << output->toString(0, true) << '\n';
+    printTypes(*output);
+    cout << '\n';
+
+    return 0;
+
+  } CBANG_CATCH_ERROR;
+  return 1;
+}
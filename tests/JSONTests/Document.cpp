@@ -0,0 +1,93 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+
+#include <cbang/json/Document.h>
+#include <cbang/json/Reader.h>
+#include <cbang/log/Logger.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+// Usage: Document [path]...
+// Indexes JSON from stdin then prints the value at each path.
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    Document doc(cin);
+    auto root = doc.getRoot();
+
+    cout << "tape: " << doc.getTape().size() << '\n';
+
+    if (root.isDict())
+      for (auto it = root.begin(); it != root.end(); ++it)
+        cout << "key: " << it.key() << " " << (*it).getType() << '\n';
+
+    for (int i = 1; i < argc; i++) {
+      cout << argv[i] << ": ";
+
+      try {
+        auto node = root.select(argv[i]);
+        cout << node.getType() << ' ' << node.getRaw();
+
+        if (node.isString()) cout << " '" << node.getString() << "'";
+        if (node.isNumber()) cout << ' ' << node.getNumber();
+        if (node.isBoolean()) cout << ' ' << node.getBoolean();
+        if (node.isList() || node.isDict()) cout << " size=" << node.size();
+
+        cout << " -> " << node.toValue()->toString(0, true);
+
+      } catch (const Exception &e) {cout << e.getMessage();}
+
+      cout << '\n';
+    }
+
+    // Materializing the root must match a full parse
+    auto value = doc.toValue();
+    auto expect = Reader::parse(InputSource(doc.getText()));
+    cout << "match: " << (*value == *expect) << '\n';
+
+    return 0;
+
+  } CBANG_CATCH_ERROR;
+  return 1;
+}
@@ -34,6 +34,8 @@
 
 #include <cbang/json/Value.h>
 #include <cbang/json/Reader.h>
+#include <cbang/json/Builder.h>
+#include <cbang/json/InternFactory.h>
 #include <cbang/json/YAMLReader.h>
 
 #include <iostream>
@@ -56,6 +58,12 @@ int main(int argc, char *argv[]) {
         cout << *docs[i];
       }
 
+    } else if (argc == 2 && string(argv[1]) == "--intern") {
+      Builder builder(0, &InternFactory::instance());
+      Reader(cin).parse(builder);
+      data = builder.getRoot();
+      if (!data.isNull()) cout << *data;
+
     } else {
       Reader reader(cin);
       data = reader.parse();
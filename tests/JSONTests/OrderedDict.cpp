@@ -0,0 +1,150 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+
+#include <cbang/json/Value.h>
+#include <cbang/http/Headers.h>
+#include <cbang/util/OrderedDict.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace cb;
+
+
+typedef OrderedDict<string, int> dict_t;
+
+
+void print(const dict_t &d) {
+  cout << d.size() << ':';
+  for (auto e: d) cout << ' ' << e.key() << '=' << e.value();
+  cout << endl;
+}
+
+
+void order(unsigned n) {
+  // JSON::Dict keeps insertion order
+  auto json = JSON::Factory().createDict();
+  for (unsigned i = 0; i < n; i++)
+    json->insert(String((n - i) * 7 % 100), i);
+  json->insert(String(7), "replaced");
+  cout << *json << endl;
+
+  dict_t d;
+  for (unsigned i = 0; i < n; i++) d[String(i * 13 % 100)] = i;
+  print(d);
+
+  // Iterate backwards
+  cout << "reverse:";
+  for (auto it = d.find(String((n - 1) * 13 % 100)); it != d.end(); it--)
+    cout << ' ' << it.key();
+  cout << endl;
+}
+
+
+void prepend(unsigned n) {
+  dict_t d;
+  for (unsigned i = 0; i < n; i++) d.insert(String(i), i, i & 1);
+
+  // A reference and an iterator held across inserts and prepends
+  int &ref = d["0"];
+  auto it = d.find("1");
+  for (unsigned i = n; i < 4 * n; i++) d.insert(String(i), i, i & 1);
+  ref = -1;
+  cout << "iterator: " << it.key() << '=' << it.value() << endl;
+
+  for (unsigned i = n; i < 4 * n; i++) d.erase(String(i));
+  print(d);
+}
+
+
+void erase(unsigned n) {
+  dict_t d;
+  for (unsigned i = 0; i < n; i++) d[String(i)] = i;
+
+  // Erase while iterating, values held by other iterators stay put
+  auto last = d.find(String((n - 1) / 3 * 3));
+  for (auto it = d.begin(); it != d.end();)
+    if (it.value() % 3) it = d.erase(it);
+    else it++;
+
+  cout << "last: " << last.key() << '=' << last.value() << endl;
+  cout << "missing: " << (d.find("1") == d.end()) << endl;
+  d.erase("0");
+  d.erase("1");
+  print(d);
+
+  // Reinsert erased keys
+  for (unsigned i = 0; i < n; i++) d.insert(String(i), i);
+  print(d);
+}
+
+
+void headers() {
+  HTTP::Headers hdrs;
+
+  hdrs.set("Content-Type", "text/plain");
+  hdrs.set("X-Custom", "1");
+  for (unsigned i = 0; i < 20; i++) hdrs.set("X-Extra-" + String(i), "x");
+  hdrs.set("content-type", "application/json");
+  hdrs.insert("HOST", "example.com", true);
+
+  for (unsigned i = 0; i < 20; i++) hdrs.remove("x-extra-" + String(i));
+
+  cout << "find: " << hdrs.find("CONTENT-TYPE") << endl;
+  cout << "has: " << hdrs.has("x-custom") << ' ' << hdrs.has("X-Missing")
+       << endl;
+
+  hdrs.remove("X-CUSTOM");
+  cout << "removed: " << hdrs.has("X-Custom") << endl;
+  cout << hdrs;
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    string cmd = 1 < argc ? argv[1] : "";
+    unsigned n = 2 < argc ? String::parseU32(argv[2]) : 5;
+
+    if (cmd == "order") order(n);
+    else if (cmd == "prepend") prepend(n);
+    else if (cmd == "erase") erase(n);
+    else if (cmd == "headers") headers();
+    else THROW("Unknown command '" << cmd << "'");
+
+    return 0;
+
+  } CBANG_CATCH_ERROR;
+  return 1;
+}
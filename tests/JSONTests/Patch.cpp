@@ -0,0 +1,146 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+#include <cbang/json/Value.h>
+#include <cbang/json/Reader.h>
+#include <cbang/json/Observable.h>
+#include <cbang/json/Patch.h>
+#include <cbang/json/Path.h>
+#include <cbang/log/Logger.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+class Coalesced : public CoalescedObservable<Dict> {
+public:
+  ValuePtr replica = new Dict;
+
+  // From CoalescedObservable
+  void notifyPatch(const ValuePtr &patch) override {
+    cout << "PATCH: " << patch->toString(0, true) << endl;
+    replica = Patch::apply(replica, *patch);
+  }
+};
+
+
+void clearAll(Value &value) {
+  if (!value.isList() && !value.isDict()) return;
+  for (auto &child: value) clearAll(*child);
+  value.clear();
+}
+
+
+// Usage:
+//   Patch diff             Reads [from, to], prints both patch forms
+//   Patch apply            Reads [target, patch], prints the result
+//   Patch merge            Reads [target, merge patch], prints the result
+//   Patch atomic           Like apply, also checks target and patch are intact
+//   Patch coalesce [path value | flush]...
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    string cmd = 1 < argc ? argv[1] : "";
+
+    if (cmd == "coalesce") {
+      Coalesced c;
+
+      for (int i = 2; i < argc; i++) {
+        if (string(argv[i]) == "flush") c.flush();
+        else if (i + 1 < argc) {
+          string value = argv[++i];
+          Path(argv[i - 1]).modify(c, value.empty() ? 0 : Reader::parse(value));
+        }
+      }
+
+      c.flush();
+      cout << "FINAL: " << c.toString(0, true) << endl;
+      cout << "match: " << (*c.replica == c) << endl;
+      return 0;
+    }
+
+    auto input = Reader::parse(cin);
+    auto a = input->get(0);
+    auto b = input->get(1);
+
+    if (cmd == "diff") {
+      auto patch = Patch::diff(*a, *b);
+      cout << "PATCH: " << patch->toString(0, true) << endl;
+      auto result = Patch::apply(Patch::clone(*a), *patch);
+      cout << "match: " << (*result == *b) << endl;
+
+      auto merge = Patch::mergeDiff(*a, *b);
+      cout << "MERGE: " << merge->toString(0, true) << endl;
+      result = Patch::mergeApply(Patch::clone(*a), merge);
+      cout << "match: " << (*result == *b) << endl;
+
+    } else if (cmd == "apply")
+      cout << Patch::apply(a, *b)->toString(0, true) << endl;
+
+    else if (cmd == "atomic") {
+      string target = a->toString(0, true);
+      string patch = b->toString(0, true);
+
+      try {
+        auto result = Patch::apply(a, *b);
+        cout << result->toString(0, true) << endl;
+        clearAll(*result); // Must not change the patch
+
+      } catch (const Exception &e) {
+        cout << "error: " << e.getMessage() << endl;
+      }
+
+      cout << "target: " << (a->toString(0, true) == target ? "intact" :
+                             "modified") << endl;
+      cout << "patch: " << (b->toString(0, true) == patch ? "intact" :
+                            "modified") << endl;
+
+    } else if (cmd == "merge")
+      cout << Patch::mergeApply(a, b)->toString(0, true) << endl;
+
+    else THROW("Unknown command '" << cmd << "'");
+
+    return 0;
+
+  } CBANG_CATCH_ERROR;
+
+  return 1;
+}
@@ -31,15 +31,19 @@
 \******************************************************************************/
 
 // Offline driver for the API handler chain.  Builds an API from a config
-// file, dispatches one synthetic request, and prints the captured response —
+// file, dispatches synthetic requests, and prints the captured responses —
 // no network.  An event loop is pumped so async statements (exec, query)
 // complete; synchronous handlers reply in-line.
 //
-//   apiDispatch <config> <METHOD> <path> [-stdin] [Name: value ...]
+//   apiDispatch <config> [-concurrent] [-stats]
+//     <METHOD> <path> [-stdin] [Name: value ...] [-- <METHOD> <path> ...]
 //
-// With -stdin the request body is read from stdin.  The http-root, favicon
-// and scripts options default to "<config-dir>/...".  Output is the status
-// code, the response headers, then the body.
+// Requests separated by ``--`` run in order, each to completion, or with
+// -concurrent are all dispatched before the loop is pumped.  With -stdin the
+// request body is read from stdin.  The http-root, favicon and scripts
+// options default to "<config-dir>/...".  Output per request is the status
+// code, the response headers, then the body.  -stats then prints the
+// response cache counters.
 
 #include <cbang/Catch.h>
 #include <cbang/Exception.h>
@@ -55,20 +59,65 @@
 #include <cbang/event/Base.h>
 #include <cbang/event/SubprocessPool.h>
 #include <cbang/log/Logger.h>
+#include <cbang/json/Writer.h>
 
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <vector>
 
 using namespace cb;
 using namespace std;
 
 
+namespace {
+  SmartPointer<HTTP::Request> parseRequest(const vector<string> &args) {
+    HTTP::RequestParams params;
+    params.method = HTTP::Method::parse(args.at(0), HTTP::Method::HTTP_GET);
+    params.uri    = URI(args.at(1));
+
+    // Remaining args are request headers in "Name: value" form.
+    bool readBody = false;
+    params.hdrs = new HTTP::Headers;
+    for (unsigned i = 2; i < args.size(); i++) {
+      const string &h = args[i];
+      if (h == "-stdin") {readBody = true; continue;}
+      auto colon = h.find(':');
+      if (colon == string::npos) THROW("Expected 'Name: value': " << h);
+      params.hdrs->insert(
+        String::trim(h.substr(0, colon)), String::trim(h.substr(colon + 1)));
+    }
+
+    auto req = SmartPtr(new HTTP::Request(params));
+
+    if (readBody) {
+      string body = SystemUtilities::read(cin);
+      if (!body.empty()) req->getInputBuffer().add(body);
+    }
+
+    return req;
+  }
+
+
+  void printResponse(HTTP::Request &req) {
+    cout << (unsigned)req.getResponseCode() << "\n";
+
+    ostringstream hs;
+    req.getOutputHeaders().write(hs);
+    string headers = hs.str();
+    headers.erase(remove(headers.begin(), headers.end(), '\r'), headers.end());
+    cout << headers;
+
+    cout << req.getOutput();
+  }
+}
+
+
 int main(int argc, char *argv[]) {
   try {
     if (argc < 4) {
-      cerr << "Usage: " << argv[0]
-           << " <config> <METHOD> <path> [Name: value ...]" << endl;
+      cerr << "Usage: " << argv[0] << " <config> [-concurrent] [-stats] "
+           << "<METHOD> <path> [Name: value ...] [-- ...]" << endl;
       return 1;
     }
 
@@ -79,8 +128,20 @@ int main(int argc, char *argv[]) {
     Exception::printLocations = false;
 
     string configPath = argv[1];
-    string method     = argv[2];
-    string path       = argv[3];
+
+    // Flags, then requests separated by "--"
+    bool concurrent = false;
+    bool stats      = false;
+    int i = 2;
+    for (; i < argc; i++)
+      if (string(argv[i]) == "-concurrent") concurrent = true;
+      else if (string(argv[i]) == "-stats") stats = true;
+      else break;
+
+    vector<vector<string>> requests(1);
+    for (; i < argc; i++)
+      if (string(argv[i]) == "--") requests.push_back(vector<string>());
+      else requests.back().push_back(argv[i]);
 
     auto slash = configPath.find_last_of('/');
     string base = slash == string::npos ? "." : configPath.substr(0, slash);
@@ -96,45 +157,37 @@ int main(int argc, char *argv[]) {
     api.setProcPool(new Event::SubprocessPool(eventBase));
     api.load(JSON::YAMLReader::parseFile(configPath));
 
-    HTTP::RequestParams params;
-    params.method = HTTP::Method::parse(method, HTTP::Method::HTTP_GET);
-    params.uri    = URI(path);
-
-    // Remaining args are request headers in "Name: value" form.
-    bool readBody = false;
-    params.hdrs = new HTTP::Headers;
-    for (int i = 4; i < argc; i++) {
-      string h = argv[i];
-      if (h == "-stdin") {readBody = true; continue;}
-      auto colon = h.find(':');
-      if (colon == string::npos) THROW("Expected 'Name: value': " << h);
-      params.hdrs->insert(
-        String::trim(h.substr(0, colon)), String::trim(h.substr(colon + 1)));
-    }
-
-    HTTP::Request req(params);
-
-    if (readBody) {
-      string body = SystemUtilities::read(cin);
-      if (!body.empty()) req.getInputBuffer().add(body);
-    }
-
     // Dispatch as the server does, so handler throws reply with a status
     HTTP::RequestErrorHandler errorHandler(api);
-    errorHandler(req);
-
-    // Drive the event loop until an async chain (exec, query) replies
-    while (!req.isReplying()) eventBase.loopOnce();
+    vector<SmartPointer<HTTP::Request>> reqs;
+
+    auto pump = [&] (unsigned count) {
+      // Drive the event loop until async chains (exec, query) reply
+      for (unsigned j = 0; j < count; j++)
+        while (!reqs[j]->isReplying()) eventBase.loopOnce();
+    };
+
+    for (auto &args: requests) {
+      if (args.size() < 2) THROW("Expected <METHOD> <path>");
+      reqs.push_back(parseRequest(args));
+      errorHandler(*reqs.back());
+      if (!concurrent) pump(reqs.size());
+    }
 
-    cout << (unsigned)req.getResponseCode() << "\n";
+    pump(reqs.size());
 
-    ostringstream hs;
-    req.getOutputHeaders().write(hs);
-    string headers = hs.str();
-    headers.erase(remove(headers.begin(), headers.end(), '\r'), headers.end());
-    cout << headers;
+    for (unsigned j = 0; j < reqs.size(); j++) {
+      if (j) cout << "\n--\n";
+      printResponse(*reqs[j]);
+    }
 
-    cout << req.getOutput();
+    if (stats) {
+      cout << "\n--\n";
+      JSON::Writer writer(cout, 0, false);
+      api.getResponseCache().writeStats(writer);
+      writer.close();
+      cout << "\n";
+    }
 
     return 0;
   } CATCH_ERROR;
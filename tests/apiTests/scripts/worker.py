@@ -0,0 +1,18 @@
+#!/usr/bin/env python3
+# Persistent exec worker: one JSON request per line in, one JSON result per
+# line out.  Counts the requests this process served, so tests can see
+# workers being reused and recycled.  Exits on a request for 'crash', never
+# answers 'hang' and answers 'long' with an overlong line.
+import json, sys
+
+served = 0
+for line in sys.stdin:
+    req = json.loads(line)
+    served += 1
+    name = req['input']['args']['name']
+    if name == 'crash': sys.exit(1)
+    if name == 'hang': continue
+    if name == 'long': name *= 1000
+
+    result = {'name': name, 'served': served}
+    print(json.dumps({'id': req['id'], 'response': result}), flush = True)
@@ -0,0 +1,85 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/event/Buffer.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/Catch.h>
+
+#include <iostream>
+#include <sstream>
+
+using namespace cb;
+using namespace std;
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    if (argc != 3) {
+      cerr << "Usage: " << argv[0] << " <segment size> <pattern>" << endl;
+      return 1;
+    }
+
+    unsigned size = String::parseU32(argv[1]);
+    string pattern = String::unescapeC(argv[2]);
+
+    ostringstream str;
+    str << cin.rdbuf();
+    string input = str.str();
+
+    // Reference each segment so the buffer is split into separate chains
+    Event::Buffer buf;
+    for (unsigned i = 0; i < input.length(); i += size)
+      buf.addRef(input.data() + i, min(size, (unsigned)input.length() - i));
+
+    for (unsigned start = 0; start <= input.length(); start++) {
+      int index = buf.indexOf(pattern, start);
+      auto expect = input.find(pattern, start);
+      int expected = expect == string::npos ? -1 : (int)expect;
+
+      cout << start << ": " << index;
+      if (index != expected) cout << " expected " << expected;
+      cout << '\n';
+    }
+
+    return 0;
+
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,170 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/geom/BVH.h>
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  uint32_t seed = 1;
+
+  double rand(double max) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % 1000000 / 1000000.0 * max;
+  }
+
+
+  vector<Segment2D> makeSegments(unsigned count) {
+    vector<Segment2D> segs;
+
+    for (unsigned i = 0; i < count; i++) {
+      Vector2D p(rand(1000), rand(1000));
+      segs.push_back(Segment2D(p, p + Vector2D(rand(20) - 10, rand(20) - 10)));
+    }
+
+    return segs;
+  }
+
+
+  void print(const string &name, vector<unsigned> found,
+             const vector<unsigned> &expected) {
+    sort(found.begin(), found.end());
+    cout << name << ": " << found.size() << "/" << expected.size() << " found, "
+         << (found == expected ? "match" : "MISMATCH") << endl;
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    if (argc != 3) {
+      cout << "Usage: " << argv[0] << " <count> <threads>" << endl;
+      return 1;
+    }
+
+    unsigned count = String::parseU32(argv[1]);
+    unsigned threads = String::parseU32(argv[2]);
+
+    vector<Segment2D> segs = makeSegments(count);
+    BVH2D bvh(segs, 4, threads);
+
+    cout << "items: " << bvh.size() << endl;
+
+    // Box queries
+    for (unsigned i = 0; i < 4; i++) {
+      Vector2D p(rand(1000), rand(1000));
+      Rectangle2D box(p, p + Vector2D(rand(100), rand(100)));
+
+      vector<unsigned> expected;
+      for (unsigned j = 0; j < segs.size(); j++)
+        if (box.intersects(Rectangle2D(segs[j].getStart(), segs[j].getEnd())))
+          expected.push_back(j);
+
+      print("box " + String(i), bvh.query(box), expected);
+    }
+
+    // Segment queries
+    for (unsigned i = 0; i < 4; i++) {
+      Segment2D seg(Vector2D(rand(1000), rand(1000)),
+                    Vector2D(rand(1000), rand(1000)));
+
+      vector<unsigned> expected;
+      for (unsigned j = 0; j < segs.size(); j++)
+        if (BVH2D::intersects(
+              Rectangle2D(segs[j].getStart(), segs[j].getEnd()), seg))
+          expected.push_back(j);
+
+      print("segment " + String(i), bvh.query(seg), expected);
+    }
+
+    // Nearest queries
+    for (unsigned i = 0; i < 4; i++) {
+      Vector2D p(rand(1000), rand(1000));
+      auto found = bvh.nearest(p, 5, segs);
+
+      vector<pair<double, unsigned> > all;
+      for (unsigned j = 0; j < segs.size(); j++)
+        all.push_back(make_pair(segs[j].distance(p), j));
+      sort(all.begin(), all.end());
+      all.resize(min((size_t)5, all.size()));
+
+      cout << "nearest " << i << ": " << found.size() << " found, "
+           << (found == all ? "match" : "MISMATCH") << endl;
+    }
+
+    // Ray queries, unbounded and limited to a max distance
+    for (unsigned i = 0; i < 8; i++) {
+      Vector2D origin(rand(1000), rand(1000));
+      Vector2D dir(rand(2) - 1, rand(2) - 1);
+      if (i == 6) dir = Vector2D(1, 0); // Axis aligned, zero y component
+      if (i == 7) dir = Vector2D(0, -1);
+      double maxDist = i & 1 ? 100 : numeric_limits<double>::max();
+
+      vector<unsigned> expected;
+      for (unsigned j = 0; j < segs.size(); j++)
+        if (BVH2D::intersects(Rectangle2D(segs[j].getStart(), segs[j].getEnd()),
+                              origin, dir, 0, maxDist))
+          expected.push_back(j);
+
+      vector<unsigned> found;
+      bvh.query(origin, dir, [&found] (unsigned j) {found.push_back(j);},
+                maxDist);
+
+      print("ray " + String(i), found, expected);
+    }
+
+    // Ray against a known box
+    Rectangle2D unit(Vector2D(0, 0), Vector2D(1, 1));
+    cout << "ray hit: "
+         << BVH2D::intersects(unit, Vector2D(-1, 0.5), Vector2D(1, 0), 0, 10)
+         << " miss behind: "
+         << BVH2D::intersects(unit, Vector2D(2, 0.5), Vector2D(1, 0), 0, 10)
+         << " miss short: "
+         << BVH2D::intersects(unit, Vector2D(-1, 0.5), Vector2D(1, 0), 0, 0.5)
+         << " miss parallel: "
+         << BVH2D::intersects(unit, Vector2D(-1, 2), Vector2D(1, 0), 0, 10)
+         << endl;
+
+    return 0;
+
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -58,10 +58,9 @@ namespace {
   };
 
 
-  // A connection.  Opaque to cbang; the statement handle is the same pointer
-  // (cbang never dereferences either), so one object backs both.
+  // A connection.  Opaque to cbang.  Results are tracked per connection
+  // because only one statement per connection runs at a time.
   struct Conn {
-    string   pendingSQL;
     Response cur;
     bool     haveCur = false;
     size_t   setIdx  = 0;
@@ -75,10 +74,22 @@ namespace {
   };
 
 
+  // A statement handle, distinct per mysql_stmt_init() so a statement cache
+  // can hold several per connection.
+  struct Stmt {
+    Conn *conn;
+    string sql;
+    vector<string> binds;
+    Stmt(Conn *conn) : conn(conn) {}
+  };
+
+
   deque<Response> g_pending;   // queued query outcomes, FIFO
   vector<string>  g_queries;   // captured SQL, in order
   vector<vector<string>> g_binds; // captured bound params, per query
   int             g_fd = -1;   // always-readable fd backing every NB wait
+  bool            g_failConnect = false;
+  Stats           g_stats;
 
   const int PENDING = MYSQL_WAIT_READ;
 
@@ -88,7 +99,8 @@ namespace {
   }
 
   Conn *C(MYSQL *m)      {return reinterpret_cast<Conn *>(m);}
-  Conn *S(MYSQL_STMT *s) {return reinterpret_cast<Conn *>(s);}
+  Stmt *ST(MYSQL_STMT *s) {return reinterpret_cast<Stmt *>(s);}
+  Conn *S(MYSQL_STMT *s)  {return ST(s)->conn;}
   Meta *M(MYSQL_RES *r)  {return reinterpret_cast<Meta *>(r);}
 
   bool hasSet(Conn *c) {return c->haveCur && c->setIdx < c->cur.results.size();}
@@ -137,10 +149,19 @@ namespace {
 
 
 // --- FakeDB controller -----------------------------------------------------
-void FakeDB::reset() {g_pending.clear(); g_queries.clear(); g_binds.clear();}
+void FakeDB::reset() {
+  g_pending.clear();
+  g_queries.clear();
+  g_binds.clear();
+  g_failConnect = false;
+  g_stats = Stats();
+}
+
 void FakeDB::push(const Response &r) {g_pending.push_back(r);}
+void FakeDB::failConnect(bool fail) {g_failConnect = fail;}
 const vector<string> &FakeDB::queries() {return g_queries;}
 const vector<vector<string>> &FakeDB::binds() {return g_binds;}
+const Stats &FakeDB::stats() {return g_stats;}
 
 
 // --- connection / library --------------------------------------------------
@@ -170,7 +191,16 @@ int mysql_real_connect_start(MYSQL **, MYSQL *, const char *, const char *,
   const char *, const char *, unsigned int, const char *, unsigned long) {
   return PENDING;
 }
-int mysql_real_connect_cont(MYSQL **ret, MYSQL *m, int) {*ret = m; return 0;}
+int mysql_real_connect_cont(MYSQL **ret, MYSQL *m, int) {
+  if (g_failConnect) {
+    C(m)->errnoVal = 2003; // CR_CONN_HOST_ERROR
+    C(m)->error    = "Can't connect to MySQL server";
+    *ret = 0;
+
+  } else *ret = m;
+
+  return 0;
+}
 
 int mysql_ping(MYSQL *) {return 0;}
 int mysql_ping_start(int *, MYSQL *) {return PENDING;}
@@ -213,33 +243,42 @@ MYSQL_FIELD *mysql_fetch_fields(MYSQL_RES *r) {return M(r)->fields.data();}
 
 
 // --- prepared statements ---------------------------------------------------
-// The statement handle is the connection pointer; mysql_close frees it, so
-// mysql_stmt_close is a no-op (avoids a double free).
-MYSQL_STMT *mysql_stmt_init(MYSQL *m) {return reinterpret_cast<MYSQL_STMT *>(m);}
-my_bool     mysql_stmt_close(MYSQL_STMT *) {return 0;}
+// Each statement is its own handle.  The query is recorded and its scripted
+// response taken at execute, so a re-executed cached statement gets the next
+// response just like a freshly prepared one.
+MYSQL_STMT *mysql_stmt_init(MYSQL *m) {
+  g_stats.open++;
+  return reinterpret_cast<MYSQL_STMT *>(new Stmt(C(m)));
+}
+
+my_bool mysql_stmt_close(MYSQL_STMT *s) {
+  g_stats.closes++;
+  g_stats.open--;
+  delete ST(s);
+  return 0;
+}
+
+int mysql_stmt_close_start(my_bool *, MYSQL_STMT *) {return PENDING;}
+int mysql_stmt_close_cont(my_bool *ret, MYSQL_STMT *s, int) {
+  *ret = mysql_stmt_close(s);
+  return 0;
+}
+
+int mysql_stmt_reset_start(my_bool *, MYSQL_STMT *) {return PENDING;}
+int mysql_stmt_reset_cont(my_bool *ret, MYSQL_STMT *s, int) {
+  g_stats.resets++;
+  S(s)->haveCur = false;
+  *ret = 0;
+  return 0;
+}
 
 int mysql_stmt_prepare_start(int *, MYSQL_STMT *s, const char *q,
   unsigned long len) {
-  S(s)->pendingSQL.assign(q, len);
+  ST(s)->sql.assign(q, len);
   return PENDING;
 }
 int mysql_stmt_prepare_cont(int *ret, MYSQL_STMT *s, int) {
-  Conn *c = S(s);
-  g_queries.push_back(c->pendingSQL);
-  g_binds.push_back({}); // filled by mysql_stmt_bind_param, if called
-
-  if (g_pending.empty()) c->cur = Response();
-  else {c->cur = g_pending.front(); g_pending.pop_front();}
-
-  c->haveCur = true;
-  c->setIdx  = 0;
-  c->pos     = 0;
-  c->row     = 0;
-  c->rbinds.clear();
-  c->errnoVal = 0;
-  c->error.clear();
-  c->sqlstate = "00000";
-
+  g_stats.prepares++;
   *ret = 0; // a failure (if any) surfaces at execute, as in a stored proc
   return 0;
 }
@@ -248,7 +287,7 @@ unsigned long mysql_stmt_param_count(MYSQL_STMT *s) {
   // Count ``?`` placeholders outside single-quoted literals
   unsigned long n = 0;
   bool quoted = false;
-  for (char c: S(s)->pendingSQL) {
+  for (char c: ST(s)->sql) {
     if (c == '\'') quoted = !quoted;
     else if (c == '?' && !quoted) n++;
   }
@@ -257,8 +296,9 @@ unsigned long mysql_stmt_param_count(MYSQL_STMT *s) {
 
 my_bool mysql_stmt_bind_param(MYSQL_STMT *s, MYSQL_BIND *b) {
   unsigned long n = mysql_stmt_param_count(s);
+  ST(s)->binds.clear();
   for (unsigned long i = 0; i < n; i++)
-    g_binds.back().push_back(
+    ST(s)->binds.push_back(
       b[i].buffer_type == MYSQL_TYPE_NULL ? "\\N" : // mysqldump NULL marker
       string((const char *)b[i].buffer, b[i].buffer_length));
   return 0;
@@ -267,16 +307,37 @@ my_bool mysql_stmt_bind_param(MYSQL_STMT *s, MYSQL_BIND *b) {
 // Execute demands a WRITE wait, as the real client does when a large bound
 // parameter overflows the socket buffer.  An event re-armed with stale READ
 // flags never completes (the bug this guards against spins the driver loop).
-int mysql_stmt_execute_start(int *, MYSQL_STMT *) {return MYSQL_WAIT_WRITE;}
+int mysql_stmt_execute_start(int *, MYSQL_STMT *s) {
+  Stmt *st = ST(s);
+  Conn *c = st->conn;
+  g_queries.push_back(st->sql);
+  g_binds.push_back(st->binds);
+
+  if (g_pending.empty()) c->cur = Response();
+  else {c->cur = g_pending.front(); g_pending.pop_front();}
+
+  c->haveCur = true;
+  c->setIdx  = 0;
+  c->rbinds.clear();
+  c->errnoVal = 0;
+  c->error.clear();
+  c->sqlstate = "00000";
+
+  return MYSQL_WAIT_WRITE;
+}
 int mysql_stmt_execute_cont(int *ret, MYSQL_STMT *s, int ready) {
   if (!(ready & MYSQL_WAIT_WRITE)) return MYSQL_WAIT_WRITE; // still pending
   Conn *c = S(s);
-  if (c->cur.errnoVal) {
+  if (c->cur.errnoVal && c->cur.failRow < 0) {
     c->errnoVal = c->cur.errnoVal;
     c->error    = c->cur.error;
     c->sqlstate = c->cur.sqlstate;
     *ret = 1;
   } else *ret = 0;
+
+  // Rows restart at execute, an unbuffered fetch never calls store_result
+  c->pos = 0;
+  c->row = 0;
   return 0;
 }
 
@@ -325,6 +386,15 @@ int mysql_stmt_fetch_cont(int *ret, MYSQL_STMT *s, int) {
 
   if (!set || c->pos >= set->rows.size()) {c->row = 0; *ret = MYSQL_NO_DATA; return 0;}
 
+  if (!c->setIdx && c->cur.errnoVal && (int)c->pos == c->cur.failRow) {
+    c->errnoVal = c->cur.errnoVal;
+    c->error    = c->cur.error;
+    c->sqlstate = c->cur.sqlstate;
+    c->row = 0;
+    *ret = 1;
+    return 0;
+  }
+
   c->row = &set->rows[c->pos++];
 
   // Fill every bound buffer, as the real client does; a value longer than its
@@ -76,16 +76,28 @@ namespace FakeDB {
   };
 
   // One query's outcome: zero or more result sets (zero = OK / no result set),
-  // or a failure when errnoVal is nonzero.
+  // or a failure when errnoVal is nonzero.  With failRow set, the failure
+  // comes when fetching that row of the first set instead of at execute.
   struct Response {
     std::vector<Result> results;
     unsigned errnoVal = 0;
     std::string error;
     std::string sqlstate = "00000";
+    int failRow = -1;
+  };
+
+  // Statement handle counts, to check the driver's statement cache
+  struct Stats {
+    unsigned prepares = 0;
+    unsigned resets   = 0;
+    unsigned closes   = 0;
+    unsigned open     = 0; // Statements not yet closed
   };
 
   void reset();
   void push(const Response &r);                // queue one query's outcome
-  const std::vector<std::string> &queries();   // SQL sent, in order
+  void failConnect(bool fail);                 // fail new connections
+  const std::vector<std::string> &queries();   // SQL executed, in order
   const std::vector<std::vector<std::string>> &binds(); // params, per query
+  const Stats &stats();
 }
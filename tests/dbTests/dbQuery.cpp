@@ -33,8 +33,10 @@
 // Offline driver for the API query path.  Builds an API with a real
 // MariaDB::Connector/EventDB whose libmariadb calls are satisfied by the
 // linked-in fake (FakeMariaDB.*).  A scenario selects the endpoint and the
-// canned result set(s); the request is dispatched and the captured response
-// plus the SQL actually sent are printed.  No database, no network.
+// canned result set(s); the request, and any follow up GET requests, are
+// dispatched in turn and the captured responses plus the SQL actually sent
+// are printed.  Streaming scenarios write through a fake client connection
+// whose reads may be slowed or stalled.  No database, no network.
 //
 //   dbQuery <fixture.yaml> <scenario>
 
@@ -54,6 +56,7 @@
 #include <cbang/oauth2/Providers.h>
 #include <cbang/net/URI.h>
 #include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
 #include <cbang/event/SubprocessPool.h>
 #include <cbang/log/Logger.h>
 
@@ -84,10 +87,102 @@ namespace {
   void push(const Result &r) {Response resp; resp.results = {r}; FakeDB::push(resp);}
 
 
+  Result bigRows(unsigned count, unsigned size) {
+    Rows rows;
+    for (unsigned i = 0; i < count; i++)
+      rows.push_back({Cell(String(i)), Cell(string(size, 'x'))});
+    return result({{"id", FakeDB::LONG}, {"data", FakeDB::STRING}}, rows);
+  }
+
+
+  // The client end of a streamed reply.  Each write completes @param delay
+  // seconds after it was made, or never when negative, as for a client that
+  // stopped reading.
+  class ClientConn : public HTTP::Conn {
+    double delay;
+    SmartPointer<Event::Event> readEvent;
+    vector<pair<unsigned, function<void (bool)>>> unread;
+
+  public:
+    string wire;
+    unsigned pending    = 0;
+    unsigned maxPending = 0;
+    bool closed         = false;
+
+    ClientConn(Event::Base &base, double delay) :
+      HTTP::Conn(base), delay(delay),
+      readEvent(base.newEvent([this] {read(true);}, 0)) {}
+
+    bool isReading() const {return !unread.empty() && 0 <= delay;}
+
+    void read(bool success) {
+      auto cbs = unread;
+      unread.clear();
+
+      for (auto &p: cbs) {
+        pending -= p.first;
+        if (p.second) p.second(success);
+      }
+    }
+
+    // From HTTP::Conn
+    bool isIncoming() const override {return true;}
+
+    void writeRequest(const SmartPointer<HTTP::Request> &req,
+                      Event::Buffer buffer, bool continueProcessing,
+                      function<void (bool)> cb) override {
+      if (closed) {if (cb) cb(false); return;}
+
+      unsigned length = buffer.getLength();
+      wire += buffer.toString();
+      pending += length;
+      maxPending = max(maxPending, pending);
+      unread.push_back(make_pair(length, cb));
+
+      if (0 <= delay && !readEvent->isPending()) readEvent->add(delay);
+    }
+
+    void close() override {
+      closed = true;
+      readEvent->del();
+      read(false);
+    }
+  };
+
+
+  // Decode a chunked body, reporting the number of chunks and whether the
+  // final empty chunk arrived
+  string unchunk(const string &s, unsigned &chunks, bool &complete) {
+    string body;
+    size_t pos = 0;
+    chunks = 0;
+    complete = false;
+
+    while (true) {
+      size_t eol = s.find("\r\n", pos);
+      if (eol == string::npos) break;
+
+      unsigned size = String::parseU32("0x" + s.substr(pos, eol - pos));
+      if (!size) {complete = true; break;}
+      if (s.length() < eol + 2 + size) break;
+
+      body += s.substr(eol + 2, size);
+      pos = eol + 4 + size;
+      chunks++;
+    }
+
+    return body;
+  }
+
+
   // Map a scenario name to (method, path), an optional request body, and
-  // queue its canned result(s).  Returns false for an unknown scenario.
+  // queue its canned result(s).  Paths in @param more are requested after
+  // the first, one at a time on the same pool, and followed by statement
+  // counts.  A non-negative @param readDelay sends the requests over a
+  // ClientConn.  Returns false for an unknown scenario.
   bool setup(const string &s, string &method, string &path, string &body,
-             string &contentType, string &auth) {
+             string &contentType, string &auth, vector<string> &more,
+             unsigned &stmtCacheSize, double &readDelay) {
     method = "GET";
 
     if (s == "Dict") {
@@ -309,6 +404,111 @@ namespace {
       auth = "testsid";
       push(Response()); // AuthSession: OK, no result set
 
+    } else if (s == "StmtCache") {
+      // Two cached statements per connection.  The repeated /names reuses
+      // its statement after a reset, /u64 evicts /one which must be closed
+      // and prepared again.
+      stmtCacheSize = 2;
+      path = "/names";
+      more = {"/one", "/names", "/u64", "/one"};
+      push(result({{"name", FakeDB::STRING}}, {{Cell("Alice")}}));
+      push(result({{"n", FakeDB::LONG}}, {{Cell("7")}}));
+      push(result({{"name", FakeDB::STRING}}, {{Cell("Bob")}}));
+      push(result({{"id", FakeDB::LONGLONG}}, {{Cell("123")}}));
+      push(result({{"n", FakeDB::LONG}}, {{Cell("8")}}));
+
+    } else if (s == "StmtReprepare") {
+      // A cached statement the server no longer knows is closed and
+      // prepared again, the request still succeeds
+      path = "/one";
+      more = {"/one"};
+      push(result({{"n", FakeDB::LONG}}, {{Cell("7")}}));
+      Response resp;
+      resp.errnoVal = ER_NEED_REPREPARE;
+      resp.error    = "Prepared statement needs to be re-prepared";
+      resp.sqlstate = "HY000";
+      FakeDB::push(resp);
+      push(result({{"n", FakeDB::LONG}}, {{Cell("8")}}));
+
+    } else if (s == "StmtCacheOff") {
+      stmtCacheSize = 0;
+      path = "/one";
+      more = {"/one"};
+      push(result({{"n", FakeDB::LONG}}, {{Cell("7")}}));
+      push(result({{"n", FakeDB::LONG}}, {{Cell("8")}}));
+
+    } else if (s == "ConnectFail") {
+      // The waiter gets no connection rather than a connection still opening
+      path = "/one";
+      FakeDB::failConnect(true);
+
+    } else if (s == "Stream") {
+      path = "/stream";
+      readDelay = 0;
+      push(result({{"id", FakeDB::LONG}, {"name", FakeDB::STRING}},
+                  {{Cell("1"), Cell("Alice")}, {Cell("2"), Cell()}}));
+
+    } else if (s == "StreamEmpty") {
+      path = "/stream";
+      readDelay = 0;
+      push(result({{"id", FakeDB::LONG}, {"name", FakeDB::STRING}}, {}));
+
+    } else if (s == "NDJSON") {
+      path = "/ndjson";
+      readDelay = 0;
+      push(result({{"id", FakeDB::LONG}, {"name", FakeDB::STRING}},
+                  {{Cell("1"), Cell("Alice")}, {Cell("2"), Cell()}}));
+
+    } else if (s == "CSV") {
+      // Commas, quotes and line breaks are quoted, NULL is an empty field
+      path = "/csv";
+      readDelay = 0;
+      push(result({{"id", FakeDB::LONG}, {"note, text", FakeDB::STRING}},
+                  {{Cell("1"), Cell("plain")},
+                   {Cell("2"), Cell("say \"hi\"")},
+                   {Cell("3"), Cell("two\r\nlines")},
+                   {Cell("4"), Cell()},
+                   {Cell("5"), Cell("a,b")}}));
+
+    } else if (s == "StreamErrorFirst") {
+      // Fails before a chunk is sent, so the error replies normally
+      path = "/stream";
+      readDelay = 0;
+      Response resp;
+      resp.results  = {result({{"id", FakeDB::LONG}},
+                              {{Cell("1")}, {Cell("2")}, {Cell("3")}})};
+      resp.errnoVal = ER_SIGNAL_EXCEPTION;
+      resp.error    = "boom";
+      resp.sqlstate = "45000";
+      resp.failRow  = 1;
+      FakeDB::push(resp);
+
+    } else if (s == "StreamErrorMid") {
+      // Fails after the first chunk, the response is left incomplete
+      path = "/ndjson";
+      readDelay = 0;
+      Response resp;
+      resp.results  = {bigRows(4, 40000)};
+      resp.errnoVal = ER_SIGNAL_EXCEPTION;
+      resp.error    = "boom";
+      resp.sqlstate = "45000";
+      resp.failRow  = 3;
+      FakeDB::push(resp);
+
+    } else if (s == "StreamPause") {
+      // A slow client pauses fetching at the high watermark
+      path = "/ndjson";
+      readDelay = 0.25;
+      push(bigRows(300, 10000));
+
+    } else if (s == "StreamStall") {
+      // A client that stops reading is closed, the connection is reused
+      path = "/stream-stall";
+      more = {"/one"};
+      readDelay = -1;
+      push(bigRows(300, 10000));
+      push(result({{"n", FakeDB::LONG}}, {{Cell("7")}}));
+
     } else return false;
 
     return true;
@@ -352,11 +552,17 @@ int main(int argc, char *argv[]) {
     API::API api(options);
 
     string method, path, body, contentType, auth;
+    vector<string> more;
+    unsigned stmtCacheSize = 32;
+    double readDelay = -2; // No client connection
     FakeDB::reset();
-    if (!setup(scenario, method, path, body, contentType, auth))
+    if (!setup(scenario, method, path, body, contentType, auth, more,
+               stmtCacheSize, readDelay))
       THROW("Unknown scenario: " << scenario);
 
-    api.setDBConnector(new MariaDB::Connector(base));
+    auto connector = SmartPtr(new MariaDB::Connector(base));
+    connector->setStmtCacheSize(stmtCacheSize);
+    api.setDBConnector(connector);
     api.setProcPool(new Event::SubprocessPool(base));
 
     // The 'session' handler registers only with these three set
@@ -368,33 +574,86 @@ int main(int argc, char *argv[]) {
 
     api.load(JSON::YAMLReader::parseFile(configPath));
 
-    HTTP::RequestParams params;
-    params.method = HTTP::Method::parse(method, HTTP::Method::HTTP_GET);
-    params.uri    = URI(path);
+    // Dispatch as the server does, so handler throws reply with a status
+    HTTP::RequestErrorHandler errorHandler(api);
 
-    params.hdrs = new HTTP::Headers;
-    if (!contentType.empty()) params.hdrs->insert("Content-Type", contentType);
-    if (!auth.empty())        params.hdrs->insert("Authorization", auth);
+    auto send = [&] (const string &method, const string &path) {
+      HTTP::RequestParams params;
+      params.method = HTTP::Method::parse(method, HTTP::Method::HTTP_GET);
+      params.uri    = URI(path);
 
-    HTTP::Request req(params);
-    if (!body.empty()) req.getInputBuffer().add(body.data(), body.length());
+      params.hdrs = new HTTP::Headers;
+      if (!contentType.empty())
+        params.hdrs->insert("Content-Type", contentType);
+      if (!auth.empty()) params.hdrs->insert("Authorization", auth);
 
-    // Dispatch as the server does, so handler throws reply with a status
-    HTTP::RequestErrorHandler errorHandler(api);
-    errorHandler(req);
+      SmartPointer<ClientConn> conn;
+      if (-1 <= readDelay) {
+        conn = new ClientConn(base, readDelay);
+        params.connection = conn;
+      }
 
-    for (unsigned i = 0; !req.isReplying() && i < 100000; i++) base.loopOnce();
-    if (!req.isReplying()) THROW("Request never replied");
+      auto req = SmartPtr(new HTTP::Request(params));
+      if (!body.empty()) req->getInputBuffer().add(body.data(), body.length());
 
-    cout << (unsigned)req.getResponseCode() << "\n";
+      errorHandler(*req);
 
-    ostringstream hs;
-    req.getOutputHeaders().write(hs);
-    string headers = hs.str();
-    headers.erase(remove(headers.begin(), headers.end(), '\r'), headers.end());
-    cout << headers;
+      for (unsigned i = 0; !req->isReplying() && i < 100000; i++)
+        base.loopOnce();
+      if (!req->isReplying()) THROW("Request never replied");
 
-    cout << req.getOutput();
+      // Let the connection return to the pool before the next request
+      for (unsigned i = 0; (connector->getNumActive() ||
+                            (conn.isSet() && conn->isReading())) &&
+             i < 100000; i++)
+        base.loopOnce();
+
+      cout << (unsigned)req->getResponseCode() << "\n";
+
+      ostringstream hs;
+      req->getOutputHeaders().write(hs);
+      string headers = hs.str();
+      headers.erase(remove(headers.begin(), headers.end(), '\r'),
+                    headers.end());
+      size_t date = headers.find("Date: ");
+      if (date != string::npos) // Not repeatable
+        headers.erase(date, headers.find('\n', date) + 1 - date);
+      cout << headers;
+
+      if (conn.isNull()) {
+        cout << req->getOutput();
+        return;
+      }
+
+      // What the client received
+      string wire = conn->wire.substr(conn->wire.find("\r\n\r\n") + 4);
+      unsigned chunks = 0;
+      bool complete = true;
+      if (req->outHas("Transfer-Encoding"))
+        wire = unchunk(wire, chunks, complete);
+
+      if (wire.length() < 1000) cout << wire;
+      else cout << "BODY: " << wire.length() << " bytes, "
+                << count(wire.begin(), wire.end(), '\n') << " lines";
+
+      cout << "\nCHUNKS: " << chunks
+           << "\nCOMPLETE: " << String(complete)
+           << "\nCLOSED: " << String(conn->closed);
+
+      // Fetching paused until the client read most of the high watermark
+      if (0 < readDelay)
+        cout << "\nPAUSED: " << String(
+          (1 << 20) <= conn->maxPending && conn->maxPending < (5 << 18));
+    };
+
+    send(method, path);
+
+    body.clear();
+    contentType.clear();
+    for (auto &path: more) {
+      cout << "\n";
+      send("GET", path);
+    }
 
     auto &queries = FakeDB::queries();
     auto &binds   = FakeDB::binds();
@@ -407,6 +666,15 @@ int main(int argc, char *argv[]) {
       }
     }
 
+    if (!more.empty()) {
+      auto &stats = FakeDB::stats();
+      cout << "\nCONNECTIONS: " << connector->getNumConnections()
+           << "\nPREPARES: " << stats.prepares
+           << "\nRESETS: " << stats.resets
+           << "\nCLOSES: " << stats.closes
+           << "\nOPEN: " << stats.open;
+    }
+
     return 0;
   } CATCH_ERROR;
 
@@ -0,0 +1,183 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/util/GlobMatcher.h>
+#include <cbang/os/ParallelDirectoryWalker.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/DirectoryWatcher.h>
+#include <cbang/log/Logger.h>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace cb;
+
+
+void usage(const char *name) {
+  cout
+    << "Usage: " << name << " [OPTIONS]\n\n"
+    << "OPTIONS:\n"
+    << "\t--match <pattern> <name>    Print whether name matches pattern.\n"
+    << "\t--depth <n>                 Set max depth for following walks.\n"
+    << "\t--threads <n>               Set thread count for following walks.\n"
+    << "\t--walk <dir> <pattern>      Print sorted matching files.\n"
+    << "\t--walk-dirs <dir> <pattern> Print sorted matching files and dirs.\n"
+    << "\t--stat <dir> <pattern>      Print sorted matching files and sizes.\n"
+    << "\t--watch <dir> <pattern>     Make scripted changes under dir and\n"
+    << "\t                            print the reported events.\n"
+    << endl;
+}
+
+
+void watch(const string &dir, const string &pattern) {
+  Event::Base base(false);
+  vector<string> events;
+
+  Event::DirectoryWatcher watcher(base, dir, [&] (
+    Event::DirectoryWatcher::change_t change, const string &path) {
+    events.push_back(
+      String(Event::DirectoryWatcher::toString(change)) + " " + path);
+  }, pattern);
+
+  auto step = [&] (const string &msg) {
+    // inotify queues events before the causing syscall returns
+    for (unsigned i = 0; i < 3; i++) base.loopNonBlock();
+
+    sort(events.begin(), events.end());
+    cout << msg << ":" << endl;
+    for (auto &e: events) cout << "  " << e << endl;
+    events.clear();
+  };
+
+  step("start");
+
+  SystemUtilities::oopen(dir + "/new.txt")->flush();
+  step("create new.txt");
+
+  *SystemUtilities::oopen(dir + "/new.txt") << "data" << endl;
+  step("write new.txt");
+
+  SystemUtilities::oopen(dir + "/skip.log")->flush();
+  step("create skip.log");
+
+  SystemUtilities::ensureDirectory(dir + "/sub/deep");
+  step("mkdir sub/deep");
+
+  SystemUtilities::oopen(dir + "/sub/deep/a.txt")->flush();
+  step("create sub/deep/a.txt");
+
+  SystemUtilities::rename(dir + "/new.txt", dir + "/sub/moved.txt");
+  step("rename new.txt sub/moved.txt");
+
+  SystemUtilities::unlink(dir + "/sub/deep/a.txt");
+  step("unlink sub/deep/a.txt");
+
+  SystemUtilities::rmdir(dir + "/sub", true);
+  step("rmdir sub");
+
+  cout << "dirs " << watcher.getNumDirs() << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    unsigned depth = ~0;
+    unsigned threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+      string arg = argv[i];
+
+      if (arg == "--help") {
+        usage(argv[0]);
+        return 0;
+
+      } else if (arg == "--match" && i < argc - 2) {
+        GlobMatcher matcher(argv[++i]);
+        string name = argv[++i];
+        cout << "'" << matcher.getPattern() << "' '" << name << "' "
+             << String(matcher.match(name)) << endl;
+
+      } else if (arg == "--depth" && i < argc - 1) {
+        depth = String::parseU32(argv[++i]);
+
+      } else if (arg == "--threads" && i < argc - 1) {
+        threads = String::parseU32(argv[++i]);
+
+      } else if ((arg == "--walk" || arg == "--walk-dirs") && i < argc - 2) {
+        string dir = argv[++i];
+        ParallelDirectoryWalker walker(argv[++i], depth, arg == "--walk-dirs",
+                                       threads);
+
+        for (auto &path: walker.walk(dir)) cout << path << endl;
+
+      } else if (arg == "--stat" && i < argc - 2) {
+        string dir = argv[++i];
+        ParallelDirectoryWalker walker(argv[++i], depth, false, threads);
+        walker.setStat(true);
+
+        vector<string> lines;
+        walker.walk(dir, [&] (const ParallelDirectoryWalker::entries_t &e) {
+          for (auto &entry: e)
+            lines.push_back(entry.path + " " + String(entry.size) + " " +
+                            String(entry.hasStat && entry.mtime));
+        });
+
+        sort(lines.begin(), lines.end());
+        for (auto &line: lines) cout << line << endl;
+
+      } else if (arg == "--watch" && i < argc - 2) {
+        string dir = argv[++i];
+        watch(dir, argv[++i]);
+
+      } else {
+        usage(argv[0]);
+        THROWS("Invalid arg '" << arg << "'");
+      }
+    }
+
+    return 0;
+
+  } CATCH_ERROR;
+
+  return 1;
+}
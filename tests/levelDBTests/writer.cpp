@@ -0,0 +1,184 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/db/LevelDBWriter.h>
+#include <cbang/event/Base.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/log/Logger.h>
+
+#include <leveldb/write_batch.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace cb;
+
+
+// Prints each write and can fail one of them
+class Writer : public LevelDBWriter {
+  unsigned count = 0;
+
+public:
+  unsigned fail = 0; // Write to fail, counting from one
+
+  using LevelDBWriter::LevelDBWriter;
+
+  // From LevelDBWriter
+  void write(leveldb::WriteBatch &batch, int options) override {
+    struct Keys : public leveldb::WriteBatch::Handler {
+      string keys;
+      void Put(const leveldb::Slice &key, const leveldb::Slice &) override
+        {keys += " " + key.ToString();}
+      void Delete(const leveldb::Slice &key) override
+        {keys += " -" + key.ToString();}
+    } keys;
+
+    batch.Iterate(&keys);
+    cout << "write" << keys.keys << " sync "
+         << String((bool)(options & LevelDB::SYNC)) << endl;
+
+    if (++count == fail) THROW("Write failed");
+    LevelDBWriter::write(batch, options);
+  }
+};
+
+
+struct Test {
+  Event::Base base;
+  SmartPointer<Event::ConcurrentPool> pool;
+  LevelDB db;
+  unsigned pending = 0;
+
+  Test() : pool(new Event::ConcurrentPool(base, 1)) {
+    SystemUtilities::rmdir("writer.db", true);
+    db.open("writer.db", LevelDB::CREATE_IF_MISSING);
+    pool->start();
+  }
+
+  ~Test() {
+    pool->stop();
+    pool->join();
+    db.close();
+    SystemUtilities::rmdir("writer.db", true);
+  }
+
+  // Each batch sets its own key and overwrites "last"
+  void commit(Writer &writer, unsigned i, int options = 0) {
+    auto batch = db.batch();
+    batch.set("k" + String(i), String(i));
+    batch.set("last", String(i));
+
+    pending++;
+    writer.commit(batch, [this, i] (bool success) {
+      cout << "done " << i << ' ' << String(success) << endl;
+      if (!--pending) base.loopExit();
+    }, options);
+  }
+
+  void wait() {if (pending) base.dispatch();}
+
+  void print(Writer &writer, unsigned n) {
+    cout << "writes " << writer.getWrites() << " batches "
+         << writer.getBatches() << endl;
+    for (unsigned i = 1; i <= n; i++)
+      cout << "k" << i << ' ' << String(db.has("k" + String(i))) << endl;
+    cout << "last " << db.get("last", "none") << endl;
+  }
+};
+
+
+void group() {
+  Test test;
+  auto writer = SmartPtr(new Writer(test.db, test.pool));
+
+  // The first write starts at once, the rest merge while it runs.  A
+  // single SYNC batch makes its whole group sync.
+  test.commit(*writer, 1);
+  test.commit(*writer, 2);
+  test.commit(*writer, 3, LevelDB::SYNC);
+  test.commit(*writer, 4);
+  test.wait();
+
+  // With a latency the first batch waits for others too
+  writer = new Writer(test.db, test.pool, 0.05);
+  test.commit(*writer, 5);
+  test.commit(*writer, 6);
+  test.wait();
+
+  // Full groups are written separately, in commit order
+  writer = new Writer(test.db, test.pool, 0, 2);
+  for (unsigned i = 7; i <= 11; i++) test.commit(*writer, i);
+  test.wait();
+
+  test.print(*writer, 11);
+}
+
+
+void fail() {
+  Test test;
+  auto writer = SmartPtr(new Writer(test.db, test.pool));
+  writer->fail = 2;
+
+  // Every batch of the failed group gets its result
+  for (unsigned i = 1; i <= 4; i++) test.commit(*writer, i);
+  test.wait();
+
+  // Later groups are still written
+  test.commit(*writer, 5);
+  test.wait();
+
+  test.print(*writer, 5);
+}
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    if (argc != 2) THROW("Usage: " << argv[0] << " <group|fail>");
+
+    string cmd = argv[1];
+    if (cmd == "group") group();
+    else if (cmd == "fail") fail();
+    else THROW("Invalid command '" << cmd << "'");
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
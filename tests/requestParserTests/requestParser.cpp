@@ -0,0 +1,95 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/http/RequestParser.h>
+#include <cbang/event/Buffer.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/Catch.h>
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::HTTP;
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    if (argc != 2) {
+      cerr << "Usage: " << argv[0] << " <chunk size>" << endl;
+      return 1;
+    }
+
+    unsigned chunk = String::parseU32(argv[1]);
+
+    ostringstream str;
+    str << cin.rdbuf();
+    string input = str.str();
+
+    // Feed the input in pieces to exercise incremental parsing
+    RequestParser parser;
+    Event::Buffer buf;
+
+    for (unsigned i = 0; i < input.length() && !parser.isDone(); i += chunk) {
+      buf.add(input.data() + i, min(chunk, (unsigned)input.length() - i));
+      parser.parse(buf);
+    }
+
+    if (!parser.isDone()) {
+      cout << "incomplete state=" << parser.getState() << endl;
+      return 0;
+    }
+
+    cout << "method: '" << parser.getMethod() << "'\n"
+         << "uri: '" << parser.getURI() << "'\n"
+         << "version: '" << parser.getVersion() << "'\n";
+
+    for (auto it : *parser.getHeaders())
+      cout << "header: '" << it.key() << "' = '" << it.value() << "'\n";
+
+    unsigned rest = input.length() - parser.getSize();
+    cout << "size: " << parser.getSize() << "\nrest: " << rest << endl;
+
+    return 0;
+
+  } CATCH_ERROR;
+
+  return 1;
+}
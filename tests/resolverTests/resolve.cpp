@@ -34,14 +34,16 @@
 //
 //   {"context": {"args": {...}, "options": {...}, ...},
 //    "template": <string or JSON value>,
-//    "sql": <bool, optional>, "partial": <bool, optional>}
+//    "sql": <bool, optional>, "partial": <bool, optional>,
+//    "compiled": <bool, optional>}
 //
 // Each key under "context" becomes a resolver namespace.  With "sql" the
 // template is resolved as SQL and the bound parameters are printed as
 // PARAM[i] lines.  Otherwise a string template is resolved and printed
 // verbatim and a JSON template is resolved in place and printed as compact
 // JSON (so typed substitution is visible).  "partial" leaves missing refs
-// unresolved.
+// unresolved.  "compiled" resolves through a Template or ValueTemplate
+// twice, as the API does per request, and checks the results match.
 
 #include <cbang/Catch.h>
 #include <cbang/json/Reader.h>
@@ -75,7 +77,24 @@ int main(int argc, char *argv[]) {
     bool partial = input->getBoolean("partial", false);
     auto tmpl    = input->get("template");
 
-    if (sql) {
+    if (input->getBoolean("compiled", false)) {
+      if (sql) {
+        Template t(tmpl->getString());
+        vector<JSON::ValuePtr> params;
+        cout << resolver.resolveSQL(t, params) << endl;
+        for (unsigned i = 0; i < params.size(); i++)
+          cout << "PARAM[" << i << "]: " << params[i]->toString(0, true)
+               << endl;
+
+      } else {
+        ValueTemplate t(tmpl);
+        string first = resolver.resolveValue(t)->toString(0, true);
+        string again = resolver.resolveValue(t)->toString(0, true);
+        if (first != again) THROW("Second resolve differs: " << again);
+        cout << first << endl;
+      }
+
+    } else if (sql) {
       vector<JSON::ValuePtr> params;
       cout << resolver.resolveSQL(tmpl->getString(), params) << endl;
       for (unsigned i = 0; i < params.size(); i++)
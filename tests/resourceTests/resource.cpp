@@ -0,0 +1,197 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/util/ResourceBundle.h>
+#include <cbang/comp/Press.h>
+#include <cbang/event/Buffer.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/log/Logger.h>
+#include <cbang/Catch.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstring>
+
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  const char *css = "body {margin: 0; padding: 0; margin: 0; padding: 0;}\n"
+    "body {margin: 0; padding: 0; margin: 0; padding: 0;}\n";
+
+  const char *js = "x";
+
+  FileResource indexRes("index.html", "<html></html>", 13, "text/html");
+  FileResource appRes("app.css", css, strlen(css));
+  FileResource libRes("lib.js", js, strlen(js));
+  const Resource *jsChildren[] = {&libRes, 0};
+  DirectoryResource jsRes("js", jsChildren);
+  const Resource *cssChildren[] = {&appRes, 0};
+  DirectoryResource cssRes("css", cssChildren);
+  const Resource *rootChildren[] = {&indexRes, &cssRes, &jsRes, 0};
+  DirectoryResource root("", rootChildren);
+
+  const char *paths[] = {
+    "index.html", "/index.html", "//css/app.css", "js/lib.js", "js", "css/",
+    "missing", "js/missing", "", 0
+  };
+
+
+  void find(const Resource &root) {
+    for (unsigned i = 0; paths[i]; i++) {
+      const Resource *res = root.find(paths[i]);
+
+      cout << "'" << paths[i] << "' -> ";
+      if (!res) cout << "not found";
+      else if (res->isDirectory()) cout << "directory " << res->getName();
+      else cout << res->getName() << " " << res->getLength() << " bytes";
+      cout << '\n';
+    }
+  }
+
+
+  void dump(const Resource &res, const string &path = "") {
+    if (res.isDirectory()) {
+      for (unsigned i = 0; res.getChild(i); i++)
+        dump(*res.getChild(i), path + "/" + res.getChild(i)->getName());
+      return;
+    }
+
+    const char *type = res.getContentType();
+    string data = res.toString();
+
+    cout << path << " " << res.getLength() << " bytes type="
+         << (type ? type : "none") << " etag=" << res.getETag();
+
+    if (res.getGZipData()) {
+      string gz(res.getGZipData(), res.getGZipLength());
+      string raw = Press(Compression::COMPRESSION_GZIP).decompress(gz);
+      cout << " gzip=" << (raw == data ? "ok" : "mismatch");
+    }
+
+    cout << '\n';
+  }
+
+
+  void invalid(const string &data) {
+    try {
+      ResourceBundle bundle(data.data(), data.length());
+      cout << "loaded\n";
+    } catch (const Exception &e) {
+      cout << e.getMessage() << '\n';
+    }
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    string cmd = argc == 2 ? argv[1] : "";
+
+    if (cmd == "find") find(root);
+
+    else if (cmd == "bundle") {
+      ostringstream str;
+      ResourceBundle::write(str, root);
+      string data = str.str();
+
+      ResourceBundle bundle(data.data(), data.length());
+      cout << bundle.getFileCount() << " files\n";
+      dump(bundle);
+      find(bundle);
+
+      // Load the same bundle memory mapped
+      string path = string(argv[0]) + ".bundle";
+      SystemUtilities::oopen(path)->write(data.data(), data.length());
+
+      ResourceBundle mapped(path);
+      dump(mapped);
+      SystemUtilities::unlink(path);
+
+    } else if (cmd == "invalid") {
+      ostringstream str;
+      ResourceBundle::write(str, root);
+      string data = str.str();
+
+      invalid("");
+      invalid("XXXX");
+      invalid(data.substr(0, data.length() - 1));
+      invalid(data + "X");
+
+      string version = data;
+      version[4] = 2;
+      invalid(version);
+
+    } else if (cmd == "ref") {
+      // A buffer referencing bundle data keeps the bundle mapped
+      ostringstream str;
+      ResourceBundle::write(str, root);
+      string data = str.str();
+
+      string path = string(argv[0]) + ".bundle";
+      SystemUtilities::oopen(path)->write(data.data(), data.length());
+
+      Event::Buffer buf;
+      {
+        auto bundle = SmartPtr(new ResourceBundle(path));
+        const Resource *res = bundle->find("css/app.css");
+        buf.addRef(res->getData(), res->getLength(),
+                   [bundle] {cout << "released\n";});
+      }
+
+      SystemUtilities::unlink(path);
+
+      Event::Buffer out;
+      out.add(buf);
+      cout << (out.toString() == css ? "data ok" : "data mismatch") << '\n';
+      out.clear();
+      cout << "cleared\n";
+
+    } else {
+      cerr << "Usage: " << argv[0] << " <find | bundle | invalid | ref>"
+           << endl;
+      return 1;
+    }
+
+    return 0;
+
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,208 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/http/Server.h>
+#include <cbang/http/Request.h>
+#include <cbang/ws/Websocket.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
+#include <cbang/net/Socket.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/Catch.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::HTTP;
+
+
+namespace {
+  // Sends a frame from onOpen(), before the 101 reply has been flushed
+  class TestWebsocket : public WS::Websocket {
+  public:
+    void onOpen() override {send("hello");}
+    void onMessage(const char *data, uint64_t length) override {}
+  };
+
+
+  class TestServer : public Server {
+    SmartPointer<Event::Event> slowEvent;
+    SmartPointer<WS::Websocket> ws;
+
+  public:
+    TestServer(Event::Base &base) : Server(base) {
+      addMember(HTTP_GET,  "/fast", this, &TestServer::fast);
+      addMember(HTTP_GET,  "/slow", this, &TestServer::slow);
+      addMember(HTTP_POST, "/echo", this, &TestServer::echo);
+      addMember(HTTP_GET,  "/ws",   this, &TestServer::upgrade);
+    }
+
+
+    bool fast(Request &req) {
+      req.reply(HTTP_OK, "fast");
+      return true;
+    }
+
+
+    // Replies after the requests pipelined behind it were received
+    bool slow(Request &req) {
+      SmartPointer<Request> r = &req;
+      slowEvent = getBase().newEvent([r] {r->reply(HTTP_OK, "slow");}, 0);
+      slowEvent->add(0.1);
+      return true;
+    }
+
+
+    bool echo(Request &req) {
+      req.reply(HTTP_OK, req.getInput());
+      return true;
+    }
+
+
+    bool upgrade(Request &req) {
+      ws = new TestWebsocket;
+      ws->upgrade(req);
+      return true;
+    }
+  };
+
+
+  string escape(const string &s) {
+    string out;
+
+    for (unsigned i = 0; i < s.length(); i++) {
+      unsigned char c = s[i];
+
+      if (c == '\r' && i + 1 < s.length() && s[i + 1] == '\n') continue;
+      if (c == '\n' || (0x20 <= c && c < 0x7f)) out += c;
+      else out += String::printf("\\x%02x", c);
+    }
+
+    return out;
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    if (argc != 2) {
+      cerr << "Usage: " << argv[0] << " <chunk size>" << endl;
+      return 1;
+    }
+
+    unsigned chunk = String::parseU32(argv[1]);
+
+    // Read requests, lines end in CRLF
+    string input;
+    string line;
+    while (getline(cin, line)) input += line + "\r\n";
+
+    Event::Base base;
+    TestServer server(base);
+
+    // Listen on an ephemeral loopback port
+    Socket listener;
+    listener.open(0, SockAddr::parse("127.0.0.1:0"));
+    listener.listen();
+
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (getsockname(listener.get(), (sockaddr *)&addr, &len))
+      THROW("getsockname() failed");
+
+    // Connect a raw client and hand the accepted socket to the server
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(client, (sockaddr *)&addr, len)) THROW("connect() failed");
+    fcntl(client, F_SETFL, fcntl(client, F_GETFL) | O_NONBLOCK);
+
+    SockAddr peer;
+    server.accept(peer, listener.accept(peer, Socket::NONBLOCKING), 0);
+
+    // Send the input in pieces, one per event loop turn
+    unsigned sent = 0;
+    SmartPointer<Event::Event> writeEvent;
+    writeEvent = base.newEvent([&] {
+      unsigned n = input.length() - sent;
+      if (chunk && chunk < n) n = chunk;
+      sent += ::write(client, input.data() + sent, n);
+      if (sent < input.length()) writeEvent->add(0.001);
+    }, 0);
+    writeEvent->activate();
+
+    // Print everything received until the server closes or goes idle
+    string output;
+    SmartPointer<Event::Event> idleEvent;
+    idleEvent = base.newEvent([&] {base.loopExit();}, 0);
+    idleEvent->add(0.5);
+
+    auto readEvent = base.newEvent(client, [&] {
+      char buf[4096];
+      ssize_t n = ::read(client, buf, sizeof(buf));
+
+      if (0 < n) {
+        output.append(buf, n);
+        idleEvent->add(0.5);
+
+      } else if (!n) base.loopExit();
+    }, Event::Base::EVENT_READ | Event::Base::EVENT_PERSIST);
+    readEvent->add();
+
+    base.dispatch();
+    ::close(client);
+
+    // Responses carry the current time
+    vector<string> lines;
+    String::tokenize(escape(output), lines, "\n", true);
+
+    for (auto &l: lines)
+      if (!String::startsWith(l, "Date:")) cout << l << '\n';
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
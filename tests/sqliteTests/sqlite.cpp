@@ -0,0 +1,195 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+#include <cbang/db/Database.h>
+#include <cbang/db/Statement.h>
+#include <cbang/log/Logger.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::DB;
+
+
+void stats(Database &db) {
+  cout << "hits " << db.getStmtCacheHits() << " misses "
+       << db.getStmtCacheMisses() << endl;
+}
+
+
+void rows(Statement &stmt) {
+  cout << "rows";
+  while (stmt.next())
+    cout << ' ' << (stmt.column(0).getType() == Types::DB_NULL ? "NULL" :
+                    stmt.column(0).toString());
+  cout << endl;
+}
+
+
+int64_t count(Database &db) {
+  int64_t n = 0;
+  db.execute("SELECT COUNT(*) FROM t", n);
+  return n;
+}
+
+
+void cache(Database &db) {
+  auto s1 = db.compileCached("SELECT ?");
+  s1->parameter(0).bind((int64_t)5);
+  rows(*s1);
+  stats(db);
+
+  // A hit returns the same statement, reset with its bindings cleared
+  auto s2 = db.compileCached("SELECT ?");
+  cout << "same " << String(s1 == s2) << endl;
+  rows(*s2);
+  stats(db);
+
+  // Disabled, statements are not shared
+  db.setStmtCacheSize(0);
+  db.resetStmtCacheStats();
+  auto s3 = db.compileCached("SELECT ?");
+  cout << "same " << String(s2 == s3) << endl;
+  stats(db);
+}
+
+
+void evict(Database &db) {
+  db.setStmtCacheSize(2);
+
+  auto a = db.compileCached("SELECT 'a'");
+  auto b = db.compileCached("SELECT 'b'");
+  cout << "a again " << String(a == db.compileCached("SELECT 'a'")) << endl;
+  stats(db);
+
+  // 'b' is least recently used
+  db.compileCached("SELECT 'c'");
+  cout << "b again " << String(b == db.compileCached("SELECT 'b'")) << endl;
+  stats(db);
+
+  // Adding 'b' back evicted 'a'
+  cout << "a again " << String(a == db.compileCached("SELECT 'a'")) << endl;
+  stats(db);
+
+  // An evicted statement still held by the caller remains usable
+  b->reset();
+  rows(*b);
+}
+
+
+void abandon(Database &db) {
+  db.execute("CREATE TABLE t (x INTEGER)");
+  db.execute("INSERT INTO t VALUES (1), (2), (3)");
+
+  // Stop after the first row, the next user starts over
+  auto stmt = db.compileCached("SELECT x FROM t ORDER BY x");
+  stmt->next();
+  cout << "first " << stmt->column(0).toInteger() << endl;
+
+  rows(*db.compileCached("SELECT x FROM t ORDER BY x"));
+
+  // The execute() helpers share the cache
+  stmt = db.compileCached("SELECT x FROM t ORDER BY x DESC");
+  stmt->next();
+  int64_t x = 0;
+  db.execute("SELECT x FROM t ORDER BY x DESC", x);
+  cout << "max " << x << endl;
+  db.execute("SELECT x FROM t ORDER BY x DESC", x);
+  cout << "max " << x << endl;
+  stats(db);
+}
+
+
+void bulk(Database &db) {
+  db.execute("CREATE TABLE t (x INTEGER PRIMARY KEY)");
+
+  // Binds 1 to 5, repeating 1 at row @param dup
+  auto bind = [] (int dup) {
+    return [dup] (Statement &stmt, unsigned row) {
+      if (row == 5) return false;
+      stmt.parameter(0).bind((int64_t)((int)row == dup ? 1 : row + 1));
+      return true;
+    };
+  };
+
+  const char *sql = "INSERT INTO t VALUES (?)";
+  cout << "inserted " << db.bulk(sql, bind(-1)) << endl;
+  cout << "count " << count(db) << endl;
+
+  // A failing row rolls back every row
+  db.execute("DELETE FROM t");
+  try {
+    db.bulk(sql, bind(3));
+  } catch (const Exception &e) {cout << "failed" << endl;}
+  cout << "count " << count(db) << " transaction "
+       << String(db.inTransaction()) << endl;
+
+  // Joins the caller's transaction, which decides the outcome
+  auto tx = db.begin();
+  cout << "inserted " << db.bulk(sql, bind(-1)) << endl;
+  db.rollback();
+  cout << "count " << count(db) << endl;
+
+  // The cached statement is reusable after the failure
+  cout << "inserted " << db.bulk(sql, bind(-1)) << endl;
+  cout << "count " << count(db) << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    if (argc != 2)
+      THROW("Usage: " << argv[0] << " <cache|evict|abandon|bulk>");
+
+    Database db;
+    db.open(":memory:");
+
+    string cmd = argv[1];
+    if (cmd == "cache") cache(db);
+    else if (cmd == "evict") evict(db);
+    else if (cmd == "abandon") abandon(db);
+    else if (cmd == "bulk") bulk(db);
+    else THROW("Invalid command '" << cmd << "'");
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,97 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/Catch.h>
+
+#include <iostream>
+#include <cstdlib>
+
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  template <typename T>
+  void parse(const string &name, const string &s, bool full) {
+    T value = 0;
+    cout << ' ' << name << '=';
+    if (String::parse<T>(s, value, full)) cout << String(value);
+    else cout << '!';
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    string cmd = argc == 2 ? argv[1] : "";
+    string line;
+
+    if (cmd == "parse")
+      while (getline(cin, line)) {
+        for (int full = 0; full < 2; full++) {
+          cout << "'" << line << "'" << (full ? " full:" : ":");
+#define CBANG_STRING_PT(NAME, TYPE, DESC) parse<TYPE>(#NAME, line, full);
+#include <cbang/StringParseTypes.def>
+          cout << '\n';
+        }
+      }
+
+    else if (cmd == "format")
+      while (getline(cin, line)) {
+        double x = strtod(line.c_str(), 0);
+        char buf[String::TO_CHARS_SIZE];
+        string chars(buf, String::toChars(buf, x));
+
+        cout << line << ": " << String(x) << ' ' << chars << ' '
+             << String(x, 2) << ' ' << String(x, 0) << ' ' << String(x, -1)
+             << ' ' << String((float)x) << '\n';
+      }
+
+    else {
+      cerr << "Usage: " << argv[0] << " <parse | format>" << endl;
+      return 1;
+    }
+
+    return 0;
+
+  } CATCH_ERROR;
+
+  return 1;
+}
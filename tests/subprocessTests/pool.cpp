@@ -0,0 +1,187 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/SubprocessPool.h>
+#include <cbang/log/Logger.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+struct Proc : public AsyncSubprocess {
+  string name;
+  static unsigned running;
+  static unsigned peak;
+  static unsigned finished;
+
+  Proc(const string &name, const string &cmd, int priority = 0,
+       unsigned flags = 0) :
+    AsyncSubprocess({"sh", "-c", cmd}, flags | SHELL, priority), name(name) {}
+
+  // From AsyncSubprocess
+  void exec() override {
+    cout << "launch " << name << endl;
+    AsyncSubprocess::exec();
+    peak = max(peak, ++running);
+  }
+
+  void done() override {running--; finished++;}
+};
+
+unsigned Proc::running  = 0;
+unsigned Proc::peak     = 0;
+unsigned Proc::finished = 0;
+
+
+void run(Base &base, unsigned count) {
+  while (Proc::finished < count) base.loopOnce();
+}
+
+
+void fair(Base &base) {
+  SubprocessPool pool(base);
+  pool.setMaxActive(1);
+  pool.setGroupWeight("a", 2);
+
+  const char *a[] = {"a3", "a2", "a1", "a0"};
+  const char *b[] = {"b1", "b0"};
+
+  for (int i = 0; i < 4; i++) {
+    auto proc = SmartPtr(new Proc(a[i], "true", 3 - i));
+    proc->setGroup("a");
+    pool.enqueue(proc);
+  }
+
+  for (int i = 0; i < 2; i++) {
+    auto proc = SmartPtr(new Proc(b[i], "true", 1 - i));
+    proc->setGroup("b");
+    pool.enqueue(proc);
+  }
+
+  run(base, 6);
+  cout << "peak " << Proc::peak << endl;
+}
+
+
+void output(Base &base) {
+  SubprocessPool pool(base);
+
+  unsigned flags = Subprocess::REDIR_STDOUT | Subprocess::REDIR_STDERR;
+  auto proc = SmartPtr(new Proc(
+    "output", "echo hello; printf '%0100d' 0 >&2", 0, flags));
+  proc->setOutputLimit(16);
+  pool.enqueue(proc);
+
+  auto quiet = SmartPtr(new Proc("quiet", "echo ignored", 0, flags));
+  pool.enqueue(quiet);
+
+  run(base, 2);
+
+  cout << "stdout: " << proc->getOutput().toString()
+       << "dropped: " << proc->getOutputDropped() << '\n'
+       << "stderr: " << proc->getError().toString() << '\n'
+       << "length: " << proc->getError().getLength() << '\n'
+       << "dropped: " << proc->getErrorDropped() << '\n'
+       << "quiet: " << quiet->getOutput().getLength() << endl;
+}
+
+
+void dynamic(Base &base) {
+  struct {unsigned maxActive; double cpus; double load; unsigned active;}
+  cases[] = {
+    {8, 4, 0, 0}, // Idle, limited by the quota
+    {2, 4, 0, 0}, // Limited by maxActive
+    {8, 4, 3, 3}, // The load is all ours
+    {8, 4, 2.5, 0}, // Others load 2.5 CPUs
+    {8, 4, 6, 1}, // Overloaded, still run one
+    {8, 1.5, 0, 0}, // Fractional quota rounds up
+  };
+
+  for (auto &c: cases)
+    cout << "limit " << c.maxActive << ' ' << c.cpus << ' ' << c.load << ' '
+         << c.active << " = " << SubprocessPool::computeLimit(
+           c.maxActive, c.cpus, c.load, c.active) << endl;
+
+  // Raising the limit while processes run launches more
+  SubprocessPool pool(base);
+  pool.setMaxActive(2);
+
+  for (int i = 0; i < 6; i++) {
+    auto proc = SmartPtr(new Proc(String(i), "sleep 0.2"));
+    proc->setPriority(i);
+    pool.enqueue(proc);
+  }
+
+  run(base, 1);
+  pool.setMaxActive(4);
+  run(base, 6);
+  cout << "peak " << Proc::peak << endl;
+
+  // A dynamic pool runs at least one process whatever the load
+  Proc::finished = 0;
+  pool.setDynamic(true);
+  for (int i = 0; i < 3; i++)
+    pool.enqueue(SmartPtr(new Proc(String(i), "true")));
+  run(base, 3);
+  cout << "dynamic done " << Proc::finished << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    if (argc != 2) THROW("Usage: " << argv[0] << " <fair|output|dynamic>");
+
+    Base base;
+    string cmd = argv[1];
+
+    if (cmd == "fair") fair(base);
+    else if (cmd == "output") output(base);
+    else if (cmd == "dynamic") dynamic(base);
+    else THROW("Invalid command '" << cmd << "'");
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,179 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/os/Subprocess.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/log/Logger.h>
+
+#include <iostream>
+#include <vector>
+#include <map>
+
+using namespace std;
+using namespace cb;
+
+
+void usage(const char *name) {
+  cout
+    << "Usage: " << name << " [OPTIONS]\n\n"
+    << "OPTIONS:\n"
+    << "\t--mode <spawn|fork|vfork>   Launch method for following runs.\n"
+    << "\t--flags <flag,...>          Extra flags for following runs:\n"
+    << "\t                            merge, null-stdout, null-stderr,\n"
+    << "\t                            clear-env, close-fds, group.\n"
+    << "\t--env <name=value>          Set a variable for following runs.\n"
+    << "\t--wd <dir>                  Working dir for following runs.\n"
+    << "\t--leak                      Open a descriptor the child inherits\n"
+    << "\t                            unless it is closed.\n"
+    << "\t--run <cmd>                 Run cmd, printing its exit code and\n"
+    << "\t                            captured stdout and stderr.\n"
+    << endl;
+}
+
+
+unsigned parseFlags(const string &s) {
+  static const map<string, unsigned> names = {
+    {"merge",       Subprocess::MERGE_STDOUT_AND_STDERR},
+    {"null-stdout", Subprocess::NULL_STDOUT},
+    {"null-stderr", Subprocess::NULL_STDERR},
+    {"clear-env",   Subprocess::CLEAR_ENVIRONMENT},
+    {"close-fds",   Subprocess::CLOSE_FDS},
+    {"group",       Subprocess::CREATE_PROCESS_GROUP},
+  };
+
+  vector<string> tokens;
+  String::tokenize(s, tokens, ",");
+
+  unsigned flags = 0;
+  for (auto &token: tokens) {
+    auto it = names.find(token);
+    if (it == names.end()) THROW("Invalid flag '" << token << "'");
+    flags |= it->second;
+  }
+
+  return flags;
+}
+
+
+void run(const string &cmd, unsigned flags, const string &wd,
+         const map<string, string> &env) {
+  cout << "run: " << cmd << endl;
+
+  Subprocess proc;
+  for (auto &p: env) proc.set(p.first, p.second);
+  if (!wd.empty()) proc.setWorkingDirectory(wd);
+
+  flags |= Subprocess::SHELL;
+  if (!(flags & Subprocess::NULL_STDOUT)) flags |= Subprocess::REDIR_STDOUT;
+  unsigned noErr = Subprocess::NULL_STDERR | Subprocess::MERGE_STDOUT_AND_STDERR;
+  if (!(flags & noErr)) flags |= Subprocess::REDIR_STDERR;
+
+  try {
+    proc.exec(cmd, flags);
+  } catch (const Exception &e) {
+    cout << "error: " << e.getMessage() << endl;
+    cout << "ok: " << String(proc.exitedOk()) << endl;
+    return;
+  }
+
+  string out, err;
+  if (flags & Subprocess::REDIR_STDOUT)
+    out = SystemUtilities::read(*proc.getPipeOut().toStream());
+  if (flags & Subprocess::REDIR_STDERR)
+    err = SystemUtilities::read(*proc.getPipeErr().toStream());
+
+  cout << "exit: " << proc.wait() << endl;
+  cout << "stdout:\n" << out;
+  cout << "stderr:\n" << err;
+}
+
+
+int main(int argc, char *argv[]) {
+  Logger::instance().setScreenStream(cerr);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    unsigned mode = 0;
+    unsigned flags = 0;
+    string wd;
+    map<string, string> env;
+    vector<Pipe> leaks;
+
+    for (int i = 1; i < argc; i++) {
+      string arg = argv[i];
+
+      if (arg == "--help") {
+        usage(argv[0]);
+        return 0;
+
+      } else if (arg == "--mode" && i < argc - 1) {
+        string name = argv[++i];
+        if (name == "spawn") mode = 0;
+        else if (name == "fork") mode = Subprocess::USE_FORK;
+        else if (name == "vfork") mode = Subprocess::USE_VFORK;
+        else THROW("Invalid mode '" << name << "'");
+
+      } else if (arg == "--flags" && i < argc - 1)
+        flags = parseFlags(argv[++i]);
+
+      else if (arg == "--env" && i < argc - 1) {
+        string var = argv[++i];
+        size_t equal = var.find('=');
+        if (equal == string::npos) THROW("Expected name=value: " << var);
+        env[var.substr(0, equal)] = var.substr(equal + 1);
+
+      } else if (arg == "--wd" && i < argc - 1) wd = argv[++i];
+
+      else if (arg == "--leak") {
+        leaks.push_back(Pipe(false));
+        leaks.back().create();
+
+      } else if (arg == "--run" && i < argc - 1)
+        run(argv[++i], mode | flags, wd, env);
+
+      else {
+        usage(argv[0]);
+        THROWS("Invalid arg '" << arg << "'");
+      }
+    }
+
+    return 0;
+
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,119 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2021-2026, Cauldron Development  Oy
+                Copyright (c) 2003-2021, Cauldron Development LLC
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/event/Base.h>
+#include <cbang/log/Logger.h>
+#include <cbang/log/TailFileToLog.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/time/Timer.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace cb;
+
+
+void write(const string &path, const string &data,
+           ios::openmode mode = ios::app) {
+  ofstream(path, ios::out | mode) << data << flush;
+}
+
+
+int main(int argc, char *argv[]) {
+  ostringstream log;
+  Logger::instance().setScreenStream(log);
+  Logger::instance().setLogTime(false);
+  Logger::instance().setLogColor(false);
+  Logger::instance().setLogHeader(false);
+  Exception::printLocations    = false;
+  Exception::enableStackTraces = false;
+
+  try {
+    const string filename = "tail.log";
+    Event::Base base(false);
+    TailFileToLog tail(base, filename, "tail: ");
+
+    auto step = [&] (const string &msg) {
+      // Polling falls back to a 0.25s timer
+      for (unsigned i = 0; i < 8; i++) {
+        base.loopNonBlock();
+        Timer::sleep(0.05);
+      }
+
+      cout << msg << ":" << endl;
+
+      string line;
+      istringstream in(log.str());
+      while (getline(in, line))
+        if (line.size() < 80) cout << "  " << line << endl;
+        else cout << "  <" << line.size() << " chars>" << endl;
+
+      log.str("");
+    };
+
+    step("missing");
+
+    write(filename, "one\ntwo\n", ios::trunc);
+    step("create");
+
+    write(filename, "partial");
+    step("partial");
+
+    write(filename, " line\n");
+    step("complete");
+
+    // Lines longer than 4096 bytes are split
+    write(filename, string(10000, 'x') + "\n");
+    step("long");
+
+    write(filename, "truncated\n", ios::trunc);
+    step("truncate");
+
+    // Rotate, the old file is drained before switching to the new one
+    SystemUtilities::rename(filename, filename + ".1");
+    write(filename + ".1", "old\n");
+    write(filename, "new\n", ios::trunc);
+    step("rotate");
+
+    cout << "bytes " << tail.getBytesCopied() << endl;
+
+    return 0;
+
+  } CATCH_ERROR;
+
+  cout << log.str();
+  return 1;
+}